@@ -0,0 +1,99 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_ABSTRACT_TRAJECTORY_FILTER_HH
+# define LIBMOCAP_ABSTRACT_TRAJECTORY_FILTER_HH
+# include <cstddef>
+# include <vector>
+
+# include <libmocap/config.hh>
+# include <libmocap/position-matrix.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  class MarkerTrajectory;
+  class MarkerTrajectoryColumns;
+
+  /// \brief Base class of the filters applied in place to marker
+  /// trajectories.
+  ///
+  /// Each coordinate of each marker is filtered independently, the
+  /// time column is left untouched. Missing samples (NaN) split a
+  /// coordinate into segments which are filtered separately, so that
+  /// gaps are neither filled nor widened.
+  ///
+  /// Markers are processed in parallel.
+  class LIBMOCAP_DLLEXPORT AbstractTrajectoryFilter
+  {
+  public:
+    AbstractTrajectoryFilter ();
+    virtual ~AbstractTrajectoryFilter ();
+
+    /// \brief Number of threads, zero meaning one per available
+    /// core (default).
+    LIBMOCAP_ACCESSOR (numThreads, int);
+
+    /// \brief Filter a trajectory sampled at its data rate.
+    void filter (MarkerTrajectory& trajectory) const;
+
+    /// \brief Filter marker-major positions.
+    ///
+    /// \param columns positions to be filtered
+    /// \param dataRate sampling frequency, in Hz
+    void filter (MarkerTrajectoryColumns& columns, double dataRate) const;
+
+    /// \brief Filter a set of coordinates.
+    ///
+    /// \param channels coordinates to be filtered
+    /// \param dataRate sampling frequency, in Hz
+    void filter (const std::vector<PositionMatrix::View>& channels,
+		 double dataRate) const;
+
+  protected:
+    /// \brief Compute the filter coefficients for a data rate.
+    ///
+    /// Throws if the filter cannot be applied at this rate.
+    virtual void
+    coefficients (std::vector<double>& coefficients,
+		  double dataRate) const = 0;
+
+    /// \brief Filter in place a segment of valid samples.
+    virtual void
+    filterSegment (double* samples, std::size_t size,
+		   const std::vector<double>& coefficients) const = 0;
+
+  private:
+    int numThreads_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_ABSTRACT_TRAJECTORY_FILTER_HH
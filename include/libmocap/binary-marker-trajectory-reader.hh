@@ -0,0 +1,103 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_BINARY_MARKER_TRAJECTORY_READER_HH
+# define LIBMOCAP_BINARY_MARKER_TRAJECTORY_READER_HH
+# include <cstddef>
+# include <string>
+
+# include <libmocap/config.hh>
+# include <libmocap/marker-trajectory.hh>
+
+namespace libmocap
+{
+  class MappedFile;
+
+  /// \brief Random access to the frames of a binary trajectory file
+  /// (*.btrc).
+  ///
+  /// The file is memory mapped when the reader is built and only
+  /// its header is parsed. Any frame can then be accessed in
+  /// constant time.
+  ///
+  /// \see BinaryMarkerTrajectoryWriter for the file format.
+  class LIBMOCAP_DLLEXPORT BinaryMarkerTrajectoryReader
+  {
+  public:
+    explicit BinaryMarkerTrajectoryReader (const std::string& filename);
+    ~BinaryMarkerTrajectoryReader ();
+
+    /// \brief Trajectory metadata (positions are left empty).
+    const MarkerTrajectory& metadata () const
+    {
+      return metadata_;
+    }
+
+    std::size_t numFrames () const;
+
+    /// \brief Number of values per frame, i.e. 1 + 3 * numMarkers.
+    std::size_t numColumns () const;
+
+    /// \brief Copy one frame into row, which must hold numColumns ()
+    /// values.
+    void readFrame (std::size_t frameId, double* row) const;
+
+    /// \brief Pointer to a frame inside the mapped file.
+    ///
+    /// This is only possible if the file has been written in double
+    /// precision and the machine is little-endian, zero is returned
+    /// otherwise.
+    const double* frameData (std::size_t frameId) const;
+
+    /// \brief Load the whole trajectory.
+    MarkerTrajectory load () const;
+
+    /// \brief Load numFrames frames starting at firstFrame.
+    ///
+    /// The firstFrame of the result is shifted accordingly, so that
+    /// frames keep the numbering of the source file.
+    MarkerTrajectory load (std::size_t firstFrame,
+			   std::size_t numFrames) const;
+
+    static bool canLoad (const std::string& filename);
+
+  private:
+    BinaryMarkerTrajectoryReader (const BinaryMarkerTrajectoryReader&);
+    BinaryMarkerTrajectoryReader&
+    operator= (const BinaryMarkerTrajectoryReader&);
+
+    MappedFile* file_;
+    MarkerTrajectory metadata_;
+    std::size_t scalarSize_;
+    std::size_t payloadOffset_;
+  };
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_BINARY_MARKER_TRAJECTORY_READER_HH
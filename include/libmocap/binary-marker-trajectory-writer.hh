@@ -0,0 +1,69 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_BINARY_MARKER_TRAJECTORY_WRITER_HH
+# define LIBMOCAP_BINARY_MARKER_TRAJECTORY_WRITER_HH
+# include <string>
+
+# include <libmocap/config.hh>
+# include <libmocap/marker-trajectory.hh>
+
+namespace libmocap
+{
+  /// \brief Write trajectories using the libmocap binary format
+  /// (*.btrc).
+  ///
+  /// Binary files store the same metadata as the TRC files they are
+  /// converted from, but their positions can be used without any
+  /// parsing. They are loaded by MarkerTrajectoryFactory and can be
+  /// accessed frame by frame through BinaryMarkerTrajectoryReader.
+  class LIBMOCAP_DLLEXPORT BinaryMarkerTrajectoryWriter
+  {
+  public:
+    enum Precision
+      {
+	/// \brief Store positions as doubles (lossless).
+	DOUBLE_PRECISION,
+	/// \brief Store positions as floats (half the size).
+	SINGLE_PRECISION
+      };
+
+    BinaryMarkerTrajectoryWriter ();
+    ~BinaryMarkerTrajectoryWriter ();
+    BinaryMarkerTrajectoryWriter&
+    operator= (const BinaryMarkerTrajectoryWriter& rhs);
+
+    void write (const std::string& filename,
+		const MarkerTrajectory& trajectory,
+		Precision precision = DOUBLE_PRECISION);
+  };
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_BINARY_MARKER_TRAJECTORY_WRITER_HH
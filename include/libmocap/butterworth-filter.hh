@@ -0,0 +1,79 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_BUTTERWORTH_FILTER_HH
+# define LIBMOCAP_BUTTERWORTH_FILTER_HH
+# include <libmocap/config.hh>
+# include <libmocap/abstract-trajectory-filter.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  /// \brief Zero-phase low-pass Butterworth filter.
+  ///
+  /// The digital filter is designed by bilinear transform (with
+  /// frequency prewarping) as a cascade of second order sections,
+  /// then applied forward and backward so that it introduces no
+  /// phase lag. The resulting attenuation is therefore twice the one
+  /// of the designed filter, i.e. -6 dB at the cutoff frequency.
+  ///
+  /// Segments are extended at both ends by odd reflection and the
+  /// filter state is initialized to its steady state to limit edge
+  /// transients.
+  class LIBMOCAP_DLLEXPORT ButterworthFilter : public AbstractTrajectoryFilter
+  {
+  public:
+    ButterworthFilter ();
+    explicit ButterworthFilter (double cutoffFrequency, int order = 2);
+    ~ButterworthFilter ();
+
+    /// \brief Cutoff frequency, in Hz (6 Hz by default).
+    ///
+    /// It must be lower than half the trajectory data rate.
+    LIBMOCAP_ACCESSOR (cutoffFrequency, double);
+
+    /// \brief Order of the designed filter (2 by default).
+    LIBMOCAP_ACCESSOR (order, int);
+
+  protected:
+    void coefficients (std::vector<double>& coefficients,
+		       double dataRate) const;
+
+    void filterSegment (double* samples, std::size_t size,
+			const std::vector<double>& coefficients) const;
+
+  private:
+    double cutoffFrequency_;
+    int order_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_BUTTERWORTH_FILTER_HH
@@ -0,0 +1,138 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_GAP_FILLER_HH
+# define LIBMOCAP_GAP_FILLER_HH
+# include <cstddef>
+# include <iosfwd>
+# include <vector>
+
+# include <libmocap/config.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  class MarkerTrajectory;
+  class MarkerTrajectoryColumns;
+
+  /// \brief Detect and fill gaps (missing samples) in trajectories.
+  ///
+  /// A marker sample is missing when one of its coordinates is NaN,
+  /// which is how the TRC loader stores markers that were not
+  /// tracked. A gap is a run of consecutive missing samples of one
+  /// marker.
+  ///
+  /// Gaps with a valid sample on both sides whose length does not
+  /// exceed maxGapLength () are interpolated, other gaps (at the
+  /// beginning or the end of the trajectory, or too long) are left
+  /// untouched. Frames are assumed to be evenly spaced.
+  ///
+  /// Processing works on the marker-major layout of
+  /// MarkerTrajectoryColumns: each marker is handled in a single
+  /// linear pass over its coordinates.
+  class LIBMOCAP_DLLEXPORT GapFiller
+  {
+  public:
+    enum Interpolation
+      {
+	/// \brief Straight line between the samples bounding the gap.
+	LINEAR,
+	/// \brief Cubic Hermite spline between the samples bounding
+	/// the gap, whose tangents are estimated from the neighboring
+	/// samples.
+	CUBIC
+      };
+
+    /// \brief Run of missing samples of one marker.
+    struct Gap
+    {
+      std::size_t marker;
+      /// \brief First missing frame.
+      std::size_t firstFrame;
+      /// \brief Number of missing frames.
+      std::size_t length;
+      /// \brief Whether the gap is interpolated by fill.
+      bool filled;
+    };
+
+    struct Statistics
+    {
+      Statistics ();
+
+      std::size_t numGaps;
+      std::size_t numFilledGaps;
+      std::size_t numMissingSamples;
+      std::size_t numFilledSamples;
+      std::size_t longestGap;
+    };
+
+    GapFiller ();
+
+    LIBMOCAP_ACCESSOR (interpolation, Interpolation);
+
+    /// \brief Length (in frames) of the longest gap to be filled.
+    ///
+    /// Zero means that gaps are filled whatever their length.
+    LIBMOCAP_ACCESSOR (maxGapLength, std::size_t);
+
+    /// \brief List the gaps of all markers, without modifying the
+    /// trajectory.
+    Statistics findGaps (std::vector<Gap>& gaps,
+			 const MarkerTrajectoryColumns& columns) const;
+
+    Statistics findGaps (std::vector<Gap>& gaps,
+			 const MarkerTrajectory& trajectory) const;
+
+    /// \brief Fill the gaps of all markers.
+    ///
+    /// \param columns positions to be processed in place
+    /// \param gaps if not null, receives the gaps found in the
+    /// trajectory (including the ones which have not been filled).
+    Statistics fill (MarkerTrajectoryColumns& columns,
+		     std::vector<Gap>* gaps = 0) const;
+
+    /// \brief Fill the gaps of all markers of a trajectory.
+    ///
+    /// The positions are transposed to MarkerTrajectoryColumns,
+    /// processed and written back.
+    Statistics fill (MarkerTrajectory& trajectory,
+		     std::vector<Gap>* gaps = 0) const;
+
+  private:
+    Interpolation interpolation_;
+    std::size_t maxGapLength_;
+  };
+
+  LIBMOCAP_DLLEXPORT std::ostream&
+  operator<< (std::ostream& o, const GapFiller::Statistics& statistics);
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_GAP_FILLER_HH
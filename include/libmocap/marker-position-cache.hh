@@ -0,0 +1,110 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_MARKER_POSITION_CACHE_HH
+# define LIBMOCAP_MARKER_POSITION_CACHE_HH
+# include <cstddef>
+# include <vector>
+
+# include <libmocap/config.hh>
+# include <libmocap/marker-set-program.hh>
+# include <libmocap/segment-frames.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  class MarkerSet;
+  class MarkerTrajectory;
+
+  /// \brief Frame-scoped cache of the markers positions.
+  ///
+  /// Several consumers (e.g. the views of a viewer) often need the
+  /// positions of the same markers for the same frame. The cache
+  /// evaluates all markers of a frame at most once, the first time
+  /// one of them is requested, and serves all the following requests
+  /// for this frame from memory. Segments frames are cached the same
+  /// way.
+  ///
+  /// The marker set is compiled, bound to the trajectory columns by
+  /// name and validated when the cache is built. The trajectory must outlive
+  /// the cache and must not be modified while it is used, or
+  /// invalidate () must be called.
+  class LIBMOCAP_DLLEXPORT MarkerPositionCache
+  {
+  public:
+    MarkerPositionCache (const MarkerSet& markerSet,
+			 const MarkerTrajectory& trajectory);
+
+    std::size_t numMarkers () const
+    {
+      return program_.numMarkers ();
+    }
+
+    std::size_t numSegments () const
+    {
+      return segmentFrames_.numSegments ();
+    }
+
+    /// \brief Positions of all markers at a frame (3 values per
+    /// marker, in the marker set order).
+    const double* positions (int frameId);
+
+    /// \brief Position of one marker at a frame.
+    const double* position (std::size_t marker, int frameId)
+    {
+      return positions (frameId) + 3 * marker;
+    }
+
+    /// \brief Frames of all segments at a frame.
+    ///
+    /// \see SegmentFrames::compute
+    const double* segmentFrames (int frameId);
+
+    /// \brief Validity flags of the segments frames at a frame.
+    const unsigned char* segmentsValid (int frameId);
+
+    /// \brief Drop cached values.
+    void invalidate ();
+
+  private:
+    const MarkerTrajectory& trajectory_;
+    MarkerSetProgram program_;
+    SegmentFrames segmentFrames_;
+
+    int positionsFrame_;
+    std::vector<double> positions_;
+    int segmentsFrame_;
+    std::vector<double> segments_;
+    std::vector<unsigned char> segmentsValid_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_MARKER_POSITION_CACHE_HH
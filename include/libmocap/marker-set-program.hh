@@ -0,0 +1,198 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_MARKER_SET_PROGRAM_HH
+# define LIBMOCAP_MARKER_SET_PROGRAM_HH
+# include <cstddef>
+# include <iosfwd>
+# include <string>
+# include <vector>
+
+# include <libmocap/config.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  class MarkerSet;
+  class MarkerTrajectory;
+
+  /// \brief Compiled form of a marker set.
+  ///
+  /// Evaluating a virtual marker through AbstractMarker::position
+  /// recursively evaluates the markers it depends on, checking
+  /// bounds and dispatching through virtual calls at each level.
+  /// Markers shared by several virtual markers are then computed
+  /// many times per frame.
+  ///
+  /// A program is built once from a marker set: markers are sorted
+  /// so that each one comes after the markers it depends on, indices
+  /// are resolved and validated, and the result is a flat list of
+  /// instructions evaluating every marker of the set exactly once.
+  ///
+  /// Results are bitwise identical to AbstractMarker::position.
+  ///
+  /// All checks done by AbstractMarker::position on each call are
+  /// done once: marker indices and dependencies when the program is
+  /// built, trajectory columns by validate (). Afterwards, the
+  /// unchecked evaluation can be used safely on any frame of the
+  /// trajectory.
+  ///
+  /// Physical markers are first bound to the trajectory columns
+  /// given by their marker set ids. A trajectory storing its markers
+  /// in another order, such as a marker subset load, requires the
+  /// program to be bound to it by name with bind ().
+  ///
+  /// The program does not reference the marker set it has been built
+  /// from and remains valid if the marker set is destroyed.
+  class LIBMOCAP_DLLEXPORT MarkerSetProgram
+  {
+  public:
+    enum OpCode
+      {
+	/// Copy a marker position from the trajectory.
+	LOAD,
+	ONE_POINT_MEASURED,
+	TWO_POINTS_RATIO,
+	TWO_POINTS_MEASURED,
+	THREE_POINTS_RATIO,
+	THREE_POINTS_MEASURED,
+	/// Null marker, its position is set to NaN.
+	UNDEFINED
+      };
+
+    struct Instruction
+    {
+      OpCode opCode;
+      /// Index of the evaluated marker in the marker set.
+      std::size_t marker;
+      /// Markers indices the instruction depends on or, for LOAD,
+      /// trajectory column of the marker x coordinate followed by the
+      /// marker id.
+      std::size_t inputs[3];
+      double parameters[3];
+    };
+
+    MarkerSetProgram ();
+    explicit MarkerSetProgram (const MarkerSet& markerSet);
+
+    LIBMOCAP_LVALUE_ACCESSOR (instructions, std::vector<Instruction>);
+    /// \brief Number of markers evaluated by the program.
+    LIBMOCAP_LVALUE_ACCESSOR (numMarkers, std::size_t);
+    /// \brief Minimum number of trajectory columns required by the
+    /// program.
+    LIBMOCAP_LVALUE_ACCESSOR (numColumns, std::size_t);
+    /// \brief Markers names, used to report errors.
+    LIBMOCAP_LVALUE_ACCESSOR (markerNames, std::vector<std::string>);
+
+    /// \brief Bind the physical markers to the columns of a
+    /// trajectory, looking them up by name.
+    ///
+    /// A std::runtime_error is thrown if a marker is not defined by
+    /// the trajectory.
+    void bind (const MarkerTrajectory& trajectory);
+
+    /// \brief Are the physical markers bound to the columns holding
+    /// them in a trajectory?
+    bool bound (const MarkerTrajectory& trajectory) const;
+
+    /// \brief Check that the program can be evaluated on a
+    /// trajectory.
+    ///
+    /// Every physical marker must have its coordinates in the
+    /// trajectory, at the column it is bound to: the trajectory
+    /// marker name at this column must be the marker one, unless the
+    /// trajectory does not name its markers. A std::runtime_error
+    /// naming the first faulty marker is thrown otherwise.
+    void validate (const MarkerTrajectory& trajectory) const;
+
+    /// \brief Evaluate all markers for one frame.
+    ///
+    /// \param positions buffer of 3 * numMarkers () values receiving
+    /// the markers positions, in the marker set order
+    /// \param trajectory trajectory providing the physical markers
+    /// \param frameId frame to be evaluated
+    void evaluate (double* positions,
+		   const MarkerTrajectory& trajectory,
+		   int frameId) const;
+
+    /// \brief Evaluate all markers over a range of frames.
+    ///
+    /// Each instruction is applied to a block of consecutive frames
+    /// at once so that the inner loops can be vectorized.
+    ///
+    /// \param positions buffer of 3 * numMarkers () * numFrames
+    /// values. Coordinate axis of marker m at frame firstFrame + k is
+    /// stored at positions[(3 * m + axis) * numFrames + k].
+    /// \param trajectory trajectory providing the physical markers
+    /// \param firstFrame first frame to be evaluated
+    /// \param numFrames number of frames to be evaluated
+    void evaluate (double* positions,
+		   const MarkerTrajectory& trajectory,
+		   int firstFrame,
+		   int numFrames) const;
+
+    /// \brief Evaluate all markers for one frame without any check.
+    ///
+    /// The trajectory must have been validated and frameId must be
+    /// in the [0, numFrames) range.
+    void evaluateUnchecked (double* positions,
+			    const MarkerTrajectory& trajectory,
+			    int frameId) const;
+
+    /// \brief Evaluate all markers from one trajectory row.
+    ///
+    /// No check is done: row must contain at least numColumns ()
+    /// values.
+    void evaluate (double* positions, const double* row) const;
+
+    std::ostream& print (std::ostream& o) const;
+  private:
+    /// \brief Describe the first marker which is not bound to its
+    /// column in a trajectory, empty if there is none.
+    std::string bindingError (const MarkerTrajectory& trajectory) const;
+
+    /// \brief Evaluate all markers from a row whose first element is
+    /// the trajectory column firstColumn.
+    template <typename T>
+    void evaluateRow (double* positions, const T* row,
+		      std::size_t firstColumn) const;
+
+    std::vector<Instruction> instructions_;
+    std::size_t numMarkers_;
+    std::size_t numColumns_;
+    std::vector<std::string> markerNames_;
+  };
+
+  LIBMOCAP_DLLEXPORT std::ostream&
+  operator<< (std::ostream& o, const MarkerSetProgram& program);
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_MARKER_SET_PROGRAM_HH
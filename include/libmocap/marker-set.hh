@@ -31,12 +31,14 @@
 #ifndef LIBMOCAP_MARKER_SET_HH
 # define LIBMOCAP_MARKER_SET_HH
 # include <iosfwd>
+# include <map>
 # include <string>
 # include <vector>
 
 # include <libmocap/config.hh>
 # include <libmocap/abstract-marker.hh>
 # include <libmocap/link.hh>
+# include <libmocap/marker-set-program.hh>
 # include <libmocap/pose.hh>
 # include <libmocap/segment.hh>
 # include <libmocap/util.hh>
@@ -92,7 +94,33 @@ namespace libmocap
     LIBMOCAP_ACCESSOR (segments, std::vector<Segment>);
     LIBMOCAP_ACCESSOR (poses, std::vector<Pose>);
 
-    const AbstractMarker& markerByName (const std::string name) const;
+    const AbstractMarker& markerByName (const std::string& name) const;
+
+    /// \brief Index of a marker in #markers_.
+    ///
+    /// Names should be resolved once using this method and indices
+    /// used afterwards.
+    int markerIndex (const std::string& name) const;
+
+    /// \brief Rebuild the markers name index.
+    ///
+    /// The index is built at load time and when copying the marker
+    /// set. If #markers_ is modified afterwards, lookups remain
+    /// correct but fall back to a linear search until this method
+    /// is called.
+    void indexMarkers ();
+
+    /// \brief Rebuild the segments children from their parent.
+    ///
+    /// Children are pointers to the elements of #segments_ and must
+    /// be rebuilt each time this vector is modified. Copying the
+    /// marker set rebuilds them automatically.
+    void linkSegments ();
+
+    /// \brief Compile the marker set for fast evaluation.
+    ///
+    /// \see MarkerSetProgram
+    MarkerSetProgram compile () const;
 
     std::ostream& print (std::ostream& o) const;
   private:
@@ -101,6 +129,7 @@ namespace libmocap
     std::vector<Link> links_;
     std::vector<Segment> segments_;
     std::vector<Pose> poses_;
+    std::map<std::string, std::size_t> markersIndex_;
   };
 
   LIBMOCAP_DLLEXPORT std::ostream&
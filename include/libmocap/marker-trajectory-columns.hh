@@ -0,0 +1,152 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_MARKER_TRAJECTORY_COLUMNS_HH
+# define LIBMOCAP_MARKER_TRAJECTORY_COLUMNS_HH
+# include <cstddef>
+
+# include <libmocap/config.hh>
+# include <libmocap/marker-trajectory.hh>
+# include <libmocap/position-matrix.hh>
+
+namespace libmocap
+{
+  /// \brief Marker-major (structure of arrays) copy of the positions
+  /// of a MarkerTrajectory.
+  ///
+  /// MarkerTrajectory stores one row per frame, which is convenient
+  /// to evaluate markers frame by frame but makes any per-marker
+  /// processing (filtering, gap detection, differentiation...) walk
+  /// the whole buffer with a large stride.
+  ///
+  /// This class stores the time and each coordinate of each marker
+  /// as separate contiguous arrays of numFrames () elements. It is
+  /// built from a trajectory and can be written back once processed.
+  class LIBMOCAP_DLLEXPORT MarkerTrajectoryColumns
+  {
+  public:
+    MarkerTrajectoryColumns ();
+    explicit MarkerTrajectoryColumns (const MarkerTrajectory& trajectory);
+    MarkerTrajectoryColumns (const MarkerTrajectoryColumns&);
+    ~MarkerTrajectoryColumns ();
+    MarkerTrajectoryColumns& operator= (const MarkerTrajectoryColumns& rhs);
+
+    /// \brief Copy (and transpose) the trajectory positions.
+    void fromTrajectory (const MarkerTrajectory& trajectory);
+
+    /// \brief Copy (and transpose) back the positions into a
+    /// trajectory.
+    ///
+    /// The number of frames and markers of the trajectory are
+    /// updated, other metadata are left untouched.
+    void toTrajectory (MarkerTrajectory& trajectory) const;
+
+    std::size_t numFrames () const
+    {
+      return data_.numCols ();
+    }
+
+    std::size_t numMarkers () const
+    {
+      return data_.numRows () ? (data_.numRows () - 1) / 3 : 0;
+    }
+
+    double* time ()
+    {
+      return data_.row (0).data ();
+    }
+
+    const double* time () const
+    {
+      return data_.row (0).data ();
+    }
+
+    /// \brief Coordinate of a marker over all frames.
+    ///
+    /// \param marker marker id
+    /// \param axis 0, 1 or 2 for respectively X, Y and Z.
+    double* coordinate (std::size_t marker, std::size_t axis)
+    {
+      return data_.row (1 + 3 * marker + axis).data ();
+    }
+
+    const double* coordinate (std::size_t marker, std::size_t axis) const
+    {
+      return data_.row (1 + 3 * marker + axis).data ();
+    }
+
+    double* x (std::size_t marker)
+    {
+      return coordinate (marker, 0);
+    }
+
+    const double* x (std::size_t marker) const
+    {
+      return coordinate (marker, 0);
+    }
+
+    double* y (std::size_t marker)
+    {
+      return coordinate (marker, 1);
+    }
+
+    const double* y (std::size_t marker) const
+    {
+      return coordinate (marker, 1);
+    }
+
+    double* z (std::size_t marker)
+    {
+      return coordinate (marker, 2);
+    }
+
+    const double* z (std::size_t marker) const
+    {
+      return coordinate (marker, 2);
+    }
+
+    /// \brief Underlying storage: one row per trajectory column.
+    const PositionMatrix& data () const
+    {
+      return data_;
+    }
+
+    PositionMatrix& data ()
+    {
+      return data_;
+    }
+
+  private:
+    PositionMatrix data_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_MARKER_TRAJECTORY_COLUMNS_HH
@@ -34,6 +34,7 @@
 
 # include <libmocap/config.hh>
 # include <libmocap/marker-trajectory.hh>
+# include <libmocap/marker-trajectory-load-options.hh>
 
 namespace libmocap
 {
@@ -45,6 +46,8 @@ namespace libmocap
     MarkerTrajectoryFactory& operator= (const MarkerTrajectoryFactory& rhs);
 
     MarkerTrajectory load (const std::string& filename);
+    MarkerTrajectory load (const std::string& filename,
+			   const MarkerTrajectoryLoadOptions& options);
   };
 } // end of namespace libmocap.
 
@@ -0,0 +1,199 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_MARKER_TRAJECTORY_LOAD_OPTIONS_HH
+# define LIBMOCAP_MARKER_TRAJECTORY_LOAD_OPTIONS_HH
+# include <cstddef>
+# include <iosfwd>
+# include <string>
+# include <vector>
+
+# include <libmocap/config.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  /// \brief Options controlling how a trajectory file is loaded.
+  ///
+  /// Default-constructed options reproduce the historical behavior
+  /// of MarkerTrajectoryFactory::load, unless the environment enables
+  /// the trajectory cache (see cache ()).
+  class LIBMOCAP_DLLEXPORT MarkerTrajectoryLoadOptions
+  {
+  public:
+    MarkerTrajectoryLoadOptions ();
+    MarkerTrajectoryLoadOptions (const MarkerTrajectoryLoadOptions&);
+    ~MarkerTrajectoryLoadOptions ();
+    MarkerTrajectoryLoadOptions&
+    operator= (const MarkerTrajectoryLoadOptions& rhs);
+
+    /// \brief Map the file in memory and parse it in place instead
+    /// of reading it line by line through a stream.
+    LIBMOCAP_ACCESSOR (memoryMapped, bool);
+
+    /// \brief Number of threads used to parse the data section.
+    ///
+    /// Zero means one thread per available core. Parsing with more
+    /// than one thread always relies on a memory mapped file.
+    LIBMOCAP_ACCESSOR (numThreads, int);
+
+    /// \brief Keep a binary image of parsed files in an on-disk
+    /// cache and reuse it as long as the source file is unchanged.
+    ///
+    /// This is disabled by default unless the
+    /// LIBMOCAP_TRAJECTORY_CACHE environment variable is set to a
+    /// value other than 0, so that the cache can be enabled without
+    /// modifying existing programs.
+    LIBMOCAP_ACCESSOR (cache, bool);
+
+    /// \brief Directory where cache entries are stored.
+    ///
+    /// If empty, entries are stored next to the source files. The
+    /// default value is taken from the LIBMOCAP_TRAJECTORY_CACHE_DIR
+    /// environment variable.
+    LIBMOCAP_ACCESSOR (cacheDirectory, std::string);
+
+    /// \brief Also compare a hash of the source file content before
+    /// using a cache entry.
+    ///
+    /// By default an entry is used as long as the size and the
+    /// modification time (with nanosecond resolution) of the source
+    /// file are unchanged. Hashing detects in-place modifications that
+    /// preserve both, at the cost of reading the whole source file.
+    /// The default value is enabled by setting the
+    /// LIBMOCAP_TRAJECTORY_CACHE_HASH environment variable to a value
+    /// other than 0.
+    LIBMOCAP_ACCESSOR (cacheHash, bool);
+
+    /// \name Frame range
+    ///
+    /// Only a window of the recording may be loaded. The window is
+    /// the intersection of the frame range and of the time range;
+    /// rows outside of it are skipped without being parsed.
+    ///
+    /// The loaded trajectory keeps the frame numbering and the time
+    /// column of the source file: its numFrames is the window size
+    /// and its firstFrame is the id of the first loaded frame.
+    /// \{
+
+    /// \brief Zero-based id of the first frame to load.
+    LIBMOCAP_ACCESSOR (firstFrame, int);
+
+    /// \brief Maximum number of frames to load, negative to load
+    /// every frame following firstFrame.
+    LIBMOCAP_ACCESSOR (numFrames, int);
+
+    /// \brief Frames recorded before this time are not loaded.
+    ///
+    /// Times are those of the file time column, frames are assumed
+    /// to be sampled regularly at the file data rate.
+    LIBMOCAP_ACCESSOR (startTime, double);
+
+    /// \brief Frames recorded after this time are not loaded.
+    LIBMOCAP_ACCESSOR (endTime, double);
+
+    /// \brief Locate the window through a sidecar frame index file.
+    ///
+    /// The index records the offset of regularly spaced rows of the
+    /// file, so that the rows preceding the window do not have to be
+    /// scanned. It is stored next to the TRC file and is built, with
+    /// a single scan, when missing or out of date.
+    LIBMOCAP_ACCESSOR (frameIndex, bool);
+
+    /// \brief Number of rows between two rows of the frame index.
+    ///
+    /// Smaller strides speed up seeking at the cost of a larger
+    /// index, 256 by default. A sidecar index built with another
+    /// stride is rebuilt.
+    LIBMOCAP_ACCESSOR (frameIndexStride, std::size_t);
+
+    /// \brief Is only a window of the recording loaded?
+    bool partial () const;
+
+    /// \brief Compute the window of frames to load.
+    ///
+    /// \param first receives the id of the first frame to load
+    /// \param count receives the number of frames to load
+    /// \param fileNumFrames number of frames of the file
+    /// \param firstTime time of the first frame of the file
+    /// \param dataRate file data rate
+    void frameRange (int& first, int& count,
+		     int fileNumFrames, double firstTime,
+		     double dataRate) const;
+
+    /// \}
+
+    /// \brief Names of the markers to load, all markers are loaded
+    /// if empty.
+    ///
+    /// Markers are stored in this order, the columns of the other
+    /// markers are skipped without being parsed. Marker sets
+    /// evaluated on such a trajectory look their markers up by name,
+    /// and fail if one of them has not been loaded.
+    LIBMOCAP_ACCESSOR (markers, std::vector<std::string>);
+
+    /// \brief Store the markers coordinates in single precision.
+    ///
+    /// The time column is kept in double precision, see
+    /// MarkerTrajectory::SINGLE_PRECISION.
+    LIBMOCAP_ACCESSOR (singlePrecision, bool);
+
+    /// \brief Resolve the markers option against the markers of a
+    /// file.
+    ///
+    /// \param indices receives the index, in fileMarkers, of each
+    /// marker to load
+    /// \param fileMarkers markers stored in the file
+    void markerIndices (std::vector<std::size_t>& indices,
+			const std::vector<std::string>& fileMarkers) const;
+
+    std::ostream& print (std::ostream& o) const;
+  private:
+    bool memoryMapped_;
+    int numThreads_;
+    bool cache_;
+    std::string cacheDirectory_;
+    bool cacheHash_;
+    int firstFrame_;
+    int numFrames_;
+    double startTime_;
+    double endTime_;
+    bool frameIndex_;
+    std::size_t frameIndexStride_;
+    std::vector<std::string> markers_;
+    bool singlePrecision_;
+  };
+
+  LIBMOCAP_DLLEXPORT std::ostream&
+  operator<< (std::ostream& o, const MarkerTrajectoryLoadOptions& options);
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_MARKER_TRAJECTORY_LOAD_OPTIONS_HH
@@ -0,0 +1,125 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_MARKER_TRAJECTORY_READER_HH
+# define LIBMOCAP_MARKER_TRAJECTORY_READER_HH
+# include <cstddef>
+# include <iosfwd>
+# include <string>
+
+# include <libmocap/config.hh>
+# include <libmocap/marker-trajectory.hh>
+# include <libmocap/marker-trajectory-load-options.hh>
+
+namespace libmocap
+{
+  class TrcFrameIndex;
+
+  /// \brief Streaming access to the frames of a TRC file.
+  ///
+  /// Contrary to MarkerTrajectoryFactory::load, the trajectory is
+  /// never materialized: frames are read one by one, or by batches,
+  /// into buffers provided by the caller. Memory usage therefore
+  /// does not depend on the recording length.
+  ///
+  /// To evaluate markers on the streamed frames, a copy of
+  /// metadata () whose positions are resized to the batch size can
+  /// be used as buffer.
+  ///
+  /// Frames can also be accessed randomly with seek. The rows are
+  /// then located through a sparse index of the data section, built
+  /// on first use or read from a sidecar file if the frameIndex load
+  /// option is set.
+  class LIBMOCAP_DLLEXPORT MarkerTrajectoryReader
+  {
+  public:
+    explicit MarkerTrajectoryReader (const std::string& filename);
+    /// \brief Open a file, only the frameIndex and frameIndexStride
+    /// options are used.
+    MarkerTrajectoryReader (const std::string& filename,
+			    const MarkerTrajectoryLoadOptions& options);
+    ~MarkerTrajectoryReader ();
+
+    /// \brief Trajectory metadata (positions are left empty).
+    const MarkerTrajectory& metadata () const
+    {
+      return metadata_;
+    }
+
+    /// \brief Number of values per frame, i.e. 1 + 3 * numMarkers.
+    std::size_t numColumns () const;
+
+    /// \brief Read the next frame.
+    ///
+    /// \param row buffer of numColumns () values receiving the time
+    /// and the markers coordinates
+    /// \param frameId if not null, receives the (zero-based) frame id
+    /// \return false if the end of the file has been reached
+    bool readFrame (double* row, int* frameId = 0);
+
+    /// \brief Read up to maxFrames frames.
+    ///
+    /// \param rows buffer of maxFrames * numColumns () values
+    /// \param frameIds if not null, buffer of maxFrames frame ids
+    /// \return number of frames read, smaller than maxFrames only
+    /// if the end of the file has been reached
+    std::size_t readFrames (double* rows, std::size_t maxFrames,
+			    int* frameIds = 0);
+
+    /// \brief Move to a frame, which is returned by the next read.
+    ///
+    /// \param frameId zero-based frame id, seeking past the last
+    /// frame moves to the end of the file
+    void seek (std::size_t frameId);
+
+    /// \brief Read up to maxFrames frames starting at firstFrame.
+    ///
+    /// \see seek, readFrames
+    std::size_t readFrames (std::size_t firstFrame, std::size_t maxFrames,
+			    double* rows, int* frameIds = 0);
+
+  private:
+    MarkerTrajectoryReader (const MarkerTrajectoryReader&);
+    MarkerTrajectoryReader& operator= (const MarkerTrajectoryReader&);
+
+    void open ();
+
+    std::string filename_;
+    bool sidecarIndex_;
+    std::size_t indexStride_;
+    std::ifstream* file_;
+    std::streamoff dataOffset_;
+    TrcFrameIndex* index_;
+    MarkerTrajectory metadata_;
+    std::string line_;
+  };
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_MARKER_TRAJECTORY_READER_HH
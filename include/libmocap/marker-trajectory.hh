@@ -31,11 +31,13 @@
 #ifndef LIBMOCAP_MARKER_TRAJECTORY_HH
 # define LIBMOCAP_MARKER_TRAJECTORY_HH
 # include <iosfwd>
+# include <map>
 # include <string>
 # include <vector>
 
 # include <libmocap/config.hh>
 # include <libmocap/abstract-marker.hh>
+# include <libmocap/position-matrix.hh>
 # include <libmocap/util.hh>
 
 namespace libmocap
@@ -43,6 +45,16 @@ namespace libmocap
   class LIBMOCAP_DLLEXPORT MarkerTrajectory
   {
   public:
+    /// \brief Storage precision of the markers coordinates.
+    enum Precision
+      {
+	/// Positions are stored in #positions_.
+	DOUBLE_PRECISION,
+	/// Coordinates are stored as floats and the time in double
+	/// precision, #positions_ is left empty.
+	SINGLE_PRECISION
+      };
+
     MarkerTrajectory ();
     MarkerTrajectory (const MarkerTrajectory&);
     virtual ~MarkerTrajectory ();
@@ -57,9 +69,108 @@ namespace libmocap
     LIBMOCAP_ACCESSOR (origDataRate, double);
     LIBMOCAP_ACCESSOR (origDataStartFrame, int);
     LIBMOCAP_ACCESSOR (origNumFrames, int);
+    /// \brief Frame id, in the source file, of the first row of
+    /// #positions_.
+    ///
+    /// This is zero unless only a range of frames has been loaded,
+    /// see MarkerTrajectoryLoadOptions.
+    LIBMOCAP_ACCESSOR (firstFrame, int);
 
     LIBMOCAP_ACCESSOR (markers, std::vector<std::string> );
-    LIBMOCAP_ACCESSOR (positions, std::vector<std::vector<double> >);
+    /// \brief Marker positions, one row per frame.
+    ///
+    /// Each row contains the time followed by the X, Y and Z
+    /// coordinates of every marker, see PositionMatrix.
+    ///
+    /// This is only used in double precision, code supporting both
+    /// precisions reads positions through position () or readRow ().
+    LIBMOCAP_ACCESSOR (positions, PositionMatrix);
+
+    /// \name Storage independent access to positions
+    ///
+    /// Rows and columns are those of #positions_, whatever the
+    /// storage precision.
+    /// \{
+
+    Precision precision () const
+    {
+      return precision_;
+    }
+
+    /// \brief Convert the stored positions to another precision.
+    void setPrecision (Precision precision);
+
+    /// \brief Reallocate the positions, all elements are set to zero.
+    void resize (std::size_t numRows, std::size_t numCols);
+
+    std::size_t numRows () const;
+    std::size_t numCols () const;
+
+    double time (std::size_t frame) const
+    {
+      if (precision_ == DOUBLE_PRECISION)
+	return positions_ (frame, 0);
+      return times_[frame];
+    }
+
+    double position (std::size_t frame, std::size_t column) const
+    {
+      if (precision_ == DOUBLE_PRECISION)
+	return positions_ (frame, column);
+      if (column == 0)
+	return times_[frame];
+      return singlePositions_[frame * (singleNumCols_ - 1) + column - 1];
+    }
+
+    /// \brief Replace one element, rounding it in single precision.
+    void setPosition (std::size_t frame, std::size_t column, double value)
+    {
+      if (precision_ == DOUBLE_PRECISION)
+	positions_ (frame, column) = value;
+      else if (column == 0)
+	times_[frame] = value;
+      else
+	singlePositions_[frame * (singleNumCols_ - 1) + column - 1] =
+	  static_cast<float> (value);
+    }
+
+    /// \brief Copy a row into a buffer of numCols () values.
+    void readRow (std::size_t frame, double* row) const;
+
+    /// \brief Replace a row by numCols () values.
+    void writeRow (std::size_t frame, const double* row);
+
+    /// \brief Single precision coordinates, without the time column.
+    ///
+    /// Element (frame, column) of #positions_, column being at least
+    /// one, is at frame * (numCols () - 1) + column - 1. This is null
+    /// in double precision.
+    const float* singlePrecisionData () const;
+    float* singlePrecisionData ();
+
+    /// \}
+
+    /// \brief Index of a marker in #markers_.
+    ///
+    /// The coordinates of marker i are stored in the columns
+    /// 1 + 3 * i to 3 + 3 * i of #positions_.
+    int markerIndex (const std::string& name) const;
+
+    /// \brief Index in #markers_ of a physical marker of a marker set.
+    ///
+    /// Marker set ids are the indices of the markers in the files
+    /// the marker set has been written for, which no longer holds
+    /// once only a subset of the markers has been loaded. The marker
+    /// is therefore looked up by name, the id only being tried first.
+    /// It is used as is if the trajectory does not name its markers.
+    ///
+    /// A std::runtime_error is thrown if the marker is missing.
+    int markerIndex (const std::string& name, int id) const;
+
+    /// \brief Rebuild the markers name index.
+    ///
+    /// \see MarkerSet::indexMarkers
+    void indexMarkers ();
 
     /// \brief Convert internal units to meters.
     void normalize ();
@@ -75,9 +186,15 @@ namespace libmocap
     double origDataRate_;
     int origDataStartFrame_;
     int origNumFrames_;
+    int firstFrame_;
 
     std::vector<std::string> markers_;
-    std::vector<std::vector<double> > positions_;
+    PositionMatrix positions_;
+    Precision precision_;
+    std::vector<double> times_;
+    std::vector<float> singlePositions_;
+    std::size_t singleNumCols_;
+    std::map<std::string, std::size_t> markersIndex_;
   };
 
   LIBMOCAP_DLLEXPORT std::ostream&
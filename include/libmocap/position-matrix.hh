@@ -0,0 +1,202 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_POSITION_MATRIX_HH
+# define LIBMOCAP_POSITION_MATRIX_HH
+# include <cstddef>
+# include <iosfwd>
+
+# include <libmocap/config.hh>
+
+namespace libmocap
+{
+  /// \brief Non-owning view on evenly spaced elements of a buffer.
+  ///
+  /// Rows of a PositionMatrix are views with a unit stride, columns
+  /// are views whose stride is the number of columns.
+  template <typename T>
+  class StridedView
+  {
+  public:
+    StridedView (T* data, std::size_t size, std::size_t stride)
+      : data_ (data),
+	size_ (size),
+	stride_ (stride)
+    {}
+
+    T& operator[] (std::size_t i) const
+    {
+      return data_[i * stride_];
+    }
+
+    T* data () const
+    {
+      return data_;
+    }
+
+    std::size_t size () const
+    {
+      return size_;
+    }
+
+    bool empty () const
+    {
+      return size_ == 0;
+    }
+
+    std::size_t stride () const
+    {
+      return stride_;
+    }
+
+  private:
+    T* data_;
+    std::size_t size_;
+    std::size_t stride_;
+  };
+
+  /// \brief Dense row-major matrix of doubles stored in a single
+  /// aligned buffer.
+  ///
+  /// This is the storage of MarkerTrajectory positions: there is one
+  /// row per frame, holding the time followed by the X, Y and Z
+  /// coordinates of each marker. Element (frame, 1 + 3 * marker + i)
+  /// is therefore the i-th coordinate of a marker.
+  ///
+  /// MarkerTrajectoryColumns stores the transposed matrix.
+  ///
+  /// For compatibility with code written for the former
+  /// std::vector<std::vector<double> > storage, size() returns the
+  /// number of rows and operator[] returns a row view, so that
+  /// positions ()[frame][column] keeps working.
+  class LIBMOCAP_DLLEXPORT PositionMatrix
+  {
+  public:
+    typedef StridedView<double> View;
+    typedef StridedView<const double> ConstView;
+
+    /// \brief Alignment of the buffer, in bytes.
+    static const std::size_t alignment = 64;
+
+    PositionMatrix ();
+    PositionMatrix (std::size_t numRows, std::size_t numCols);
+    PositionMatrix (const PositionMatrix&);
+    ~PositionMatrix ();
+    PositionMatrix& operator= (const PositionMatrix& rhs);
+
+    /// \brief Reallocate the matrix, all elements are set to zero.
+    void resize (std::size_t numRows, std::size_t numCols);
+    void clear ();
+    void swap (PositionMatrix& other);
+
+    /// \brief Store the transpose of this matrix into result.
+    void transpose (PositionMatrix& result) const;
+
+    std::size_t numRows () const
+    {
+      return numRows_;
+    }
+
+    std::size_t numCols () const
+    {
+      return numCols_;
+    }
+
+    /// \brief Number of rows (compatibility accessor).
+    std::size_t size () const
+    {
+      return numRows_;
+    }
+
+    bool empty () const
+    {
+      return numRows_ == 0;
+    }
+
+    double* data ()
+    {
+      return data_;
+    }
+
+    const double* data () const
+    {
+      return data_;
+    }
+
+    double& operator() (std::size_t row, std::size_t col)
+    {
+      return data_[row * numCols_ + col];
+    }
+
+    const double& operator() (std::size_t row, std::size_t col) const
+    {
+      return data_[row * numCols_ + col];
+    }
+
+    View row (std::size_t row)
+    {
+      return View (data_ + row * numCols_, numCols_, 1);
+    }
+
+    ConstView row (std::size_t row) const
+    {
+      return ConstView (data_ + row * numCols_, numCols_, 1);
+    }
+
+    View column (std::size_t col)
+    {
+      return View (data_ + col, numRows_, numCols_);
+    }
+
+    ConstView column (std::size_t col) const
+    {
+      return ConstView (data_ + col, numRows_, numCols_);
+    }
+
+    /// \brief Row access (compatibility accessor).
+    View operator[] (std::size_t row)
+    {
+      return this->row (row);
+    }
+
+    ConstView operator[] (std::size_t row) const
+    {
+      return this->row (row);
+    }
+
+  private:
+    std::size_t numRows_;
+    std::size_t numCols_;
+    double* data_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_POSITION_MATRIX_HH
@@ -0,0 +1,101 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_RIGID_BODY_GAP_FILLER_HH
+# define LIBMOCAP_RIGID_BODY_GAP_FILLER_HH
+# include <cstddef>
+# include <string>
+# include <vector>
+
+# include <libmocap/config.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  class MarkerSet;
+  class MarkerTrajectory;
+
+  /// \brief Fill gaps by assuming that neighboring markers move
+  /// rigidly.
+  ///
+  /// The neighbors of a physical marker are the physical markers
+  /// joined to it by a link, or defining the same segment. Virtual
+  /// markers are ignored as they are computed from physical markers.
+  ///
+  /// For each marker, the shape formed with its neighbors is
+  /// estimated from all the frames where they are all visible. A
+  /// missing sample is then reconstructed by fitting this shape,
+  /// in the least-squares sense, to the neighbors visible at that
+  /// frame (at least three non-collinear ones are required).
+  ///
+  /// A marker with less than three neighbors is therefore never
+  /// filled. In particular, the markers of a segment which are not
+  /// linked to any other marker only have two neighbors and are left
+  /// untouched: segments are not merged into larger rigid clusters
+  /// since neighboring segments move relative to each other.
+  ///
+  /// Only samples which were visible before the call are used as
+  /// input, so frames are processed independently, in parallel.
+  ///
+  /// \see GapFiller
+  class LIBMOCAP_DLLEXPORT RigidBodyGapFiller
+  {
+  public:
+    RigidBodyGapFiller ();
+    explicit RigidBodyGapFiller (const MarkerSet& markerSet);
+
+    /// \brief Number of threads, zero meaning one per available
+    /// core (default).
+    LIBMOCAP_ACCESSOR (numThreads, int);
+
+    /// \brief Neighbors of a marker, as markers ids.
+    ///
+    /// \param marker marker id, i.e. index in the trajectory markers.
+    const std::vector<std::size_t>& neighbors (std::size_t marker) const;
+
+    /// \brief Fill the gaps of a trajectory.
+    ///
+    /// Markers are looked up in the trajectory by name, see
+    /// MarkerTrajectory::markerIndex.
+    ///
+    /// \return number of reconstructed samples.
+    std::size_t fill (MarkerTrajectory& trajectory) const;
+
+  private:
+    std::vector<std::vector<std::size_t> > neighbors_;
+    /// \brief Markers names, by marker id, empty if the filler has
+    /// not been built from a marker set.
+    std::vector<std::string> names_;
+    int numThreads_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_RIGID_BODY_GAP_FILLER_HH
@@ -0,0 +1,79 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_SAVITZKY_GOLAY_FILTER_HH
+# define LIBMOCAP_SAVITZKY_GOLAY_FILTER_HH
+# include <libmocap/config.hh>
+# include <libmocap/abstract-trajectory-filter.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  /// \brief Savitzky-Golay smoothing filter.
+  ///
+  /// Each sample is replaced by the value at this sample of the
+  /// polynomial fitted, in the least-squares sense, to the window
+  /// centered on it. Near the ends of a segment, the polynomial
+  /// fitted to the first (or last) window is used instead.
+  ///
+  /// Segments shorter than the window are left untouched.
+  class LIBMOCAP_DLLEXPORT SavitzkyGolayFilter
+    : public AbstractTrajectoryFilter
+  {
+  public:
+    SavitzkyGolayFilter ();
+    SavitzkyGolayFilter (int windowLength, int polynomialOrder);
+    ~SavitzkyGolayFilter ();
+
+    /// \brief Window length, in frames (11 by default).
+    ///
+    /// It must be odd.
+    LIBMOCAP_ACCESSOR (windowLength, int);
+
+    /// \brief Order of the fitted polynomials (3 by default).
+    ///
+    /// It must be lower than the window length.
+    LIBMOCAP_ACCESSOR (polynomialOrder, int);
+
+  protected:
+    void coefficients (std::vector<double>& coefficients,
+		       double dataRate) const;
+
+    void filterSegment (double* samples, std::size_t size,
+			const std::vector<double>& coefficients) const;
+
+  private:
+    int windowLength_;
+    int polynomialOrder_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_SAVITZKY_GOLAY_FILTER_HH
@@ -0,0 +1,116 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_SEGMENT_FRAMES_HH
+# define LIBMOCAP_SEGMENT_FRAMES_HH
+# include <cstddef>
+# include <iosfwd>
+# include <vector>
+
+# include <libmocap/config.hh>
+# include <libmocap/marker-set-program.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  class MarkerSet;
+  class MarkerTrajectory;
+
+  /// \brief Compute the 6D frames of the segments of a marker set.
+  ///
+  /// The frame of a segment is attached to its origin marker. The x
+  /// axis points toward the long axis marker, the y axis lies in the
+  /// plane containing the plane axis marker and the z axis completes
+  /// the direct orthonormal basis. The segment rotation offset is
+  /// then applied as R = R_markers * Rz (yaw) * Ry (pitch) * Rx (roll).
+  ///
+  /// Frames are computed for a whole range of frames at once,
+  /// independently of any viewer.
+  class LIBMOCAP_DLLEXPORT SegmentFrames
+  {
+  public:
+    /// \brief Number of values describing one segment frame: the
+    /// rotation matrix (row-major) followed by the translation.
+    static const std::size_t frameSize = 12;
+
+    SegmentFrames ();
+    explicit SegmentFrames (const MarkerSet& markerSet);
+
+    /// \brief Bind the physical markers to the columns of a
+    /// trajectory.
+    ///
+    /// Frames can be computed from trajectories the markers are not
+    /// bound to, at the cost of binding a copy of the marker set
+    /// program on each call.
+    ///
+    /// \see MarkerSetProgram::bind
+    void bind (const MarkerTrajectory& trajectory);
+
+    /// \brief Number of segments, in the marker set order.
+    std::size_t numSegments () const
+    {
+      return segments_.size ();
+    }
+
+    /// \brief Compute the segments frames over a range of frames.
+    ///
+    /// \param frames buffer of numFrames * numSegments () * frameSize
+    /// values. The frame of segment s at frame firstFrame + k starts
+    /// at frames[(k * numSegments () + s) * frameSize].
+    /// \param valid if not null, buffer of numFrames * numSegments ()
+    /// flags set to zero when one of the markers defining the segment
+    /// is missing (NaN), or when these markers are coincident or
+    /// collinear. The frame is then filled with NaN.
+    /// \param trajectory trajectory providing the physical markers
+    /// \param firstFrame first frame to be computed
+    /// \param numFrames number of frames to be computed
+    void compute (double* frames,
+		  unsigned char* valid,
+		  const MarkerTrajectory& trajectory,
+		  int firstFrame,
+		  int numFrames) const;
+
+  private:
+    struct SegmentData
+    {
+      std::size_t originMarker;
+      std::size_t longAxisMarker;
+      std::size_t planeAxisMarker;
+      /// Rotation offset matrix (row-major).
+      double rotationOffset[9];
+    };
+
+    MarkerSetProgram program_;
+    std::vector<SegmentData> segments_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_SEGMENT_FRAMES_HH
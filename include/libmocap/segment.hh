@@ -82,6 +82,12 @@ namespace libmocap
 
     LIBMOCAP_ACCESSOR (id, int);
     LIBMOCAP_ACCESSOR (name, std::string);
+    /// \brief Index of the parent segment in the marker set, -1 for
+    /// root segments.
+    LIBMOCAP_ACCESSOR (parent, int);
+    /// \brief Children segments, derived from the segments parents.
+    ///
+    /// \see MarkerSet::linkSegments
     LIBMOCAP_ACCESSOR (children, std::vector<Segment*>);
     LIBMOCAP_ACCESSOR (originMarker, int);
     LIBMOCAP_ACCESSOR (longAxisMarker, int);
@@ -92,6 +98,7 @@ namespace libmocap
   private:
     int id_;
     std::string name_;
+    int parent_;
     std::vector<Segment*> children_;
     int originMarker_;
     int longAxisMarker_;
@@ -0,0 +1,110 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_SKELETON_FRAMES_HH
+# define LIBMOCAP_SKELETON_FRAMES_HH
+# include <cstddef>
+# include <vector>
+
+# include <libmocap/config.hh>
+# include <libmocap/segment-frames.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  class MarkerSet;
+  class MarkerTrajectory;
+
+  /// \brief Walk the segments tree of a marker set.
+  ///
+  /// Segments are sorted once so that parents always come before
+  /// their children. Each world transform is then computed once per
+  /// frame and reused by all the children of the segment.
+  ///
+  /// Transforms use the SegmentFrames layout: a row-major rotation
+  /// matrix followed by the translation (SegmentFrames::frameSize
+  /// values), for each frame and each segment in the marker set
+  /// order.
+  class LIBMOCAP_DLLEXPORT SkeletonFrames
+  {
+  public:
+    SkeletonFrames ();
+    explicit SkeletonFrames (const MarkerSet& markerSet);
+
+    /// \brief Segments indices, parents first.
+    LIBMOCAP_LVALUE_ACCESSOR (order, std::vector<std::size_t>);
+    /// \brief Parent index of each segment, -1 for roots.
+    LIBMOCAP_LVALUE_ACCESSOR (parents, std::vector<int>);
+
+    std::size_t numSegments () const
+    {
+      return parents_.size ();
+    }
+
+    /// \brief Compute world and parent-relative transforms from the
+    /// markers.
+    ///
+    /// The joint transform of a segment is its transform relative to
+    /// its parent, or its world transform for root segments.
+    ///
+    /// \param worldFrames buffer receiving the world transforms
+    /// \param jointFrames buffer receiving the joint transforms
+    /// \param valid if not null, receives zero for segments whose
+    /// transform could not be computed. A joint transform is invalid
+    /// if the segment or its parent world transform is invalid.
+    /// \param trajectory trajectory providing the physical markers
+    /// \param firstFrame first frame to be computed
+    /// \param numFrames number of frames to be computed
+    void compute (double* worldFrames,
+		  double* jointFrames,
+		  unsigned char* valid,
+		  const MarkerTrajectory& trajectory,
+		  int firstFrame,
+		  int numFrames) const;
+
+    /// \brief Forward chain: compute world transforms from joint
+    /// transforms.
+    ///
+    /// \param worldFrames buffer receiving the world transforms
+    /// \param jointFrames joint transforms
+    /// \param numFrames number of frames stored in the buffers
+    void forward (double* worldFrames,
+		  const double* jointFrames,
+		  std::size_t numFrames) const;
+
+  private:
+    SegmentFrames segmentFrames_;
+    std::vector<std::size_t> order_;
+    std::vector<int> parents_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_SKELETON_FRAMES_HH
@@ -0,0 +1,90 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_TRAJECTORY_DIFFERENTIATOR_HH
+# define LIBMOCAP_TRAJECTORY_DIFFERENTIATOR_HH
+# include <libmocap/config.hh>
+
+namespace libmocap
+{
+  class MarkerSet;
+  class MarkerTrajectory;
+  class MarkerTrajectoryColumns;
+
+  /// \brief Compute markers velocities and accelerations.
+  ///
+  /// Derivatives are estimated by central differences using the
+  /// time column, so frames do not need to be evenly spaced. At the
+  /// ends of the trajectory and next to missing samples (NaN),
+  /// one-sided differences are used instead. A derivative is NaN
+  /// when not enough valid neighboring samples are available: one
+  /// for the velocity, two for the acceleration.
+  ///
+  /// Results are stored as trajectories with the same metadata as
+  /// the source one, the time column included, so that they can be
+  /// processed or written like any other trajectory. Their units are
+  /// the units of the source trajectory, per second (squared).
+  ///
+  /// Computation is done on the marker-major layout of
+  /// MarkerTrajectoryColumns in one pass per coordinate.
+  class LIBMOCAP_DLLEXPORT TrajectoryDifferentiator
+  {
+  public:
+    TrajectoryDifferentiator ();
+    ~TrajectoryDifferentiator ();
+
+    /// \brief Differentiate marker-major positions.
+    ///
+    /// \param velocity if not null, receives the velocities
+    /// \param acceleration if not null, receives the accelerations
+    /// \param positions time and positions of the markers
+    void differentiate (MarkerTrajectoryColumns* velocity,
+			MarkerTrajectoryColumns* acceleration,
+			const MarkerTrajectoryColumns& positions) const;
+
+    /// \brief Differentiate the markers of a trajectory.
+    void differentiate (MarkerTrajectory* velocity,
+			MarkerTrajectory* acceleration,
+			const MarkerTrajectory& trajectory) const;
+
+    /// \brief Differentiate all the markers of a marker set, virtual
+    /// ones included.
+    ///
+    /// The markers of the results are the markers of the marker set,
+    /// in the same order.
+    void differentiate (MarkerTrajectory* velocity,
+			MarkerTrajectory* acceleration,
+			const MarkerSet& markerSet,
+			const MarkerTrajectory& trajectory) const;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_TRAJECTORY_DIFFERENTIATOR_HH
@@ -0,0 +1,100 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_TRAJECTORY_RESAMPLER_HH
+# define LIBMOCAP_TRAJECTORY_RESAMPLER_HH
+# include <libmocap/config.hh>
+# include <libmocap/util.hh>
+
+namespace libmocap
+{
+  class MarkerTrajectory;
+  class MarkerTrajectoryColumns;
+
+  /// \brief Resample trajectories at a different data rate.
+  ///
+  /// The resampled trajectory starts at the time of the first frame
+  /// of the source one and its frames are evenly spaced at the
+  /// target rate, up to the time of the last source frame. Positions
+  /// are interpolated from the source frames around each new frame
+  /// using the source time column.
+  ///
+  /// A resampled position is NaN when one of the two source samples
+  /// around it is missing, so gaps are preserved but never widened
+  /// by more than one source frame. Cubic interpolation falls back
+  /// to one-sided tangents next to gaps and at the ends.
+  ///
+  /// Markers are processed in parallel.
+  class LIBMOCAP_DLLEXPORT TrajectoryResampler
+  {
+  public:
+    enum Interpolation
+      {
+	/// \brief Straight line between the surrounding samples.
+	LINEAR,
+	/// \brief Cubic Hermite spline whose tangents are estimated by
+	/// finite differences (Catmull-Rom spline for evenly spaced
+	/// frames).
+	CUBIC
+      };
+
+    TrajectoryResampler ();
+    explicit TrajectoryResampler (Interpolation interpolation);
+
+    LIBMOCAP_ACCESSOR (interpolation, Interpolation);
+
+    /// \brief Number of threads, zero meaning one per available
+    /// core (default).
+    LIBMOCAP_ACCESSOR (numThreads, int);
+
+    /// \brief Resample marker-major positions.
+    ///
+    /// \param result resampled positions
+    /// \param positions source time and positions
+    /// \param dataRate target data rate, in Hz
+    void resample (MarkerTrajectoryColumns& result,
+		   const MarkerTrajectoryColumns& positions,
+		   double dataRate) const;
+
+    /// \brief Resample a trajectory.
+    ///
+    /// The result has the metadata of the source trajectory, but
+    /// its data rate and number of frames.
+    MarkerTrajectory resample (const MarkerTrajectory& trajectory,
+			       double dataRate) const;
+
+  private:
+    Interpolation interpolation_;
+    int numThreads_;
+  };
+
+} // end of namespace libmocap.
+
+#endif //! LIBMOCAP_TRAJECTORY_RESAMPLER_HH
@@ -0,0 +1,205 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <libmocap/abstract-trajectory-filter.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-columns.hh>
+
+#include "thread-pool.hh"
+
+namespace libmocap
+{
+  namespace
+  {
+    /// Filter the coordinates of one marker.
+    class ChannelsFilter : public ThreadPool::Task
+    {
+    public:
+      ChannelsFilter (const AbstractTrajectoryFilter& filter,
+		      void (AbstractTrajectoryFilter::*filterSegment)
+		      (double*, std::size_t, const std::vector<double>&)
+		      const,
+		      const std::vector<double>& coefficients,
+		      const PositionMatrix::View* first,
+		      const PositionMatrix::View* last)
+	: filter_ (&filter),
+	  filterSegment_ (filterSegment),
+	  coefficients_ (&coefficients),
+	  first_ (first),
+	  last_ (last)
+      {}
+
+      void run ()
+      {
+	std::vector<double> samples;
+	for (const PositionMatrix::View* channel = first_;
+	     channel != last_; ++channel)
+	  {
+	    // Work on a contiguous copy of strided channels.
+	    double* data = channel->data ();
+	    if (channel->stride () != 1)
+	      {
+		samples.resize (channel->size ());
+		for (std::size_t i = 0; i < channel->size (); ++i)
+		  samples[i] = (*channel)[i];
+		data = samples.empty () ? 0 : &samples[0];
+	      }
+
+	    std::size_t i = 0;
+	    while (i < channel->size ())
+	      {
+		if (std::isnan (data[i]))
+		  {
+		    ++i;
+		    continue;
+		  }
+		std::size_t start = i;
+		while (i < channel->size () && !std::isnan (data[i]))
+		  ++i;
+		(filter_->*filterSegment_)
+		  (data + start, i - start, *coefficients_);
+	      }
+
+	    if (channel->stride () != 1)
+	      for (std::size_t i = 0; i < channel->size (); ++i)
+		(*channel)[i] = samples[i];
+	  }
+      }
+
+    private:
+      const AbstractTrajectoryFilter* filter_;
+      void (AbstractTrajectoryFilter::*filterSegment_)
+      (double*, std::size_t, const std::vector<double>&) const;
+      const std::vector<double>* coefficients_;
+      const PositionMatrix::View* first_;
+      const PositionMatrix::View* last_;
+    };
+
+    /// Number of markers gathered at once when filtering single
+    /// precision trajectories.
+    const std::size_t markersPerBlock = 16;
+  } // end of anonymous namespace.
+
+  AbstractTrajectoryFilter::AbstractTrajectoryFilter ()
+    : numThreads_ (0)
+  {}
+
+  AbstractTrajectoryFilter::~AbstractTrajectoryFilter ()
+  {}
+
+  void
+  AbstractTrajectoryFilter::filter (MarkerTrajectory& trajectory) const
+  {
+    std::vector<PositionMatrix::View> channels;
+    if (trajectory.precision () == MarkerTrajectory::DOUBLE_PRECISION)
+      {
+	PositionMatrix& positions = trajectory.positions ();
+	for (std::size_t col = 1; col < positions.numCols (); ++col)
+	  channels.push_back (positions.column (col));
+	filter (channels, trajectory.dataRate ());
+	return;
+      }
+
+    // Single precision coordinates are filtered by blocks of markers
+    // gathered in double precision, the whole trajectory is never
+    // converted.
+    const std::size_t numFrames = trajectory.numRows ();
+    const std::size_t numChannels =
+      trajectory.numCols () ? trajectory.numCols () - 1 : 0;
+    PositionMatrix block;
+    for (std::size_t first = 0; first < numChannels;
+	 first += 3 * markersPerBlock)
+      {
+	const std::size_t n =
+	  std::min (3 * markersPerBlock, numChannels - first);
+	block.resize (n, numFrames);
+	channels.clear ();
+	for (std::size_t i = 0; i < n; ++i)
+	  {
+	    PositionMatrix::View channel = block.row (i);
+	    for (std::size_t frame = 0; frame < numFrames; ++frame)
+	      channel[frame] = trajectory.position (frame, 1 + first + i);
+	    channels.push_back (channel);
+	  }
+
+	filter (channels, trajectory.dataRate ());
+
+	for (std::size_t i = 0; i < n; ++i)
+	  for (std::size_t frame = 0; frame < numFrames; ++frame)
+	    trajectory.setPosition (frame, 1 + first + i, block (i, frame));
+      }
+  }
+
+  void
+  AbstractTrajectoryFilter::filter (MarkerTrajectoryColumns& columns,
+				    double dataRate) const
+  {
+    std::vector<PositionMatrix::View> channels;
+    for (std::size_t marker = 0; marker < columns.numMarkers (); ++marker)
+      for (std::size_t axis = 0; axis < 3; ++axis)
+	channels.push_back
+	  (PositionMatrix::View (columns.coordinate (marker, axis),
+				 columns.numFrames (), 1));
+    filter (channels, dataRate);
+  }
+
+  void
+  AbstractTrajectoryFilter::filter
+  (const std::vector<PositionMatrix::View>& channels, double dataRate) const
+  {
+    if (numThreads_ < 0)
+      throw std::runtime_error ("invalid number of threads");
+    if (!(dataRate > 0.))
+      throw std::runtime_error ("invalid data rate");
+
+    std::vector<double> coefficients;
+    this->coefficients (coefficients, dataRate);
+    if (channels.empty ())
+      return;
+
+    // One task per marker, i.e. per group of three coordinates.
+    std::vector<ChannelsFilter> filters;
+    for (std::size_t i = 0; i < channels.size (); i += 3)
+      filters.push_back
+	(ChannelsFilter (*this, &AbstractTrajectoryFilter::filterSegment,
+			 coefficients, &channels[i],
+			 &channels[0] + std::min (i + 3, channels.size ())));
+
+    std::vector<ThreadPool::Task*> tasks (filters.size ());
+    for (std::size_t i = 0; i < filters.size (); ++i)
+      tasks[i] = &filters[i];
+    ThreadPool pool (static_cast<std::size_t> (numThreads_));
+    pool.run (tasks);
+  }
+
+} // end of namespace libmocap.
@@ -0,0 +1,112 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_BINARY_MARKER_TRAJECTORY_FORMAT_HH
+# define LIBMOCAP_BINARY_MARKER_TRAJECTORY_FORMAT_HH
+# include <cstddef>
+# include <cstring>
+# include <stdint.h>
+
+// Binary trajectory file format (*.btrc).
+//
+// All values are little-endian.
+//
+// offset  size  content
+// ------  ----  -------
+//      0     8  magic string "LIBMOCAP"
+//      8     4  format version (uint32)
+//     12     4  size of one scalar of the payload, 8 (double) or 4 (float)
+//     16     4  payload offset in bytes (uint32), multiple of 64
+//     20     4  number of frames (int32)
+//     24     4  number of markers (int32)
+//     28     4  original data start frame (int32)
+//     32     4  original number of frames (int32)
+//     36     4  first frame (int32), zero unless the trajectory only
+//               holds a range of the frames of its source file
+//     40     8  data rate (double)
+//     48     8  camera rate (double)
+//     56     8  original data rate (double)
+//     64        strings: filename, units and then the marker names,
+//               each one stored as its length (uint32) followed by
+//               its characters. The number of marker names (uint32)
+//               precedes them.
+//
+// The payload is a row-major matrix of numFrames rows of
+// (1 + 3 * numMarkers) scalars, i.e. the same layout as
+// MarkerTrajectory::positions. Frame i therefore starts at
+// payloadOffset + i * (1 + 3 * numMarkers) * scalarSize.
+
+namespace libmocap
+{
+  namespace binaryTrajectory
+  {
+    static const char magic[] = "LIBMOCAP";
+    static const std::size_t magicSize = 8;
+    static const uint32_t version = 1;
+    static const std::size_t fixedHeaderSize = 64;
+    static const std::size_t payloadAlignment = 64;
+
+    inline bool isLittleEndian ()
+    {
+      const uint32_t one = 1;
+      unsigned char byte;
+      std::memcpy (&byte, &one, 1);
+      return byte == 1;
+    }
+
+    /// \brief Reverse the bytes of a value in place if the host is
+    /// big-endian.
+    inline void toLittleEndian (void* value, std::size_t size)
+    {
+      if (isLittleEndian ())
+	return;
+      unsigned char* bytes = static_cast<unsigned char*> (value);
+      for (std::size_t i = 0; i < size / 2; ++i)
+	{
+	  unsigned char tmp = bytes[i];
+	  bytes[i] = bytes[size - 1 - i];
+	  bytes[size - 1 - i] = tmp;
+	}
+    }
+
+    /// \brief Read a little-endian value from a possibly unaligned
+    /// address.
+    template <typename T>
+    T read (const char* data)
+    {
+      T value;
+      std::memcpy (&value, data, sizeof (T));
+      toLittleEndian (&value, sizeof (T));
+      return value;
+    }
+  } // end of namespace binaryTrajectory.
+} // end of namespace libmocap
+
+#endif //! LIBMOCAP_BINARY_MARKER_TRAJECTORY_FORMAT_HH
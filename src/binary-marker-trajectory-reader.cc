@@ -0,0 +1,255 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <libmocap/binary-marker-trajectory-reader.hh>
+
+#include "binary-marker-trajectory-format.hh"
+#include "mapped-file.hh"
+#include "string.hh"
+
+namespace libmocap
+{
+  namespace
+  {
+    /// \brief Bounds-checked sequential reader over the file header.
+    class HeaderReader
+    {
+    public:
+      HeaderReader (const char* data, std::size_t size)
+	: data_ (data),
+	  size_ (size),
+	  offset_ (0)
+      {}
+
+      const char* take (std::size_t size)
+      {
+	if (size > size_ - offset_)
+	  throw std::runtime_error ("truncated binary trajectory header");
+	const char* result = data_ + offset_;
+	offset_ += size;
+	return result;
+      }
+
+      template <typename T>
+      T read ()
+      {
+	return binaryTrajectory::read<T> (take (sizeof (T)));
+      }
+
+      std::string readString ()
+      {
+	std::size_t size = read<uint32_t> ();
+	return std::string (take (size), size);
+      }
+
+    private:
+      const char* data_;
+      std::size_t size_;
+      std::size_t offset_;
+    };
+  } // end of anonymous namespace.
+
+  BinaryMarkerTrajectoryReader::BinaryMarkerTrajectoryReader
+  (const std::string& filename)
+    : file_ (new MappedFile (filename)),
+      metadata_ (),
+      scalarSize_ (),
+      payloadOffset_ ()
+  {
+    try
+      {
+	HeaderReader header (file_->data (), file_->size ());
+
+	if (std::memcmp (header.take (binaryTrajectory::magicSize),
+			 binaryTrajectory::magic,
+			 binaryTrajectory::magicSize) != 0)
+	  throw std::runtime_error
+	    ("`" + filename + "' is not a binary trajectory file");
+
+	uint32_t version = header.read<uint32_t> ();
+	if (version != binaryTrajectory::version)
+	  {
+	    std::ostringstream error;
+	    error << "unsupported binary trajectory version " << version;
+	    throw std::runtime_error (error.str ());
+	  }
+
+	scalarSize_ = header.read<uint32_t> ();
+	if (scalarSize_ != sizeof (double) && scalarSize_ != sizeof (float))
+	  throw std::runtime_error ("invalid binary trajectory precision");
+	payloadOffset_ = header.read<uint32_t> ();
+
+	metadata_.numFrames () = header.read<int32_t> ();
+	metadata_.numMarkers () = header.read<int32_t> ();
+	metadata_.origDataStartFrame () = header.read<int32_t> ();
+	metadata_.origNumFrames () = header.read<int32_t> ();
+	metadata_.firstFrame () = header.read<int32_t> ();
+	metadata_.dataRate () = header.read<double> ();
+	metadata_.cameraRate () = header.read<double> ();
+	metadata_.origDataRate () = header.read<double> ();
+
+	if (metadata_.numFrames () < 0 || metadata_.numMarkers () < 0)
+	  throw std::runtime_error ("invalid binary trajectory dimensions");
+
+	metadata_.filename () = header.readString ();
+	metadata_.units () = header.readString ();
+	std::size_t numNames = header.read<uint32_t> ();
+	if (numNames != static_cast<std::size_t> (metadata_.numMarkers ()))
+	  throw std::runtime_error
+	    ("binary trajectory marker names do not match its markers");
+	for (std::size_t i = 0; i < numNames; ++i)
+	  metadata_.markers ().push_back (header.readString ());
+	metadata_.indexMarkers ();
+
+	// Dimensions come from the file: bound each factor by the
+	// available payload before multiplying, so that the products
+	// cannot overflow.
+	if (payloadOffset_ > file_->size ())
+	  throw std::runtime_error ("truncated binary trajectory payload");
+	const std::size_t available = file_->size () - payloadOffset_;
+	const std::size_t numMarkers =
+	  static_cast<std::size_t> (metadata_.numMarkers ());
+	if (numMarkers > (std::numeric_limits<std::size_t>::max () - 1) / 3
+	    || numColumns () > available / scalarSize_
+	    || numFrames () > available / (numColumns () * scalarSize_))
+	  throw std::runtime_error ("truncated binary trajectory payload");
+      }
+    catch (...)
+      {
+	delete file_;
+	throw;
+      }
+  }
+
+  BinaryMarkerTrajectoryReader::~BinaryMarkerTrajectoryReader ()
+  {
+    delete file_;
+  }
+
+  std::size_t
+  BinaryMarkerTrajectoryReader::numFrames () const
+  {
+    return static_cast<std::size_t> (metadata_.numFrames ());
+  }
+
+  std::size_t
+  BinaryMarkerTrajectoryReader::numColumns () const
+  {
+    return 1 + 3 * static_cast<std::size_t> (metadata_.numMarkers ());
+  }
+
+  void
+  BinaryMarkerTrajectoryReader::readFrame
+  (std::size_t frameId, double* row) const
+  {
+    if (frameId >= numFrames ())
+      throw std::runtime_error ("frame id is too large");
+
+    const char* data = file_->data () + payloadOffset_
+      + frameId * numColumns () * scalarSize_;
+
+    if (scalarSize_ == sizeof (double))
+      {
+	if (binaryTrajectory::isLittleEndian ())
+	  std::memcpy (row, data, numColumns () * sizeof (double));
+	else
+	  for (std::size_t i = 0; i < numColumns (); ++i)
+	    row[i] = binaryTrajectory::read<double> (data + i * sizeof (double));
+      }
+    else
+      for (std::size_t i = 0; i < numColumns (); ++i)
+	row[i] = binaryTrajectory::read<float> (data + i * sizeof (float));
+  }
+
+  const double*
+  BinaryMarkerTrajectoryReader::frameData (std::size_t frameId) const
+  {
+    if (frameId >= numFrames ())
+      throw std::runtime_error ("frame id is too large");
+    if (scalarSize_ != sizeof (double) || !binaryTrajectory::isLittleEndian ())
+      return 0;
+    return reinterpret_cast<const double*>
+      (file_->data () + payloadOffset_
+       + frameId * numColumns () * sizeof (double));
+  }
+
+  MarkerTrajectory
+  BinaryMarkerTrajectoryReader::load () const
+  {
+    MarkerTrajectory trajectory (metadata_);
+    trajectory.positions ().resize (numFrames (), numColumns ());
+
+    if (scalarSize_ == sizeof (double) && binaryTrajectory::isLittleEndian ())
+      {
+	if (numFrames ())
+	  std::memcpy (trajectory.positions ().data (),
+		       file_->data () + payloadOffset_,
+		       numFrames () * numColumns () * sizeof (double));
+      }
+    else
+      for (std::size_t frame = 0; frame < numFrames (); ++frame)
+	readFrame (frame, trajectory.positions ().row (frame).data ());
+    return trajectory;
+  }
+
+  MarkerTrajectory
+  BinaryMarkerTrajectoryReader::load
+  (std::size_t firstFrame, std::size_t numFrames) const
+  {
+    if (firstFrame > this->numFrames ()
+	|| numFrames > this->numFrames () - firstFrame)
+      throw std::runtime_error ("frame range is too large");
+
+    MarkerTrajectory trajectory (metadata_);
+    trajectory.numFrames () = static_cast<int> (numFrames);
+    trajectory.firstFrame () += static_cast<int> (firstFrame);
+    trajectory.positions ().resize (numFrames, numColumns ());
+    for (std::size_t frame = 0; frame < numFrames; ++frame)
+      readFrame (firstFrame + frame,
+		 trajectory.positions ().row (frame).data ());
+    return trajectory;
+  }
+
+  bool
+  BinaryMarkerTrajectoryReader::canLoad (const std::string& filename)
+  {
+    std::string extension = extractExtension (filename);
+    std::transform (extension.begin (),
+		    extension.end(),
+		    extension.begin(), ::tolower);
+    return extension == "btrc";
+  }
+
+} // end of namespace libmocap.
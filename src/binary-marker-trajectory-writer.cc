@@ -0,0 +1,160 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <libmocap/binary-marker-trajectory-writer.hh>
+
+#include "binary-marker-trajectory-format.hh"
+
+namespace libmocap
+{
+  template <typename T>
+  static void writeValue (std::ostream& stream, T value)
+  {
+    binaryTrajectory::toLittleEndian (&value, sizeof (T));
+    stream.write (reinterpret_cast<const char*> (&value), sizeof (T));
+  }
+
+  static void writeString (std::ostream& stream, const std::string& value)
+  {
+    writeValue (stream, static_cast<uint32_t> (value.size ()));
+    stream.write (value.data (), static_cast<std::streamsize> (value.size ()));
+  }
+
+  BinaryMarkerTrajectoryWriter::BinaryMarkerTrajectoryWriter ()
+  {}
+
+  BinaryMarkerTrajectoryWriter::~BinaryMarkerTrajectoryWriter ()
+  {}
+
+  BinaryMarkerTrajectoryWriter&
+  BinaryMarkerTrajectoryWriter::operator=
+  (const BinaryMarkerTrajectoryWriter& rhs)
+  {
+    if (this == &rhs)
+      return *this;
+    return *this;
+  }
+
+  void
+  BinaryMarkerTrajectoryWriter::write
+  (const std::string& filename,
+   const MarkerTrajectory& trajectory,
+   Precision precision)
+  {
+    const std::size_t numRows = trajectory.numRows ();
+    const std::size_t numCols = trajectory.numCols ();
+    if (numRows != static_cast<std::size_t> (trajectory.numFrames ())
+	|| numCols != 1 + 3 * static_cast<std::size_t> (trajectory.numMarkers ()))
+      throw std::runtime_error
+	("trajectory positions are inconsistent with its metadata");
+
+    std::ofstream file (filename.c_str (), std::ios::out | std::ios::binary);
+    if (!file.good ())
+      throw std::runtime_error ("cannot open file `" + filename + "'");
+    file.exceptions (std::ofstream::failbit | std::ofstream::badbit);
+
+    uint32_t scalarSize =
+      precision == SINGLE_PRECISION ? sizeof (float) : sizeof (double);
+
+    // Compute the header size to align the payload.
+    std::size_t headerSize = binaryTrajectory::fixedHeaderSize
+      + 4 + trajectory.filename ().size ()
+      + 4 + trajectory.units ().size ()
+      + 4;
+    for (std::size_t i = 0; i < trajectory.markers ().size (); ++i)
+      headerSize += 4 + trajectory.markers ()[i].size ();
+    std::size_t payloadOffset =
+      (headerSize + binaryTrajectory::payloadAlignment - 1)
+      / binaryTrajectory::payloadAlignment
+      * binaryTrajectory::payloadAlignment;
+
+    file.write (binaryTrajectory::magic,
+		static_cast<std::streamsize> (binaryTrajectory::magicSize));
+    writeValue (file, binaryTrajectory::version);
+    writeValue (file, scalarSize);
+    writeValue (file, static_cast<uint32_t> (payloadOffset));
+    writeValue (file, static_cast<int32_t> (trajectory.numFrames ()));
+    writeValue (file, static_cast<int32_t> (trajectory.numMarkers ()));
+    writeValue (file, static_cast<int32_t> (trajectory.origDataStartFrame ()));
+    writeValue (file, static_cast<int32_t> (trajectory.origNumFrames ()));
+    writeValue (file, static_cast<int32_t> (trajectory.firstFrame ()));
+    writeValue (file, trajectory.dataRate ());
+    writeValue (file, trajectory.cameraRate ());
+    writeValue (file, trajectory.origDataRate ());
+
+    writeString (file, trajectory.filename ());
+    writeString (file, trajectory.units ());
+    writeValue (file, static_cast<uint32_t> (trajectory.markers ().size ()));
+    for (std::size_t i = 0; i < trajectory.markers ().size (); ++i)
+      writeString (file, trajectory.markers ()[i]);
+
+    for (std::size_t i = headerSize; i < payloadOffset; ++i)
+      file.put (0);
+
+    // Fast path: the in-memory layout is already the file layout.
+    if (precision == DOUBLE_PRECISION && binaryTrajectory::isLittleEndian ()
+	&& trajectory.precision () == MarkerTrajectory::DOUBLE_PRECISION)
+      {
+	file.write (reinterpret_cast<const char*>
+		    (trajectory.positions ().data ()),
+		    static_cast<std::streamsize>
+		    (numRows * numCols * sizeof (double)));
+	return;
+      }
+
+    std::vector<char> buffer (numCols * scalarSize);
+    std::vector<double> row (numCols);
+    for (std::size_t frame = 0; frame < numRows; ++frame)
+      {
+	trajectory.readRow (frame, &row[0]);
+	for (std::size_t i = 0; i < numCols; ++i)
+	  {
+	    char* dst = &buffer[i * scalarSize];
+	    if (precision == SINGLE_PRECISION)
+	      {
+		float value = static_cast<float> (row[i]);
+		binaryTrajectory::toLittleEndian (&value, sizeof (float));
+		std::memcpy (dst, &value, sizeof (float));
+	      }
+	    else
+	      {
+		double value = row[i];
+		binaryTrajectory::toLittleEndian (&value, sizeof (double));
+		std::memcpy (dst, &value, sizeof (double));
+	      }
+	  }
+	file.write (&buffer[0], static_cast<std::streamsize> (buffer.size ()));
+      }
+  }
+
+} // end of namespace libmocap.
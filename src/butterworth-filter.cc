@@ -0,0 +1,172 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include <libmocap/butterworth-filter.hh>
+
+namespace libmocap
+{
+  namespace
+  {
+    /// Number of coefficients of a second order section:
+    /// b0, b1, b2, a1, a2 (a0 being 1).
+    const std::size_t sectionSize = 5;
+
+    void
+    addSection (std::vector<double>& coefficients,
+		double b0, double b1, double b2, double a1, double a2)
+    {
+      coefficients.push_back (b0);
+      coefficients.push_back (b1);
+      coefficients.push_back (b2);
+      coefficients.push_back (a1);
+      coefficients.push_back (a2);
+    }
+
+    /// Run the sections cascade over samples, in place. The state
+    /// of each section is initialized as if the first sample had
+    /// been repeated forever. If reverse is true, the samples are
+    /// processed from the last one.
+    void
+    runSections (double* first, std::size_t size, bool reverse,
+		 const std::vector<double>& coefficients)
+    {
+      for (std::size_t s = 0; s < coefficients.size (); s += sectionSize)
+	{
+	  const double b0 = coefficients[s];
+	  const double b1 = coefficients[s + 1];
+	  const double b2 = coefficients[s + 2];
+	  const double a1 = coefficients[s + 3];
+	  const double a2 = coefficients[s + 4];
+
+	  // Transposed direct form II.
+	  const double initial = reverse ? first[size - 1] : first[0];
+	  const double gain = (b0 + b1 + b2) / (1. + a1 + a2);
+	  double z1 = gain * initial - b0 * initial;
+	  double z2 = b2 * initial - a2 * gain * initial;
+
+	  for (std::size_t i = 0; i < size; ++i)
+	    {
+	      double& sample = reverse ? first[size - 1 - i] : first[i];
+	      const double x = sample;
+	      const double y = b0 * x + z1;
+	      z1 = b1 * x - a1 * y + z2;
+	      z2 = b2 * x - a2 * y;
+	      sample = y;
+	    }
+	}
+    }
+  } // end of anonymous namespace.
+
+  ButterworthFilter::ButterworthFilter ()
+    : AbstractTrajectoryFilter (),
+      cutoffFrequency_ (6.),
+      order_ (2)
+  {}
+
+  ButterworthFilter::ButterworthFilter (double cutoffFrequency, int order)
+    : AbstractTrajectoryFilter (),
+      cutoffFrequency_ (cutoffFrequency),
+      order_ (order)
+  {}
+
+  ButterworthFilter::~ButterworthFilter ()
+  {}
+
+  void
+  ButterworthFilter::coefficients (std::vector<double>& coefficients,
+				   double dataRate) const
+  {
+    if (order_ < 1)
+      throw std::runtime_error ("invalid Butterworth filter order");
+    if (!(cutoffFrequency_ > 0.) || !(cutoffFrequency_ < dataRate / 2.))
+      {
+	std::ostringstream error;
+	error << "invalid cutoff frequency " << cutoffFrequency_
+	      << " Hz for a data rate of " << dataRate << " Hz";
+	throw std::runtime_error (error.str ());
+      }
+
+    // Prewarped cutoff of the normalized analog prototype.
+    const double k = std::tan (M_PI * cutoffFrequency_ / dataRate);
+    const double k2 = k * k;
+    const double n = static_cast<double> (order_);
+
+    coefficients.clear ();
+    for (int i = 1; i <= order_ / 2; ++i)
+      {
+	// Analog section s^2 + alpha s + 1.
+	const double alpha =
+	  2. * std::sin (M_PI * (2. * i - 1.) / (2. * n));
+	const double norm = 1. / (1. + alpha * k + k2);
+	const double b0 = k2 * norm;
+	addSection (coefficients, b0, 2. * b0, b0,
+		    2. * (k2 - 1.) * norm,
+		    (1. - alpha * k + k2) * norm);
+      }
+    if (order_ % 2)
+      {
+	// Analog section s + 1.
+	const double b0 = k / (k + 1.);
+	addSection (coefficients, b0, b0, 0., (k - 1.) / (k + 1.), 0.);
+      }
+  }
+
+  void
+  ButterworthFilter::filterSegment
+  (double* samples, std::size_t size,
+   const std::vector<double>& coefficients) const
+  {
+    if (size < 2)
+      return;
+
+    // Extend the segment by odd reflection around its end points.
+    const std::size_t numSections = coefficients.size () / sectionSize;
+    const std::size_t padding =
+      std::min (size - 1, 3 * (2 * numSections + 1));
+    std::vector<double> extended (size + 2 * padding);
+    for (std::size_t i = 0; i < padding; ++i)
+      {
+	extended[i] = 2. * samples[0] - samples[padding - i];
+	extended[padding + size + i] =
+	  2. * samples[size - 1] - samples[size - 2 - i];
+      }
+    std::copy (samples, samples + size, &extended[padding]);
+
+    runSections (&extended[0], extended.size (), false, coefficients);
+    runSections (&extended[0], extended.size (), true, coefficients);
+
+    std::copy (&extended[padding], &extended[padding] + size, samples);
+  }
+
+} // end of namespace libmocap.
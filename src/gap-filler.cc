@@ -0,0 +1,220 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <cmath>
+#include <ostream>
+
+#include <libmocap/gap-filler.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-columns.hh>
+
+namespace libmocap
+{
+  namespace
+  {
+    bool
+    missing (const double* const* coordinates, std::size_t frame)
+    {
+      return std::isnan (coordinates[0][frame])
+	|| std::isnan (coordinates[1][frame])
+	|| std::isnan (coordinates[2][frame]);
+    }
+
+    /// Find the gaps of one marker. Gaps are appended to gaps.
+    void
+    findMarkerGaps (std::vector<GapFiller::Gap>& gaps,
+		    GapFiller::Statistics& statistics,
+		    const double* const* coordinates,
+		    std::size_t numFrames,
+		    std::size_t marker,
+		    std::size_t maxGapLength)
+    {
+      std::size_t frame = 0;
+      while (frame < numFrames)
+	{
+	  if (!missing (coordinates, frame))
+	    {
+	      ++frame;
+	      continue;
+	    }
+
+	  GapFiller::Gap gap;
+	  gap.marker = marker;
+	  gap.firstFrame = frame;
+	  while (frame < numFrames && missing (coordinates, frame))
+	    ++frame;
+	  gap.length = frame - gap.firstFrame;
+	  gap.filled = gap.firstFrame > 0 && frame < numFrames
+	    && (!maxGapLength || gap.length <= maxGapLength);
+	  gaps.push_back (gap);
+
+	  ++statistics.numGaps;
+	  statistics.numMissingSamples += gap.length;
+	  if (gap.length > statistics.longestGap)
+	    statistics.longestGap = gap.length;
+	  if (gap.filled)
+	    {
+	      ++statistics.numFilledGaps;
+	      statistics.numFilledSamples += gap.length;
+	    }
+	}
+    }
+
+    /// Interpolate one gap, bounded by the valid samples before and
+    /// after.
+    void
+    fillGap (double* const* coordinates,
+	     std::size_t numFrames,
+	     const GapFiller::Gap& gap,
+	     GapFiller::Interpolation interpolation)
+    {
+      const std::size_t before = gap.firstFrame - 1;
+      const std::size_t after = gap.firstFrame + gap.length;
+      const double span = static_cast<double> (gap.length + 1);
+
+      // Tangents (per frame) are estimated from the samples
+      // surrounding the gap when available, otherwise the spline
+      // degrades to the straight line.
+      const bool hasPrevious = interpolation == GapFiller::CUBIC
+	&& before > 0 && !missing (coordinates, before - 1);
+      const bool hasNext = interpolation == GapFiller::CUBIC
+	&& after + 1 < numFrames && !missing (coordinates, after + 1);
+
+      for (std::size_t axis = 0; axis < 3; ++axis)
+	{
+	  double* c = coordinates[axis];
+	  const double p0 = c[before];
+	  const double p1 = c[after];
+	  const double slope = (p1 - p0) / span;
+	  const double m0 = hasPrevious ? p0 - c[before - 1] : slope;
+	  const double m1 = hasNext ? c[after + 1] - p1 : slope;
+
+	  for (std::size_t i = 1; i <= gap.length; ++i)
+	    {
+	      const double u = static_cast<double> (i) / span;
+	      if (interpolation == GapFiller::LINEAR)
+		{
+		  c[before + i] = p0 + (p1 - p0) * u;
+		  continue;
+		}
+	      const double u2 = u * u;
+	      const double u3 = u2 * u;
+	      const double h00 = 2. * u3 - 3. * u2 + 1.;
+	      const double h10 = u3 - 2. * u2 + u;
+	      const double h01 = -2. * u3 + 3. * u2;
+	      const double h11 = u3 - u2;
+	      c[before + i] = h00 * p0 + h10 * span * m0
+		+ h01 * p1 + h11 * span * m1;
+	    }
+	}
+    }
+  } // end of anonymous namespace.
+
+  GapFiller::Statistics::Statistics ()
+    : numGaps (0),
+      numFilledGaps (0),
+      numMissingSamples (0),
+      numFilledSamples (0),
+      longestGap (0)
+  {}
+
+  GapFiller::GapFiller ()
+    : interpolation_ (LINEAR),
+      maxGapLength_ (0)
+  {}
+
+  GapFiller::Statistics
+  GapFiller::findGaps (std::vector<Gap>& gaps,
+		       const MarkerTrajectoryColumns& columns) const
+  {
+    Statistics statistics;
+    gaps.clear ();
+    for (std::size_t marker = 0; marker < columns.numMarkers (); ++marker)
+      {
+	const double* coordinates[3] =
+	  {columns.x (marker), columns.y (marker), columns.z (marker)};
+	findMarkerGaps (gaps, statistics, coordinates,
+			columns.numFrames (), marker, maxGapLength_);
+      }
+    return statistics;
+  }
+
+  GapFiller::Statistics
+  GapFiller::findGaps (std::vector<Gap>& gaps,
+		       const MarkerTrajectory& trajectory) const
+  {
+    return findGaps (gaps, MarkerTrajectoryColumns (trajectory));
+  }
+
+  GapFiller::Statistics
+  GapFiller::fill (MarkerTrajectoryColumns& columns,
+		   std::vector<Gap>* gaps) const
+  {
+    Statistics statistics;
+    std::vector<Gap> markerGaps;
+    if (gaps)
+      gaps->clear ();
+    for (std::size_t marker = 0; marker < columns.numMarkers (); ++marker)
+      {
+	double* coordinates[3] =
+	  {columns.x (marker), columns.y (marker), columns.z (marker)};
+	markerGaps.clear ();
+	findMarkerGaps (markerGaps, statistics, coordinates,
+			columns.numFrames (), marker, maxGapLength_);
+	for (std::size_t i = 0; i < markerGaps.size (); ++i)
+	  if (markerGaps[i].filled)
+	    fillGap (coordinates, columns.numFrames (), markerGaps[i],
+		     interpolation_);
+	if (gaps)
+	  gaps->insert (gaps->end (), markerGaps.begin (), markerGaps.end ());
+      }
+    return statistics;
+  }
+
+  GapFiller::Statistics
+  GapFiller::fill (MarkerTrajectory& trajectory, std::vector<Gap>* gaps) const
+  {
+    MarkerTrajectoryColumns columns (trajectory);
+    Statistics statistics = fill (columns, gaps);
+    if (statistics.numFilledGaps)
+      columns.toTrajectory (trajectory);
+    return statistics;
+  }
+
+  std::ostream&
+  operator<< (std::ostream& o, const GapFiller::Statistics& statistics)
+  {
+    return o << "gaps: " << statistics.numGaps
+	     << " (filled: " << statistics.numFilledGaps << ")" << std::endl
+	     << "missing samples: " << statistics.numMissingSamples
+	     << " (filled: " << statistics.numFilledSamples << ")" << std::endl
+	     << "longest gap: " << statistics.longestGap << " frame(s)";
+  }
+
+} // end of namespace libmocap.
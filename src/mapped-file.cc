@@ -0,0 +1,85 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "mapped-file.hh"
+
+namespace libmocap
+{
+  MappedFile::MappedFile (const std::string& filename)
+    : data_ (0),
+      size_ (0)
+  {
+    int fd = ::open (filename.c_str (), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error
+	("cannot open file `" + filename + "': " + std::strerror (errno));
+
+    struct stat status;
+    if (::fstat (fd, &status) < 0)
+      {
+	std::string error =
+	  "cannot stat file `" + filename + "': " + std::strerror (errno);
+	::close (fd);
+	throw std::runtime_error (error);
+      }
+    size_ = static_cast<std::size_t> (status.st_size);
+
+    if (size_ > 0)
+      {
+	void* address = ::mmap (0, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (address == MAP_FAILED)
+	  {
+	    std::string error =
+	      "cannot map file `" + filename + "': " + std::strerror (errno);
+	    ::close (fd);
+	    throw std::runtime_error (error);
+	  }
+	data_ = static_cast<const char*> (address);
+      }
+
+    // The mapping stays valid once the descriptor is closed.
+    ::close (fd);
+  }
+
+  MappedFile::~MappedFile ()
+  {
+    if (data_)
+      ::munmap (const_cast<char*> (data_), size_);
+  }
+
+} // end of namespace libmocap
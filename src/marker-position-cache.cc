@@ -0,0 +1,94 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <libmocap/marker-position-cache.hh>
+#include <libmocap/marker-set.hh>
+#include <libmocap/marker-trajectory.hh>
+
+namespace libmocap
+{
+  MarkerPositionCache::MarkerPositionCache
+  (const MarkerSet& markerSet, const MarkerTrajectory& trajectory)
+    : trajectory_ (trajectory),
+      program_ (markerSet),
+      segmentFrames_ (markerSet),
+      positionsFrame_ (-1),
+      positions_ (3 * program_.numMarkers ()),
+      segmentsFrame_ (-1),
+      segments_ (segmentFrames_.numSegments () * SegmentFrames::frameSize),
+      segmentsValid_ (segmentFrames_.numSegments ())
+  {
+    program_.bind (trajectory);
+    segmentFrames_.bind (trajectory);
+    program_.validate (trajectory);
+  }
+
+  const double*
+  MarkerPositionCache::positions (int frameId)
+  {
+    if (frameId != positionsFrame_)
+      {
+	// Invalidate first in case evaluation throws.
+	positionsFrame_ = -1;
+	if (!positions_.empty ())
+	  program_.evaluate (&positions_[0], trajectory_, frameId);
+	positionsFrame_ = frameId;
+      }
+    return positions_.empty () ? 0 : &positions_[0];
+  }
+
+  const double*
+  MarkerPositionCache::segmentFrames (int frameId)
+  {
+    if (frameId != segmentsFrame_)
+      {
+	segmentsFrame_ = -1;
+	if (!segments_.empty ())
+	  segmentFrames_.compute (&segments_[0], &segmentsValid_[0],
+				  trajectory_, frameId, 1);
+	segmentsFrame_ = frameId;
+      }
+    return segments_.empty () ? 0 : &segments_[0];
+  }
+
+  const unsigned char*
+  MarkerPositionCache::segmentsValid (int frameId)
+  {
+    segmentFrames (frameId);
+    return segmentsValid_.empty () ? 0 : &segmentsValid_[0];
+  }
+
+  void
+  MarkerPositionCache::invalidate ()
+  {
+    positionsFrame_ = -1;
+    segmentsFrame_ = -1;
+  }
+
+} // end of namespace libmocap.
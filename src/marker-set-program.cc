@@ -0,0 +1,536 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <libmocap/marker.hh>
+#include <libmocap/marker-set.hh>
+#include <libmocap/marker-set-program.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/virtual-marker-one-point-measured.hh>
+#include <libmocap/virtual-marker-three-points-measured.hh>
+#include <libmocap/virtual-marker-three-points-ratio.hh>
+#include <libmocap/virtual-marker-two-points-measured.hh>
+#include <libmocap/virtual-marker-two-points-ratio.hh>
+
+#include "virtual-marker-math.hh"
+
+namespace libmocap
+{
+  namespace
+  {
+    enum VisitState
+      {
+	NOT_VISITED,
+	VISITING,
+	VISITED
+      };
+
+    /// \brief Marker set compiler state.
+    ///
+    /// Markers are emitted in depth-first post-order so that each
+    /// instruction comes after the instructions it depends on.
+    struct Compiler
+    {
+      Compiler (const MarkerSet& markerSet,
+		std::vector<MarkerSetProgram::Instruction>& instructions)
+	: markerSet (markerSet),
+	  instructions (instructions),
+	  state (markerSet.markers ().size (), NOT_VISITED),
+	  numColumns (0)
+      {}
+
+      std::size_t dependency (std::size_t marker, int dependency,
+			      const char* role)
+      {
+	const std::vector<AbstractMarker*>& markers = markerSet.markers ();
+	std::ostringstream error;
+	error << "marker " << markers[marker]->name () << ": ";
+
+	if (dependency < 0)
+	  {
+	    error << "negative " << role << " marker";
+	    throw std::runtime_error (error.str ());
+	  }
+	std::size_t dependency_ = static_cast<std::size_t> (dependency);
+	if (dependency_ >= markers.size ())
+	  {
+	    error << role << " marker id too large";
+	    throw std::runtime_error (error.str ());
+	  }
+	if (!markers[dependency_])
+	  {
+	    error << "null " << role << " marker";
+	    throw std::runtime_error (error.str ());
+	  }
+	if (state[dependency_] == VISITING)
+	  {
+	    error << "cyclic dependency through "
+		  << markers[dependency_]->name ();
+	    throw std::runtime_error (error.str ());
+	  }
+	visit (dependency_);
+	return dependency_;
+      }
+
+      void setParameters (MarkerSetProgram::Instruction& instruction,
+			  const std::vector<double>& parameters)
+      {
+	if (parameters.size () != 3)
+	  throw std::runtime_error ("invalid parameters vector size");
+	for (std::size_t i = 0; i < 3; ++i)
+	  instruction.parameters[i] = parameters[i];
+      }
+
+      void visit (std::size_t marker)
+      {
+	if (state[marker] != NOT_VISITED)
+	  return;
+	state[marker] = VISITING;
+
+	MarkerSetProgram::Instruction instruction;
+	instruction.opCode = MarkerSetProgram::UNDEFINED;
+	instruction.marker = marker;
+	for (std::size_t i = 0; i < 3; ++i)
+	  {
+	    instruction.inputs[i] = 0;
+	    instruction.parameters[i] = 0.;
+	  }
+
+	const AbstractMarker* abstractMarker = markerSet.markers ()[marker];
+	const AbstractVirtualMarker* virtualMarker =
+	  dynamic_cast<const AbstractVirtualMarker*> (abstractMarker);
+
+	if (!abstractMarker)
+	  {
+	    // Null markers are kept undefined.
+	  }
+	else if (dynamic_cast<const Marker*> (abstractMarker))
+	  {
+	    if (abstractMarker->id () < 0)
+	      throw std::runtime_error ("marker id is inconsistent");
+	    std::size_t id = static_cast<std::size_t> (abstractMarker->id ());
+	    instruction.opCode = MarkerSetProgram::LOAD;
+	    instruction.inputs[0] = 1 + id * 3;
+	    instruction.inputs[1] = id;
+	    numColumns = std::max (numColumns, 1 + id * 3 + 3);
+	  }
+	else if (const VirtualMarkerOnePointMeasured* m =
+		 dynamic_cast<const VirtualMarkerOnePointMeasured*>
+		 (abstractMarker))
+	  {
+	    instruction.opCode = MarkerSetProgram::ONE_POINT_MEASURED;
+	    instruction.inputs[0] =
+	      dependency (marker, m->originMarker (), "origin");
+	    setParameters (instruction, m->offset ());
+	  }
+	else if (const VirtualMarkerTwoPointsRatio* m =
+		 dynamic_cast<const VirtualMarkerTwoPointsRatio*>
+		 (abstractMarker))
+	  {
+	    instruction.opCode = MarkerSetProgram::TWO_POINTS_RATIO;
+	    instruction.inputs[0] =
+	      dependency (marker, m->originMarker (), "origin");
+	    instruction.inputs[1] =
+	      dependency (marker, m->longAxisMarker (), "long axis");
+	    instruction.parameters[0] = m->weight ();
+	  }
+	else if (const VirtualMarkerTwoPointsMeasured* m =
+		 dynamic_cast<const VirtualMarkerTwoPointsMeasured*>
+		 (abstractMarker))
+	  {
+	    instruction.opCode = MarkerSetProgram::TWO_POINTS_MEASURED;
+	    instruction.inputs[0] =
+	      dependency (marker, m->originMarker (), "origin");
+	    instruction.inputs[1] =
+	      dependency (marker, m->longAxisMarker (), "long axis");
+	    instruction.parameters[0] = m->offset ();
+	  }
+	else if (const VirtualMarkerThreePointsRatio* m =
+		 dynamic_cast<const VirtualMarkerThreePointsRatio*>
+		 (abstractMarker))
+	  {
+	    instruction.opCode = MarkerSetProgram::THREE_POINTS_RATIO;
+	    threePointsDependencies (instruction, *virtualMarker);
+	    setParameters (instruction, m->weights ());
+	  }
+	else if (const VirtualMarkerThreePointsMeasured* m =
+		 dynamic_cast<const VirtualMarkerThreePointsMeasured*>
+		 (abstractMarker))
+	  {
+	    instruction.opCode = MarkerSetProgram::THREE_POINTS_MEASURED;
+	    threePointsDependencies (instruction, *virtualMarker);
+	    setParameters (instruction, m->offset ());
+	  }
+	else
+	  throw std::runtime_error
+	    ("marker " + abstractMarker->name () + ": unsupported marker type");
+
+	state[marker] = VISITED;
+	instructions.push_back (instruction);
+      }
+
+      void threePointsDependencies
+      (MarkerSetProgram::Instruction& instruction,
+       const AbstractVirtualMarker& marker)
+      {
+	instruction.inputs[0] =
+	  dependency (instruction.marker, marker.originMarker (), "origin");
+	instruction.inputs[1] =
+	  dependency (instruction.marker, marker.longAxisMarker (),
+		      "long axis");
+	instruction.inputs[2] =
+	  dependency (instruction.marker, marker.planeAxisMarker (),
+		      "plane axis");
+      }
+
+      const MarkerSet& markerSet;
+      std::vector<MarkerSetProgram::Instruction>& instructions;
+      std::vector<VisitState> state;
+      std::size_t numColumns;
+    };
+
+    /// \brief Number of frames processed by each instruction at once
+    /// by the batch evaluation.
+    ///
+    /// Small enough for a block of the markers positions to remain in
+    /// cache while the whole program is run on it.
+    static const std::size_t blockSize = 256;
+
+    /// \brief Gather the coordinates of one marker for n frames.
+    ///
+    /// \param rows first coordinate of the marker in the first row,
+    /// in double or single precision
+    template <typename T>
+    void loadMarker (std::size_t n, std::size_t stride, std::size_t numCols,
+		     double* position, const T* rows)
+    {
+      for (std::size_t axis = 0; axis < 3; ++axis)
+	for (std::size_t k = 0; k < n; ++k)
+	  position[axis * stride + k] = rows[k * numCols + axis];
+    }
+  } // end of anonymous namespace.
+
+  MarkerSetProgram::MarkerSetProgram ()
+    : instructions_ (),
+      numMarkers_ (0),
+      numColumns_ (0),
+      markerNames_ ()
+  {}
+
+  MarkerSetProgram::MarkerSetProgram (const MarkerSet& markerSet)
+    : instructions_ (),
+      numMarkers_ (markerSet.markers ().size ()),
+      numColumns_ (0),
+      markerNames_ (numMarkers_)
+  {
+    instructions_.reserve (numMarkers_);
+    for (std::size_t marker = 0; marker < numMarkers_; ++marker)
+      if (markerSet.markers ()[marker])
+	markerNames_[marker] = markerSet.markers ()[marker]->name ();
+
+    Compiler compiler (markerSet, instructions_);
+    for (std::size_t marker = 0; marker < numMarkers_; ++marker)
+      compiler.visit (marker);
+    numColumns_ = compiler.numColumns;
+  }
+
+  void
+  MarkerSetProgram::bind (const MarkerTrajectory& trajectory)
+  {
+    numColumns_ = 0;
+    std::vector<Instruction>::iterator it;
+    for (it = instructions_.begin (); it != instructions_.end (); ++it)
+      if (it->opCode == LOAD)
+	{
+	  int index = trajectory.markerIndex
+	    (markerNames_[it->marker], static_cast<int> (it->inputs[1]));
+	  it->inputs[0] = 1 + 3 * static_cast<std::size_t> (index);
+	  numColumns_ = std::max (numColumns_, it->inputs[0] + 3);
+	}
+  }
+
+  bool
+  MarkerSetProgram::bound (const MarkerTrajectory& trajectory) const
+  {
+    return bindingError (trajectory).empty ();
+  }
+
+  void
+  MarkerSetProgram::validate (const MarkerTrajectory& trajectory) const
+  {
+    std::string error = bindingError (trajectory);
+    if (!error.empty ())
+      throw std::runtime_error (error);
+  }
+
+  std::string
+  MarkerSetProgram::bindingError (const MarkerTrajectory& trajectory) const
+  {
+    const std::size_t numCols = trajectory.numCols ();
+    const std::vector<std::string>& markers = trajectory.markers ();
+
+    std::vector<Instruction>::const_iterator it;
+    for (it = instructions_.begin (); it != instructions_.end (); ++it)
+      {
+	if (it->opCode != LOAD)
+	  continue;
+
+	// Trajectories which do not name their markers are trusted.
+	const std::size_t index = (it->inputs[0] - 1) / 3;
+	const bool missing = it->inputs[0] + 3 > numCols;
+	const bool misplaced = !missing && !markers.empty ()
+	  && (index >= markers.size ()
+	      || markers[index] != markerNames_[it->marker]);
+	if (!missing && !misplaced)
+	  continue;
+
+	std::ostringstream error;
+	error << "marker " << markerNames_[it->marker];
+	if (missing)
+	  error
+	    << " (id " << index << ")"
+	    << " is not defined by trajectory `"
+	    << trajectory.filename () << "' ("
+	    << markers.size () << " markers)";
+	else
+	  error
+	    << " is bound to column " << it->inputs[0]
+	    << " which holds marker "
+	    << (index < markers.size () ? markers[index] : "(none)")
+	    << " in trajectory `" << trajectory.filename () << "'";
+	return error.str ();
+      }
+    return std::string ();
+  }
+
+  void
+  MarkerSetProgram::evaluate (double* positions,
+			      const MarkerTrajectory& trajectory,
+			      int frameId) const
+  {
+    if (frameId < 0)
+      throw std::runtime_error ("negative frame id");
+    if (static_cast<std::size_t> (frameId) >= trajectory.numRows ())
+      throw std::runtime_error ("frame id is too large");
+    validate (trajectory);
+
+    evaluateUnchecked (positions, trajectory, frameId);
+  }
+
+  void
+  MarkerSetProgram::evaluate (double* positions,
+			      const MarkerTrajectory& trajectory,
+			      int firstFrame,
+			      int numFrames) const
+  {
+    if (firstFrame < 0)
+      throw std::runtime_error ("negative frame id");
+    if (numFrames < 0)
+      throw std::runtime_error ("negative number of frames");
+    if (static_cast<std::size_t> (firstFrame)
+	+ static_cast<std::size_t> (numFrames) > trajectory.numRows ())
+      throw std::runtime_error ("frame id is too large");
+    validate (trajectory);
+
+    const std::size_t stride = static_cast<std::size_t> (numFrames);
+    const std::size_t numCols = trajectory.numCols ();
+    const bool singlePrecision =
+      trajectory.precision () == MarkerTrajectory::SINGLE_PRECISION;
+
+    for (std::size_t first = 0; first < stride; first += blockSize)
+      {
+	const std::size_t n = std::min (blockSize, stride - first);
+	const std::size_t row = static_cast<std::size_t> (firstFrame) + first;
+
+	std::vector<Instruction>::const_iterator it;
+	for (it = instructions_.begin (); it != instructions_.end (); ++it)
+	  {
+	    double* position = positions + 3 * it->marker * stride + first;
+	    const double* origin =
+	      positions + 3 * it->inputs[0] * stride + first;
+	    const double* longAxis =
+	      positions + 3 * it->inputs[1] * stride + first;
+	    const double* planeAxis =
+	      positions + 3 * it->inputs[2] * stride + first;
+
+	    switch (it->opCode)
+	      {
+	      case LOAD:
+		// Single precision rows have no time column.
+		if (singlePrecision)
+		  loadMarker (n, stride, numCols - 1, position,
+			      trajectory.singlePrecisionData ()
+			      + row * (numCols - 1) + it->inputs[0] - 1);
+		else
+		  loadMarker (n, stride, numCols, position,
+			      trajectory.positions ().data ()
+			      + row * numCols + it->inputs[0]);
+		break;
+	      case ONE_POINT_MEASURED:
+		onePointMeasured (n, stride, position, origin, it->parameters);
+		break;
+	      case TWO_POINTS_RATIO:
+		twoPointsRatio
+		  (n, stride, position, origin, longAxis, it->parameters[0]);
+		break;
+	      case TWO_POINTS_MEASURED:
+		twoPointsMeasured
+		  (n, stride, position, origin, longAxis, it->parameters[0]);
+		break;
+	      case THREE_POINTS_RATIO:
+		threePointsRatio (n, stride, position, origin, longAxis,
+				  planeAxis, it->parameters);
+		break;
+	      case THREE_POINTS_MEASURED:
+		threePointsMeasured (n, stride, position, origin, longAxis,
+				     planeAxis, it->parameters);
+		break;
+	      case UNDEFINED:
+		for (std::size_t axis = 0; axis < 3; ++axis)
+		  std::fill (position + axis * stride,
+			     position + axis * stride + n,
+			     std::numeric_limits<double>::quiet_NaN ());
+		break;
+	      }
+	  }
+      }
+  }
+
+  void
+  MarkerSetProgram::evaluateUnchecked (double* positions,
+				       const MarkerTrajectory& trajectory,
+				       int frameId) const
+  {
+    const std::size_t frame = static_cast<std::size_t> (frameId);
+
+    // Single precision rows are read in place, they have no time
+    // column.
+    if (trajectory.precision () == MarkerTrajectory::SINGLE_PRECISION)
+      {
+	evaluateRow (positions, trajectory.singlePrecisionData ()
+		     + frame * (trajectory.numCols () - 1), 1);
+	return;
+      }
+
+    const PositionMatrix& matrix = trajectory.positions ();
+    evaluateRow (positions, matrix.data () + frame * matrix.numCols (), 0);
+  }
+
+  void
+  MarkerSetProgram::evaluate (double* positions, const double* row) const
+  {
+    evaluateRow (positions, row, 0);
+  }
+
+  template <typename T>
+  void
+  MarkerSetProgram::evaluateRow (double* positions, const T* row,
+				 std::size_t firstColumn) const
+  {
+    std::vector<Instruction>::const_iterator it;
+    for (it = instructions_.begin (); it != instructions_.end (); ++it)
+      {
+	double* position = positions + 3 * it->marker;
+	const double* origin = positions + 3 * it->inputs[0];
+	const double* longAxis = positions + 3 * it->inputs[1];
+	const double* planeAxis = positions + 3 * it->inputs[2];
+
+	switch (it->opCode)
+	  {
+	  case LOAD:
+	    position[0] = row[it->inputs[0] - firstColumn];
+	    position[1] = row[it->inputs[0] - firstColumn + 1];
+	    position[2] = row[it->inputs[0] - firstColumn + 2];
+	    break;
+	  case ONE_POINT_MEASURED:
+	    onePointMeasured (position, origin, it->parameters);
+	    break;
+	  case TWO_POINTS_RATIO:
+	    twoPointsRatio (position, origin, longAxis, it->parameters[0]);
+	    break;
+	  case TWO_POINTS_MEASURED:
+	    twoPointsMeasured (position, origin, longAxis, it->parameters[0]);
+	    break;
+	  case THREE_POINTS_RATIO:
+	    threePointsRatio
+	      (position, origin, longAxis, planeAxis, it->parameters);
+	    break;
+	  case THREE_POINTS_MEASURED:
+	    threePointsMeasured
+	      (position, origin, longAxis, planeAxis, it->parameters);
+	    break;
+	  case UNDEFINED:
+	    position[0] = position[1] = position[2] =
+	      std::numeric_limits<double>::quiet_NaN ();
+	    break;
+	  }
+      }
+  }
+
+  std::ostream&
+  MarkerSetProgram::print (std::ostream& stream) const
+  {
+    static const char* opCodes[] =
+      {
+	"load",
+	"one point measured",
+	"two points ratio",
+	"two points measured",
+	"three points ratio",
+	"three points measured",
+	"undefined"
+      };
+
+    stream
+      << "markers: " << numMarkers () << '\n'
+      << "columns: " << numColumns () << '\n'
+      << "instructions:\n";
+    std::vector<Instruction>::const_iterator it;
+    for (it = instructions_.begin (); it != instructions_.end (); ++it)
+      stream
+	<< it->marker << " <- " << opCodes[it->opCode]
+	<< " (" << it->inputs[0]
+	<< ", " << it->inputs[1]
+	<< ", " << it->inputs[2] << ")\n";
+    return stream;
+  }
+
+  std::ostream&
+  operator<< (std::ostream& o, const MarkerSetProgram& program)
+  {
+    return program.print (o);
+  }
+
+} // end of namespace libmocap.
@@ -28,6 +28,7 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <algorithm>
+#include <iostream>
 #include <iterator>
 #include <stdexcept>
 
@@ -46,7 +47,8 @@ namespace libmocap
       markers_ (),
       links_ (),
       segments_ (),
-      poses_ ()
+      poses_ (),
+      markersIndex_ ()
   {}
 
   MarkerSet::MarkerSet (const MarkerSet& rhs)
@@ -54,12 +56,15 @@ namespace libmocap
       markers_ (),
       links_ (rhs.links_),
       segments_ (rhs.segments_),
-      poses_ (rhs.poses_)
+      poses_ (rhs.poses_),
+      markersIndex_ ()
   {
     std::vector<AbstractMarker*>::const_iterator it;
     for (it = rhs.markers_.begin (); it != rhs.markers_.end (); ++it)
       if (*it)
 	markers_.push_back ((*it)->clone ());
+    linkSegments ();
+    indexMarkers ();
   }
 
 
@@ -79,6 +84,9 @@ namespace libmocap
     name_ = rhs.name_;
 
     std::vector<AbstractMarker*>::const_iterator it;
+    for (it = markers_.begin (); it != markers_.end (); ++it)
+      delete *it;
+    markers_.clear ();
     for (it = rhs.markers_.begin (); it != rhs.markers_.end (); ++it)
       if (*it)
 	markers_.push_back ((*it)->clone ());
@@ -86,6 +94,8 @@ namespace libmocap
     links_ = rhs.links_;
     segments_ = rhs.segments_;
     poses_ = rhs.poses_;
+    linkSegments ();
+    indexMarkers ();
     return *this;
   }
 
@@ -126,20 +136,62 @@ namespace libmocap
   }
 
   const AbstractMarker&
-  MarkerSet::markerByName (const std::string name) const
+  MarkerSet::markerByName (const std::string& name) const
   {
-    std::vector<AbstractMarker*>::const_iterator it;
-    for (it = markers_.begin (); it != markers_.end (); ++it)
-      {
-	if (*it && (*it)->name () == name)
-	  return **it;
-      }
+    return *markers_[static_cast<std::size_t> (markerIndex (name))];
+  }
+
+  int
+  MarkerSet::markerIndex (const std::string& name) const
+  {
+    std::map<std::string, std::size_t>::const_iterator indexed =
+      markersIndex_.find (name);
+    if (indexed != markersIndex_.end ()
+	&& indexed->second < markers_.size ()
+	&& markers_[indexed->second]
+	&& markers_[indexed->second]->name () == name)
+      return static_cast<int> (indexed->second);
+
+    // The index is out of date, look for the marker directly.
+    for (std::size_t i = 0; i < markers_.size (); ++i)
+      if (markers_[i] && markers_[i]->name () == name)
+	return static_cast<int> (i);
 
     std::string error =
       "marker " + name + " does not exist";
     throw std::runtime_error (error);
   }
 
+  void
+  MarkerSet::indexMarkers ()
+  {
+    markersIndex_.clear ();
+    // Insertion keeps the first marker when names are duplicated,
+    // like the linear search.
+    for (std::size_t i = 0; i < markers_.size (); ++i)
+      if (markers_[i])
+	markersIndex_.insert (std::make_pair (markers_[i]->name (), i));
+  }
+
+  void
+  MarkerSet::linkSegments ()
+  {
+    std::vector<Segment>::iterator it;
+    for (it = segments_.begin (); it != segments_.end (); ++it)
+      it->children ().clear ();
+    for (it = segments_.begin (); it != segments_.end (); ++it)
+      if (it->parent () >= 0
+	  && it->parent () < static_cast<int> (segments_.size ()))
+	segments_[static_cast<std::size_t> (it->parent ())].children ()
+	  .push_back (&*it);
+  }
+
+  MarkerSetProgram
+  MarkerSet::compile () const
+  {
+    return MarkerSetProgram (*this);
+  }
+
   std::ostream&
   operator<< (std::ostream& o, const MarkerSet& markerSet)
   {
@@ -0,0 +1,100 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <vector>
+
+#include <libmocap/marker-trajectory-columns.hh>
+
+namespace libmocap
+{
+  MarkerTrajectoryColumns::MarkerTrajectoryColumns ()
+    : data_ ()
+  {}
+
+  MarkerTrajectoryColumns::MarkerTrajectoryColumns
+  (const MarkerTrajectory& trajectory)
+    : data_ ()
+  {
+    fromTrajectory (trajectory);
+  }
+
+  MarkerTrajectoryColumns::MarkerTrajectoryColumns
+  (const MarkerTrajectoryColumns& rhs)
+    : data_ (rhs.data_)
+  {}
+
+  MarkerTrajectoryColumns::~MarkerTrajectoryColumns ()
+  {}
+
+  MarkerTrajectoryColumns&
+  MarkerTrajectoryColumns::operator= (const MarkerTrajectoryColumns& rhs)
+  {
+    if (this == &rhs)
+      return *this;
+    data_ = rhs.data_;
+    return *this;
+  }
+
+  void
+  MarkerTrajectoryColumns::fromTrajectory (const MarkerTrajectory& trajectory)
+  {
+    if (trajectory.precision () == MarkerTrajectory::DOUBLE_PRECISION)
+      {
+	trajectory.positions ().transpose (data_);
+	return;
+      }
+
+    data_.resize (trajectory.numCols (), trajectory.numRows ());
+    for (std::size_t frame = 0; frame < trajectory.numRows (); ++frame)
+      for (std::size_t i = 0; i < trajectory.numCols (); ++i)
+	data_ (i, frame) = trajectory.position (frame, i);
+  }
+
+  void
+  MarkerTrajectoryColumns::toTrajectory (MarkerTrajectory& trajectory) const
+  {
+    // The trajectory keeps its storage precision.
+    if (trajectory.precision () == MarkerTrajectory::DOUBLE_PRECISION)
+      data_.transpose (trajectory.positions ());
+    else
+      {
+	trajectory.resize (data_.numCols (), data_.numRows ());
+	std::vector<double> row (data_.numRows ());
+	for (std::size_t frame = 0; frame < data_.numCols (); ++frame)
+	  {
+	    for (std::size_t i = 0; i < row.size (); ++i)
+	      row[i] = data_ (i, frame);
+	    trajectory.writeRow (frame, row.empty () ? 0 : &row[0]);
+	  }
+      }
+    trajectory.numFrames () = static_cast<int> (numFrames ());
+    trajectory.numMarkers () = static_cast<int> (numMarkers ());
+  }
+
+} // end of namespace libmocap.
@@ -30,12 +30,53 @@
 #include <fstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
+#include <libmocap/binary-marker-trajectory-reader.hh>
 #include <libmocap/marker-trajectory-factory.hh>
 
+#include "trajectory-cache.hh"
 #include "trc-marker-trajectory-factory.hh"
 
 namespace libmocap
 {
+  namespace
+  {
+    /// \brief Keep only the markers selected by the options.
+    void selectMarkers (MarkerTrajectory& trajectory,
+			const MarkerTrajectoryLoadOptions& options)
+    {
+      std::vector<std::size_t> indices;
+      options.markerIndices (indices, trajectory.markers ());
+
+      const PositionMatrix& source = trajectory.positions ();
+      PositionMatrix positions (source.numRows (), 1 + indices.size () * 3);
+      std::vector<std::string> markers;
+      for (std::size_t i = 0; i < indices.size (); ++i)
+	{
+	  if (1 + indices[i] * 3 + 3 > source.numCols ())
+	    throw std::runtime_error
+	      ("marker `" + trajectory.markers ()[indices[i]]
+	       + "' has no data column");
+	  markers.push_back (trajectory.markers ()[indices[i]]);
+	}
+
+      for (std::size_t frame = 0; frame < source.numRows (); ++frame)
+	{
+	  const double* from = source.row (frame).data ();
+	  double* to = positions.row (frame).data ();
+	  to[0] = from[0];
+	  for (std::size_t i = 0; i < indices.size (); ++i)
+	    for (std::size_t axis = 0; axis < 3; ++axis)
+	      to[1 + i * 3 + axis] = from[1 + indices[i] * 3 + axis];
+	}
+
+      trajectory.positions () = positions;
+      trajectory.markers () = markers;
+      trajectory.numMarkers () = static_cast<int> (markers.size ());
+      trajectory.indexMarkers ();
+    }
+  } // end of anonymous namespace.
+
   MarkerTrajectoryFactory::MarkerTrajectoryFactory ()
   {}
 
@@ -52,6 +93,13 @@ namespace libmocap
 
   MarkerTrajectory
   MarkerTrajectoryFactory::load (const std::string& filename)
+  {
+    return load (filename, MarkerTrajectoryLoadOptions ());
+  }
+
+  MarkerTrajectory
+  MarkerTrajectoryFactory::load
+  (const std::string& filename, const MarkerTrajectoryLoadOptions& options)
   {
     std::ifstream file (filename.c_str ());
     if (!file.good ())
@@ -63,7 +111,47 @@ namespace libmocap
     if (TrcMarkerTrajectoryFactory::canLoad (filename))
       {
 	TrcMarkerTrajectoryFactory factory;
-	return factory.load (filename);
+	// Cache entries always hold whole trajectories.
+	if (!options.cache () || options.partial ()
+	    || !options.markers ().empty () || options.singlePrecision ())
+	  return factory.load (filename, options);
+
+	TrajectoryCache cache (options.cacheDirectory (), options.cacheHash ());
+	MarkerTrajectory trajectory;
+	if (cache.load (filename, trajectory))
+	  return trajectory;
+	trajectory = factory.load (filename, options);
+	cache.store (filename, trajectory);
+	return trajectory;
+      }
+    if (BinaryMarkerTrajectoryReader::canLoad (filename))
+      {
+	BinaryMarkerTrajectoryReader reader (filename);
+	MarkerTrajectory trajectory;
+	if (!options.partial ())
+	  trajectory = reader.load ();
+	else
+	  {
+	    double firstTime = 0.;
+	    if (reader.numFrames ())
+	      {
+		std::vector<double> row (reader.numColumns ());
+		reader.readFrame (0, &row[0]);
+		firstTime = row[0];
+	      }
+	    int firstFrame;
+	    int numFrames;
+	    options.frameRange (firstFrame, numFrames,
+				reader.metadata ().numFrames (),
+				firstTime, reader.metadata ().dataRate ());
+	    trajectory = reader.load (static_cast<std::size_t> (firstFrame),
+				      static_cast<std::size_t> (numFrames));
+	  }
+	if (!options.markers ().empty ())
+	  selectMarkers (trajectory, options);
+	if (options.singlePrecision ())
+	  trajectory.setPrecision (MarkerTrajectory::SINGLE_PRECISION);
+	return trajectory;
       }
 
     std::string error;
@@ -0,0 +1,220 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <libmocap/marker-trajectory-load-options.hh>
+
+#include "trc-frame-index.hh"
+
+namespace libmocap
+{
+  static bool enabledByEnvironment (const char* variable)
+  {
+    const char* value = std::getenv (variable);
+    return value && *value && std::strcmp (value, "0") != 0;
+  }
+
+  static std::string cacheDirectoryFromEnvironment ()
+  {
+    const char* value = std::getenv ("LIBMOCAP_TRAJECTORY_CACHE_DIR");
+    return value ? value : "";
+  }
+
+  MarkerTrajectoryLoadOptions::MarkerTrajectoryLoadOptions ()
+    : memoryMapped_ (false),
+      numThreads_ (1),
+      cache_ (enabledByEnvironment ("LIBMOCAP_TRAJECTORY_CACHE")),
+      cacheDirectory_ (cacheDirectoryFromEnvironment ()),
+      cacheHash_ (enabledByEnvironment ("LIBMOCAP_TRAJECTORY_CACHE_HASH")),
+      firstFrame_ (0),
+      numFrames_ (-1),
+      startTime_ (-std::numeric_limits<double>::infinity ()),
+      endTime_ (std::numeric_limits<double>::infinity ()),
+      frameIndex_ (false),
+      frameIndexStride_ (TrcFrameIndex::defaultStride),
+      markers_ (),
+      singlePrecision_ (false)
+  {}
+
+  MarkerTrajectoryLoadOptions::MarkerTrajectoryLoadOptions
+  (const MarkerTrajectoryLoadOptions& rhs)
+    : memoryMapped_ (rhs.memoryMapped_),
+      numThreads_ (rhs.numThreads_),
+      cache_ (rhs.cache_),
+      cacheDirectory_ (rhs.cacheDirectory_),
+      cacheHash_ (rhs.cacheHash_),
+      firstFrame_ (rhs.firstFrame_),
+      numFrames_ (rhs.numFrames_),
+      startTime_ (rhs.startTime_),
+      endTime_ (rhs.endTime_),
+      frameIndex_ (rhs.frameIndex_),
+      frameIndexStride_ (rhs.frameIndexStride_),
+      markers_ (rhs.markers_),
+      singlePrecision_ (rhs.singlePrecision_)
+  {}
+
+  MarkerTrajectoryLoadOptions::~MarkerTrajectoryLoadOptions ()
+  {}
+
+  MarkerTrajectoryLoadOptions&
+  MarkerTrajectoryLoadOptions::operator=
+  (const MarkerTrajectoryLoadOptions& rhs)
+  {
+    if (this == &rhs)
+      return *this;
+    memoryMapped_ = rhs.memoryMapped_;
+    numThreads_ = rhs.numThreads_;
+    cache_ = rhs.cache_;
+    cacheDirectory_ = rhs.cacheDirectory_;
+    cacheHash_ = rhs.cacheHash_;
+    firstFrame_ = rhs.firstFrame_;
+    numFrames_ = rhs.numFrames_;
+    startTime_ = rhs.startTime_;
+    endTime_ = rhs.endTime_;
+    frameIndex_ = rhs.frameIndex_;
+    frameIndexStride_ = rhs.frameIndexStride_;
+    markers_ = rhs.markers_;
+    singlePrecision_ = rhs.singlePrecision_;
+    return *this;
+  }
+
+  bool
+  MarkerTrajectoryLoadOptions::partial () const
+  {
+    return firstFrame () != 0 || numFrames () >= 0
+      || startTime () > -std::numeric_limits<double>::infinity ()
+      || endTime () < std::numeric_limits<double>::infinity ();
+  }
+
+  void
+  MarkerTrajectoryLoadOptions::frameRange
+  (int& first, int& count,
+   int fileNumFrames, double firstTime, double dataRate) const
+  {
+    if (firstFrame () < 0)
+      throw std::runtime_error ("invalid first frame");
+    if (firstFrame () > 0 && firstFrame () >= fileNumFrames)
+      throw std::runtime_error ("first frame is out of range");
+    if (startTime () > endTime ())
+      throw std::runtime_error ("invalid time range");
+
+    // The last frame is excluded, computations are done in double
+    // precision to avoid overflows.
+    double begin = firstFrame ();
+    double end = fileNumFrames;
+    if (numFrames () >= 0)
+      end = std::min (end, begin + numFrames ());
+
+    if (startTime () > -std::numeric_limits<double>::infinity ()
+	|| endTime () < std::numeric_limits<double>::infinity ())
+      {
+	if (!(dataRate > 0.))
+	  throw std::runtime_error
+	    ("a time range requires a positive data rate");
+
+	// Tolerate the rounding of the file time column.
+	static const double epsilon = 1e-6;
+	begin = std::max
+	  (begin, std::ceil ((startTime () - firstTime) * dataRate - epsilon));
+	end = std::min
+	  (end, std::floor ((endTime () - firstTime) * dataRate + epsilon) + 1.);
+      }
+
+    first = static_cast<int>
+      (std::min (begin, static_cast<double> (fileNumFrames)));
+    count = end > begin ? static_cast<int> (end - begin) : 0;
+  }
+
+  void
+  MarkerTrajectoryLoadOptions::markerIndices
+  (std::vector<std::size_t>& indices,
+   const std::vector<std::string>& fileMarkers) const
+  {
+    indices.clear ();
+    if (markers ().empty ())
+      {
+	for (std::size_t i = 0; i < fileMarkers.size (); ++i)
+	  indices.push_back (i);
+	return;
+      }
+
+    std::vector<std::string>::const_iterator it;
+    std::size_t index;
+    for (std::size_t i = 0; i < markers ().size (); ++i)
+      {
+	it = std::find (fileMarkers.begin (), fileMarkers.end (), markers ()[i]);
+	if (it == fileMarkers.end ())
+	  throw std::runtime_error ("unknown marker `" + markers ()[i] + "'");
+	index = static_cast<std::size_t> (it - fileMarkers.begin ());
+	if (std::find (indices.begin (), indices.end (), index)
+	    != indices.end ())
+	  throw std::runtime_error
+	    ("marker `" + markers ()[i] + "' is selected twice");
+	indices.push_back (index);
+      }
+  }
+
+  std::ostream&
+  MarkerTrajectoryLoadOptions::print (std::ostream& stream) const
+  {
+    stream
+      << "marker trajectory load options:\n"
+      << "memory mapped: " << (memoryMapped () ? "yes" : "no") << '\n'
+      << "num threads: " << numThreads () << '\n'
+      << "cache: " << (cache () ? "yes" : "no") << '\n'
+      << "cache directory: " << cacheDirectory () << '\n'
+      << "cache hash: " << (cacheHash () ? "yes" : "no") << '\n'
+      << "first frame: " << firstFrame () << '\n'
+      << "num frames: " << numFrames () << '\n'
+      << "start time: " << startTime () << '\n'
+      << "end time: " << endTime () << '\n'
+      << "frame index: " << (frameIndex () ? "yes" : "no") << '\n'
+      << "frame index stride: " << frameIndexStride () << '\n'
+      << "markers:";
+    for (std::size_t i = 0; i < markers ().size (); ++i)
+      stream << ' ' << markers ()[i];
+    stream
+      << '\n'
+      << "single precision: " << (singlePrecision () ? "yes" : "no");
+    return stream;
+  }
+
+  std::ostream&
+  operator<< (std::ostream& o, const MarkerTrajectoryLoadOptions& options)
+  {
+    return options.print (o);
+  }
+
+} // end of namespace libmocap.
@@ -0,0 +1,188 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <fstream>
+#include <stdexcept>
+
+#include <libmocap/marker-trajectory-reader.hh>
+
+#include "trc-frame-index.hh"
+#include "trc-marker-trajectory-factory.hh"
+
+namespace libmocap
+{
+  MarkerTrajectoryReader::MarkerTrajectoryReader (const std::string& filename)
+    : filename_ (filename),
+      sidecarIndex_ (false),
+      indexStride_ (TrcFrameIndex::defaultStride),
+      file_ (0),
+      dataOffset_ (0),
+      index_ (0),
+      metadata_ (),
+      line_ ()
+  {
+    open ();
+  }
+
+  MarkerTrajectoryReader::MarkerTrajectoryReader
+  (const std::string& filename, const MarkerTrajectoryLoadOptions& options)
+    : filename_ (filename),
+      sidecarIndex_ (options.frameIndex ()),
+      indexStride_ (options.frameIndexStride ()),
+      file_ (0),
+      dataOffset_ (0),
+      index_ (0),
+      metadata_ (),
+      line_ ()
+  {
+    open ();
+  }
+
+  void
+  MarkerTrajectoryReader::open ()
+  {
+    if (!TrcMarkerTrajectoryFactory::canLoad (filename_))
+      throw std::runtime_error
+	("failed to read `" + filename_ + "': file format not supported");
+
+    file_ = new std::ifstream (filename_.c_str ());
+    try
+      {
+	if (!file_->good ())
+	  throw std::runtime_error ("cannot open file `" + filename_ + "'");
+	file_->exceptions (std::ifstream::failbit | std::ifstream::badbit);
+
+	TrcMarkerTrajectoryFactory factory;
+	factory.loadHeader (*file_, metadata_);
+	factory.loadColumns (*file_, metadata_);
+	dataOffset_ = file_->tellg ();
+
+	// End of file is checked explicitly while streaming data.
+	file_->exceptions (std::ifstream::badbit);
+      }
+    catch (...)
+      {
+	delete file_;
+	throw;
+      }
+  }
+
+  MarkerTrajectoryReader::~MarkerTrajectoryReader ()
+  {
+    delete index_;
+    delete file_;
+  }
+
+  std::size_t
+  MarkerTrajectoryReader::numColumns () const
+  {
+    return 1 + 3 * static_cast<std::size_t> (metadata_.numMarkers ());
+  }
+
+  bool
+  MarkerTrajectoryReader::readFrame (double* row, int* frameId)
+  {
+    return readFrames (row, 1, frameId) == 1;
+  }
+
+  std::size_t
+  MarkerTrajectoryReader::readFrames
+  (double* rows, std::size_t maxFrames, int* frameIds)
+  {
+    std::size_t numFrames = 0;
+    int frameId;
+    const char* first;
+    const char* last;
+    const char* values;
+
+    while (numFrames < maxFrames && std::getline (*file_, line_))
+      {
+	first = line_.data ();
+	last = TrcMarkerTrajectoryFactory::stripEndOfLine
+	  (first, first + line_.size ());
+
+	values = TrcMarkerTrajectoryFactory::loadFrameId (first, last, frameId);
+
+	// skip empty lines
+	if (!values)
+	  continue;
+
+	TrcMarkerTrajectoryFactory::loadValues
+	  (values, last, rows + numFrames * numColumns (), numColumns ());
+	if (frameIds)
+	  frameIds[numFrames] = frameId;
+	++numFrames;
+      }
+    return numFrames;
+  }
+
+  void
+  MarkerTrajectoryReader::seek (std::size_t frameId)
+  {
+    if (!index_)
+      {
+	TrcFrameIndex* index = new TrcFrameIndex (indexStride_);
+	try
+	  {
+	    index->open (filename_, static_cast<std::size_t> (dataOffset_),
+			 sidecarIndex_);
+	  }
+	catch (...)
+	  {
+	    delete index;
+	    throw;
+	  }
+	index_ = index;
+      }
+
+    file_->clear ();
+    if (frameId >= index_->numRows ())
+      {
+	file_->seekg (0, std::ios::end);
+	return;
+      }
+    file_->seekg (static_cast<std::streamoff> (index_->offset (frameId)));
+
+    // Skip the rows following the indexed one.
+    std::size_t numRows = frameId % index_->stride ();
+    while (numRows && std::getline (*file_, line_))
+      if (!TrcMarkerTrajectoryFactory::isEmptyRow
+	  (line_.data (), line_.data () + line_.size ()))
+	--numRows;
+  }
+
+  std::size_t
+  MarkerTrajectoryReader::readFrames
+  (std::size_t firstFrame, std::size_t maxFrames, double* rows, int* frameIds)
+  {
+    seek (firstFrame);
+    return readFrames (rows, maxFrames, frameIds);
+  }
+
+} // end of namespace libmocap.
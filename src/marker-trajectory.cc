@@ -27,6 +27,7 @@
 // THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #include <stdexcept>
@@ -44,8 +45,14 @@ namespace libmocap
       origDataRate_ (),
       origDataStartFrame_ (),
       origNumFrames_ (),
+      firstFrame_ (),
       markers_ (),
-      positions_ ()
+      positions_ (),
+      precision_ (DOUBLE_PRECISION),
+      times_ (),
+      singlePositions_ (),
+      singleNumCols_ (),
+      markersIndex_ ()
   {
   }
 
@@ -59,8 +66,14 @@ namespace libmocap
       origDataRate_ (rhs.origDataRate_),
       origDataStartFrame_ (rhs.origDataStartFrame_),
       origNumFrames_ (rhs.origNumFrames_),
+      firstFrame_ (rhs.firstFrame_),
       markers_ (rhs.markers_),
-      positions_ (rhs.positions_)
+      positions_ (rhs.positions_),
+      precision_ (rhs.precision_),
+      times_ (rhs.times_),
+      singlePositions_ (rhs.singlePositions_),
+      singleNumCols_ (rhs.singleNumCols_),
+      markersIndex_ (rhs.markersIndex_)
   {
   }
 
@@ -82,11 +95,187 @@ namespace libmocap
     origDataRate_ = rhs.origDataRate_;
     origDataStartFrame_ = rhs.origDataStartFrame_;
     origNumFrames_ = rhs.origNumFrames_;
+    firstFrame_ = rhs.firstFrame_;
     markers_ = rhs.markers_;
     positions_ = rhs.positions_;
+    precision_ = rhs.precision_;
+    times_ = rhs.times_;
+    singlePositions_ = rhs.singlePositions_;
+    singleNumCols_ = rhs.singleNumCols_;
+    markersIndex_ = rhs.markersIndex_;
     return *this;
   }
 
+  void
+  MarkerTrajectory::setPrecision (Precision precision)
+  {
+    if (precision == precision_)
+      return;
+
+    std::size_t rows = numRows ();
+    std::size_t cols = numCols ();
+    if (precision == SINGLE_PRECISION)
+      {
+	const std::size_t stride = cols ? cols - 1 : 0;
+	std::vector<double> times (rows);
+	std::vector<float> singlePositions (rows * stride);
+	for (std::size_t frame = 0; frame < rows; ++frame)
+	  {
+	    const double* data = positions_.row (frame).data ();
+	    times[frame] = data[0];
+	    for (std::size_t i = 0; i < stride; ++i)
+	      singlePositions[frame * stride + i] =
+		static_cast<float> (data[i + 1]);
+	  }
+	positions_.clear ();
+	times_.swap (times);
+	singlePositions_.swap (singlePositions);
+	singleNumCols_ = cols;
+      }
+    else
+      {
+	PositionMatrix positions (rows, cols);
+	for (std::size_t frame = 0; frame < rows; ++frame)
+	  readRow (frame, positions.row (frame).data ());
+	positions_.swap (positions);
+	std::vector<double> ().swap (times_);
+	std::vector<float> ().swap (singlePositions_);
+	singleNumCols_ = 0;
+      }
+    precision_ = precision;
+  }
+
+  void
+  MarkerTrajectory::resize (std::size_t numRows, std::size_t numCols)
+  {
+    if (precision_ == DOUBLE_PRECISION)
+      {
+	positions_.resize (numRows, numCols);
+	return;
+      }
+    std::vector<double> (numRows).swap (times_);
+    std::vector<float> (numRows * (numCols ? numCols - 1 : 0))
+      .swap (singlePositions_);
+    singleNumCols_ = numCols;
+  }
+
+  std::size_t
+  MarkerTrajectory::numRows () const
+  {
+    if (precision_ == DOUBLE_PRECISION)
+      return positions_.numRows ();
+    return times_.size ();
+  }
+
+  std::size_t
+  MarkerTrajectory::numCols () const
+  {
+    if (precision_ == DOUBLE_PRECISION)
+      return positions_.numCols ();
+    return singleNumCols_;
+  }
+
+  void
+  MarkerTrajectory::readRow (std::size_t frame, double* row) const
+  {
+    if (precision_ == DOUBLE_PRECISION)
+      {
+	const double* data = positions_.row (frame).data ();
+	std::copy (data, data + positions_.numCols (), row);
+	return;
+      }
+    if (!singleNumCols_)
+      return;
+    const float* data = singlePositions_.empty ()
+      ? 0 : &singlePositions_[frame * (singleNumCols_ - 1)];
+    row[0] = times_[frame];
+    for (std::size_t i = 1; i < singleNumCols_; ++i)
+      row[i] = data[i - 1];
+  }
+
+  void
+  MarkerTrajectory::writeRow (std::size_t frame, const double* row)
+  {
+    if (precision_ == DOUBLE_PRECISION)
+      {
+	std::copy (row, row + positions_.numCols (),
+		   positions_.row (frame).data ());
+	return;
+      }
+    if (!singleNumCols_)
+      return;
+    float* data = singlePositions_.empty ()
+      ? 0 : &singlePositions_[frame * (singleNumCols_ - 1)];
+    times_[frame] = row[0];
+    for (std::size_t i = 1; i < singleNumCols_; ++i)
+      data[i - 1] = static_cast<float> (row[i]);
+  }
+
+  const float*
+  MarkerTrajectory::singlePrecisionData () const
+  {
+    if (singlePositions_.empty ())
+      return 0;
+    return &singlePositions_[0];
+  }
+
+  float*
+  MarkerTrajectory::singlePrecisionData ()
+  {
+    if (singlePositions_.empty ())
+      return 0;
+    return &singlePositions_[0];
+  }
+
+  int
+  MarkerTrajectory::markerIndex (const std::string& name) const
+  {
+    std::map<std::string, std::size_t>::const_iterator indexed =
+      markersIndex_.find (name);
+    if (indexed != markersIndex_.end ()
+	&& indexed->second < markers_.size ()
+	&& markers_[indexed->second] == name)
+      return static_cast<int> (indexed->second);
+
+    // The index is out of date, look for the marker directly.
+    for (std::size_t i = 0; i < markers_.size (); ++i)
+      if (markers_[i] == name)
+	return static_cast<int> (i);
+
+    std::string error =
+      "marker " + name + " does not exist";
+    throw std::runtime_error (error);
+  }
+
+  int
+  MarkerTrajectory::markerIndex (const std::string& name, int id) const
+  {
+    if (markers_.empty ()
+	|| (id >= 0 && static_cast<std::size_t> (id) < markers_.size ()
+	    && markers_[static_cast<std::size_t> (id)] == name))
+      return id;
+
+    try
+      {
+	return markerIndex (name);
+      }
+    catch (const std::runtime_error&)
+      {
+	std::string error =
+	  "marker " + name + " is not defined by trajectory `"
+	  + filename () + "'";
+	throw std::runtime_error (error);
+      }
+  }
+
+  void
+  MarkerTrajectory::indexMarkers ()
+  {
+    markersIndex_.clear ();
+    for (std::size_t i = 0; i < markers_.size (); ++i)
+      markersIndex_.insert (std::make_pair (markers_[i], i));
+  }
+
   void
   MarkerTrajectory::normalize ()
   {
@@ -98,17 +287,22 @@ namespace libmocap
     else
       throw std::runtime_error ("unit not supported");
 
-    std::vector<std::vector<double> >::iterator itFrame;
-    std::vector<double>::iterator itValue;
-    for (itFrame = positions ().begin ();
-	 itFrame != positions ().end (); ++itFrame)
+    // pass first column which does not have to be scaled (time)
+    if (precision_ == SINGLE_PRECISION)
+      {
+	std::vector<float>::iterator it = singlePositions_.begin ();
+	for (; it != singlePositions_.end (); ++it)
+	  *it = static_cast<float> (*it * scalingFactor);
+      }
+    else
       {
-	// pass first elements which does not have to be scaled (time)
-	itValue = itFrame->begin ();
-	if (itValue == itFrame->end ())
-	  continue;
-	for (++itValue; itValue != itFrame->end (); ++itValue)
-	  *itValue = *itValue * scalingFactor;
+	double* row;
+	for (std::size_t frame = 0; frame < positions ().numRows (); ++frame)
+	  {
+	    row = positions ().row (frame).data ();
+	    for (std::size_t i = 1; i < positions ().numCols (); ++i)
+	      row[i] *= scalingFactor;
+	  }
       }
 
     units () = "m";
@@ -127,20 +321,20 @@ namespace libmocap
       << "origDataRate: " << origDataRate () << '\n'
       << "origDataStartFrame: " << origDataStartFrame () << '\n'
       << "origNumFrames: " << origNumFrames () << '\n'
+      << "first frame: " << firstFrame () << '\n'
       << "markers: ";
     std::copy
       (markers ().begin (), markers ().end (),
        std::ostream_iterator<std::string>(o, "\n"));
     o << '\n'
       << "positions: \n";
-    for (std::size_t frame = 0; frame < positions ().size (); ++frame)
+    for (std::size_t frame = 0; frame < numRows (); ++frame)
       {
-	if (positions ()[frame].empty ())
+	if (!numCols ())
 	  o << "(empty vector)";
 	else
-	  std::copy
-	    (positions ()[frame].begin (), positions ()[frame].end (),
-	     std::ostream_iterator<double>(o, ", "));
+	  for (std::size_t i = 0; i < numCols (); ++i)
+	    o << position (frame, i) << ", ";
 	o << '\n';
       }
     return o;
@@ -75,19 +75,22 @@ namespace libmocap
    int frameId) const
   {
     std::size_t frameId_ = static_cast<std::size_t> (frameId);
-    std::size_t id_ = static_cast<std::size_t> (id ());
 
     if (frameId < 0)
       throw std::runtime_error ("negative frame id");
-    if (frameId >= static_cast<int> (trajectory.positions ().size ()))
+    if (frameId >= static_cast<int> (trajectory.numRows ()))
       throw std::runtime_error ("frame id is too large");
-    if (id () < 0 ||
-	id () >= static_cast<int> (trajectory.positions ()[frameId_].size ()))
+    if (id () < 0)
       throw std::runtime_error ("marker id is inconsistent");
 
-    position[0] = trajectory.positions ()[frameId_][1 + id_ * 3 + 0];
-    position[1] = trajectory.positions ()[frameId_][1 + id_ * 3 + 1];
-    position[2] = trajectory.positions ()[frameId_][1 + id_ * 3 + 2];
+    std::size_t id_ =
+      static_cast<std::size_t> (trajectory.markerIndex (name (), id ()));
+    if (1 + id_ * 3 + 2 >= trajectory.numCols ())
+      throw std::runtime_error ("marker id is inconsistent");
+
+    position[0] = trajectory.position (frameId_, 1 + id_ * 3);
+    position[1] = trajectory.position (frameId_, 2 + id_ * 3);
+    position[2] = trajectory.position (frameId_, 3 + id_ * 3);
   }
 
   std::ostream&
@@ -238,6 +238,19 @@ namespace libmocap
 	    throw std::runtime_error (error);
 	  }
       }
+    result.indexMarkers ();
+
+    // Check markers dependencies once, so that errors are reported
+    // when loading the file rather than when evaluating markers.
+    try
+      {
+	result.compile ();
+      }
+    catch (const std::runtime_error& e)
+      {
+	throw std::runtime_error
+	  ("failed to load `" + filename + "': " + e.what ());
+      }
     return result;
   }
 
@@ -547,11 +560,15 @@ namespace libmocap
 	       getColorFromPalette (convert<std::size_t> ((*itLine)[1]));
 	     linkage.type () = Link::LINK_UNKNOWN;
 
-	     std::istringstream ss ((*itLine)[3]);
-	     int marker1, marker2;
-	     ss >> marker1 >> marker2;
-	     linkage.marker1 () = marker1 - 1;
-	     linkage.marker2 () = marker2 - 1;
+	     // Both markers are stored in the same field.
+	     const std::string& markers = (*itLine)[3];
+	     std::string::size_type separator =
+	       markers.find_first_of (" \t", markers.find_first_not_of (" \t"));
+	     if (separator == std::string::npos)
+	       throw std::runtime_error ("invalid link markers `"
+					 + markers + "'");
+	     linkage.marker1 () = convert<int> (markers.substr (0, separator)) - 1;
+	     linkage.marker2 () = convert<int> (markers.substr (separator)) - 1;
 	     linkage.minLength () = convert<double> ((*itLine)[4]);
 	     linkage.maxLength () = convert<double> ((*itLine)[5]);
 	     linkage.extraStretch () = convert<double> ((*itLine)[6]);
@@ -620,19 +637,21 @@ namespace libmocap
 	    segment.id () = convert<int> ((*itLine)[0]) - 1;
 	    segment.name () = (*itLine)[1];
 	    trimWhitespace (segment.name ());
-	    // FIXME: load parent?
+	    // Segment 0 is the root, i.e. no parent.
+	    segment.parent () = convert<int> ((*itLine)[2]) - 1;
 	    segment.originMarker () = convert<int> ((*itLine)[3]) - 1;
 	    segment.longAxisMarker () = convert<int> ((*itLine)[4]) - 1;
 	    segment.planeAxisMarker () = convert<int> ((*itLine)[5]) - 1;
 	    segment.rotationOffset ().roll () =
 	      convert<double> ((*itLine)[6]) * M_PI / 180.;
 	    segment.rotationOffset ().pitch () =
-	      convert<double> ((*itLine)[6]) * M_PI / 180.;
+	      convert<double> ((*itLine)[7]) * M_PI / 180.;
 	    segment.rotationOffset ().yaw () =
-	      convert<double> ((*itLine)[6]) * M_PI / 180.;
+	      convert<double> ((*itLine)[8]) * M_PI / 180.;
 
 	    markerSet.segments ().push_back (segment);
 	  }
+	markerSet.linkSegments ();
 
 	if (!file.eof () && file.peek () != '[' && !file.eof ())
 	  loadSection (segmentsVariableMapper, markerSet, file);
@@ -28,40 +28,345 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cmath>
+#include <cstdlib>
+#include <string>
+
 #include "math.hh"
 
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+# define LIBMOCAP_X86_KERNELS
+# include <immintrin.h>
+#endif
+
+// Batched vector primitives.
+//
+// The SIMD variants perform the same operations in the same order as
+// the scalar ones, without fused multiply-add, so that all variants
+// are bitwise identical. They are compiled with target attributes and
+// only called when the CPU supports the matching instruction set.
+
 namespace libmocap
 {
-  void cross (double result[3], const double lhs[3], const double rhs[3])
+  namespace
   {
-    result[0] = lhs[1] * rhs[2] - lhs[2] * rhs[1];
-    result[1] = lhs[2] * rhs[0] - lhs[0] * rhs[2];
-    result[2] = lhs[0] * rhs[1] - lhs[1] * rhs[0];
-  }
+    struct MathKernels
+    {
+      const char* name;
+      void (*cross) (std::size_t, std::size_t,
+		     double*, const double*, const double*);
+      void (*normalize) (std::size_t, std::size_t, double*);
+      void (*dot_prod) (std::size_t, std::size_t,
+			double*, const double*, const double*);
+      void (*proj) (std::size_t, std::size_t,
+		    double*, const double*, const double*);
+    };
+
+    // Scalar implementation.
+
+    void
+    crossScalar (std::size_t n, std::size_t stride,
+		 double* result, const double* lhs, const double* rhs)
+    {
+      for (std::size_t k = 0; k < n; ++k)
+	{
+	  double l[3] = {lhs[k], lhs[stride + k], lhs[2 * stride + k]};
+	  double r[3] = {rhs[k], rhs[stride + k], rhs[2 * stride + k]};
+	  double c[3];
+	  cross (c, l, r);
+	  result[k] = c[0];
+	  result[stride + k] = c[1];
+	  result[2 * stride + k] = c[2];
+	}
+    }
+
+    void
+    normalizeScalar (std::size_t n, std::size_t stride, double* v)
+    {
+      for (std::size_t k = 0; k < n; ++k)
+	{
+	  double u[3] = {v[k], v[stride + k], v[2 * stride + k]};
+	  normalize (u);
+	  v[k] = u[0];
+	  v[stride + k] = u[1];
+	  v[2 * stride + k] = u[2];
+	}
+    }
+
+    void
+    dotProdScalar (std::size_t n, std::size_t stride,
+		   double* result, const double* lhs, const double* rhs)
+    {
+      for (std::size_t k = 0; k < n; ++k)
+	{
+	  double l[3] = {lhs[k], lhs[stride + k], lhs[2 * stride + k]};
+	  double r[3] = {rhs[k], rhs[stride + k], rhs[2 * stride + k]};
+	  dot_prod (result[k], l, r);
+	}
+    }
+
+    void
+    projScalar (std::size_t n, std::size_t stride,
+		double* result, const double* lhs, const double* rhs)
+    {
+      for (std::size_t k = 0; k < n; ++k)
+	{
+	  double l[3] = {lhs[k], lhs[stride + k], lhs[2 * stride + k]};
+	  double r[3] = {rhs[k], rhs[stride + k], rhs[2 * stride + k]};
+	  double p[3];
+	  proj (p, l, r);
+	  result[k] = p[0];
+	  result[stride + k] = p[1];
+	  result[2 * stride + k] = p[2];
+	}
+    }
+
+    const MathKernels scalarKernels =
+      {"scalar", crossScalar, normalizeScalar, dotProdScalar, projScalar};
+
+#ifdef LIBMOCAP_X86_KERNELS
+    // SSE2 implementation, two vectors at a time.
+
+    __attribute__ ((target ("sse2"))) void
+    crossSse2 (std::size_t n, std::size_t stride,
+	       double* result, const double* lhs, const double* rhs)
+    {
+      std::size_t k = 0;
+      for (; k + 2 <= n; k += 2)
+	{
+	  __m128d lx = _mm_loadu_pd (lhs + k);
+	  __m128d ly = _mm_loadu_pd (lhs + stride + k);
+	  __m128d lz = _mm_loadu_pd (lhs + 2 * stride + k);
+	  __m128d rx = _mm_loadu_pd (rhs + k);
+	  __m128d ry = _mm_loadu_pd (rhs + stride + k);
+	  __m128d rz = _mm_loadu_pd (rhs + 2 * stride + k);
+	  _mm_storeu_pd (result + k,
+			 _mm_sub_pd (_mm_mul_pd (ly, rz), _mm_mul_pd (lz, ry)));
+	  _mm_storeu_pd (result + stride + k,
+			 _mm_sub_pd (_mm_mul_pd (lz, rx), _mm_mul_pd (lx, rz)));
+	  _mm_storeu_pd (result + 2 * stride + k,
+			 _mm_sub_pd (_mm_mul_pd (lx, ry), _mm_mul_pd (ly, rx)));
+	}
+      crossScalar (n - k, stride, result + k, lhs + k, rhs + k);
+    }
+
+    __attribute__ ((target ("sse2"))) inline __m128d
+    dotSse2 (__m128d lx, __m128d ly, __m128d lz,
+	     __m128d rx, __m128d ry, __m128d rz)
+    {
+      return _mm_add_pd (_mm_add_pd (_mm_mul_pd (lx, rx),
+				     _mm_mul_pd (ly, ry)),
+			 _mm_mul_pd (lz, rz));
+    }
+
+    __attribute__ ((target ("sse2"))) void
+    normalizeSse2 (std::size_t n, std::size_t stride, double* v)
+    {
+      std::size_t k = 0;
+      for (; k + 2 <= n; k += 2)
+	{
+	  __m128d x = _mm_loadu_pd (v + k);
+	  __m128d y = _mm_loadu_pd (v + stride + k);
+	  __m128d z = _mm_loadu_pd (v + 2 * stride + k);
+	  __m128d norm = _mm_sqrt_pd (dotSse2 (x, y, z, x, y, z));
+	  _mm_storeu_pd (v + k, _mm_div_pd (x, norm));
+	  _mm_storeu_pd (v + stride + k, _mm_div_pd (y, norm));
+	  _mm_storeu_pd (v + 2 * stride + k, _mm_div_pd (z, norm));
+	}
+      normalizeScalar (n - k, stride, v + k);
+    }
+
+    __attribute__ ((target ("sse2"))) void
+    dotProdSse2 (std::size_t n, std::size_t stride,
+		 double* result, const double* lhs, const double* rhs)
+    {
+      std::size_t k = 0;
+      for (; k + 2 <= n; k += 2)
+	_mm_storeu_pd
+	  (result + k,
+	   dotSse2 (_mm_loadu_pd (lhs + k),
+		    _mm_loadu_pd (lhs + stride + k),
+		    _mm_loadu_pd (lhs + 2 * stride + k),
+		    _mm_loadu_pd (rhs + k),
+		    _mm_loadu_pd (rhs + stride + k),
+		    _mm_loadu_pd (rhs + 2 * stride + k)));
+      dotProdScalar (n - k, stride, result + k, lhs + k, rhs + k);
+    }
 
-  void normalize (double v[3])
+    __attribute__ ((target ("sse2"))) void
+    projSse2 (std::size_t n, std::size_t stride,
+	      double* result, const double* lhs, const double* rhs)
+    {
+      std::size_t k = 0;
+      for (; k + 2 <= n; k += 2)
+	{
+	  __m128d lx = _mm_loadu_pd (lhs + k);
+	  __m128d ly = _mm_loadu_pd (lhs + stride + k);
+	  __m128d lz = _mm_loadu_pd (lhs + 2 * stride + k);
+	  __m128d rx = _mm_loadu_pd (rhs + k);
+	  __m128d ry = _mm_loadu_pd (rhs + stride + k);
+	  __m128d rz = _mm_loadu_pd (rhs + 2 * stride + k);
+	  __m128d ratio = _mm_div_pd (dotSse2 (lx, ly, lz, rx, ry, rz),
+				      dotSse2 (lx, ly, lz, lx, ly, lz));
+	  _mm_storeu_pd (result + k, _mm_mul_pd (ratio, lx));
+	  _mm_storeu_pd (result + stride + k, _mm_mul_pd (ratio, ly));
+	  _mm_storeu_pd (result + 2 * stride + k, _mm_mul_pd (ratio, lz));
+	}
+      projScalar (n - k, stride, result + k, lhs + k, rhs + k);
+    }
+
+    const MathKernels sse2Kernels =
+      {"sse2", crossSse2, normalizeSse2, dotProdSse2, projSse2};
+
+    // AVX2 implementation, four vectors at a time.
+
+    __attribute__ ((target ("avx2"))) void
+    crossAvx2 (std::size_t n, std::size_t stride,
+	       double* result, const double* lhs, const double* rhs)
+    {
+      std::size_t k = 0;
+      for (; k + 4 <= n; k += 4)
+	{
+	  __m256d lx = _mm256_loadu_pd (lhs + k);
+	  __m256d ly = _mm256_loadu_pd (lhs + stride + k);
+	  __m256d lz = _mm256_loadu_pd (lhs + 2 * stride + k);
+	  __m256d rx = _mm256_loadu_pd (rhs + k);
+	  __m256d ry = _mm256_loadu_pd (rhs + stride + k);
+	  __m256d rz = _mm256_loadu_pd (rhs + 2 * stride + k);
+	  _mm256_storeu_pd
+	    (result + k,
+	     _mm256_sub_pd (_mm256_mul_pd (ly, rz), _mm256_mul_pd (lz, ry)));
+	  _mm256_storeu_pd
+	    (result + stride + k,
+	     _mm256_sub_pd (_mm256_mul_pd (lz, rx), _mm256_mul_pd (lx, rz)));
+	  _mm256_storeu_pd
+	    (result + 2 * stride + k,
+	     _mm256_sub_pd (_mm256_mul_pd (lx, ry), _mm256_mul_pd (ly, rx)));
+	}
+      crossScalar (n - k, stride, result + k, lhs + k, rhs + k);
+    }
+
+    __attribute__ ((target ("avx2"))) inline __m256d
+    dotAvx2 (__m256d lx, __m256d ly, __m256d lz,
+	     __m256d rx, __m256d ry, __m256d rz)
+    {
+      return _mm256_add_pd (_mm256_add_pd (_mm256_mul_pd (lx, rx),
+					   _mm256_mul_pd (ly, ry)),
+			    _mm256_mul_pd (lz, rz));
+    }
+
+    __attribute__ ((target ("avx2"))) void
+    normalizeAvx2 (std::size_t n, std::size_t stride, double* v)
+    {
+      std::size_t k = 0;
+      for (; k + 4 <= n; k += 4)
+	{
+	  __m256d x = _mm256_loadu_pd (v + k);
+	  __m256d y = _mm256_loadu_pd (v + stride + k);
+	  __m256d z = _mm256_loadu_pd (v + 2 * stride + k);
+	  __m256d norm = _mm256_sqrt_pd (dotAvx2 (x, y, z, x, y, z));
+	  _mm256_storeu_pd (v + k, _mm256_div_pd (x, norm));
+	  _mm256_storeu_pd (v + stride + k, _mm256_div_pd (y, norm));
+	  _mm256_storeu_pd (v + 2 * stride + k, _mm256_div_pd (z, norm));
+	}
+      normalizeScalar (n - k, stride, v + k);
+    }
+
+    __attribute__ ((target ("avx2"))) void
+    dotProdAvx2 (std::size_t n, std::size_t stride,
+		 double* result, const double* lhs, const double* rhs)
+    {
+      std::size_t k = 0;
+      for (; k + 4 <= n; k += 4)
+	_mm256_storeu_pd
+	  (result + k,
+	   dotAvx2 (_mm256_loadu_pd (lhs + k),
+		    _mm256_loadu_pd (lhs + stride + k),
+		    _mm256_loadu_pd (lhs + 2 * stride + k),
+		    _mm256_loadu_pd (rhs + k),
+		    _mm256_loadu_pd (rhs + stride + k),
+		    _mm256_loadu_pd (rhs + 2 * stride + k)));
+      dotProdScalar (n - k, stride, result + k, lhs + k, rhs + k);
+    }
+
+    __attribute__ ((target ("avx2"))) void
+    projAvx2 (std::size_t n, std::size_t stride,
+	      double* result, const double* lhs, const double* rhs)
+    {
+      std::size_t k = 0;
+      for (; k + 4 <= n; k += 4)
+	{
+	  __m256d lx = _mm256_loadu_pd (lhs + k);
+	  __m256d ly = _mm256_loadu_pd (lhs + stride + k);
+	  __m256d lz = _mm256_loadu_pd (lhs + 2 * stride + k);
+	  __m256d rx = _mm256_loadu_pd (rhs + k);
+	  __m256d ry = _mm256_loadu_pd (rhs + stride + k);
+	  __m256d rz = _mm256_loadu_pd (rhs + 2 * stride + k);
+	  __m256d ratio = _mm256_div_pd (dotAvx2 (lx, ly, lz, rx, ry, rz),
+					 dotAvx2 (lx, ly, lz, lx, ly, lz));
+	  _mm256_storeu_pd (result + k, _mm256_mul_pd (ratio, lx));
+	  _mm256_storeu_pd (result + stride + k, _mm256_mul_pd (ratio, ly));
+	  _mm256_storeu_pd (result + 2 * stride + k,
+			    _mm256_mul_pd (ratio, lz));
+	}
+      projScalar (n - k, stride, result + k, lhs + k, rhs + k);
+    }
+
+    const MathKernels avx2Kernels =
+      {"avx2", crossAvx2, normalizeAvx2, dotProdAvx2, projAvx2};
+#endif //! LIBMOCAP_X86_KERNELS
+
+    const MathKernels*
+    selectMathKernels ()
+    {
+      const char* env = std::getenv ("LIBMOCAP_SIMD");
+      std::string restriction = env ? env : "";
+
+      if (restriction == "scalar")
+	return &scalarKernels;
+#ifdef LIBMOCAP_X86_KERNELS
+      __builtin_cpu_init ();
+      if (restriction != "sse2" && __builtin_cpu_supports ("avx2"))
+	return &avx2Kernels;
+      if (__builtin_cpu_supports ("sse2"))
+	return &sse2Kernels;
+#endif //! LIBMOCAP_X86_KERNELS
+      return &scalarKernels;
+    }
+
+    const MathKernels&
+    mathKernels ()
+    {
+      static const MathKernels* kernels = selectMathKernels ();
+      return *kernels;
+    }
+  } // end of anonymous namespace.
+
+  void cross (std::size_t n, std::size_t stride,
+	      double* result, const double* lhs, const double* rhs)
   {
-    double n = std::sqrt (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
-    v[0] /= n;
-    v[1] /= n;
-    v[2] /= n;
+    mathKernels ().cross (n, stride, result, lhs, rhs);
   }
 
-  void dot_prod (double& result, const double lhs[3], const double rhs[3])
+  void normalize (std::size_t n, std::size_t stride, double* v)
   {
-    result = lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2];
+    mathKernels ().normalize (n, stride, v);
   }
 
-  void proj (double result[3], const double lhs[3], const double rhs[3])
+  void dot_prod (std::size_t n, std::size_t stride,
+		 double* result, const double* lhs, const double* rhs)
   {
-    double cross_uu;
-    double cross_uv;
+    mathKernels ().dot_prod (n, stride, result, lhs, rhs);
+  }
 
-    dot_prod (cross_uu, lhs, lhs);
-    dot_prod (cross_uv, lhs, rhs);
+  void proj (std::size_t n, std::size_t stride,
+	     double* result, const double* lhs, const double* rhs)
+  {
+    mathKernels ().proj (n, stride, result, lhs, rhs);
+  }
 
-    for (std::size_t i = 0; i < 3; ++i)
-      result[i] = cross_uv / cross_uu * lhs[i];
+  const char* mathKernelsName ()
+  {
+    return mathKernels ().name;
   }
 
 } // end of namespace libmocap
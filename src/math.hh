@@ -30,14 +30,73 @@
 
 #ifndef LIBMOCAP_MATH_HH
 # define LIBMOCAP_MATH_HH
-# include <string>
+# include <cmath>
+# include <cstddef>
 
+// These helpers are defined inline so that loops calling them on
+// consecutive frames can be vectorized.
 namespace libmocap
 {
-  void cross (double result[3], const double lhs[3], const double rhs[3]);
-  void normalize (double v[3]);
-  void dot_prod (double& result, const double lhs[3], const double rhs[3]);
-  void proj (double result[3], const double lhs[3], const double rhs[3]);
+  inline void
+  cross (double result[3], const double lhs[3], const double rhs[3])
+  {
+    result[0] = lhs[1] * rhs[2] - lhs[2] * rhs[1];
+    result[1] = lhs[2] * rhs[0] - lhs[0] * rhs[2];
+    result[2] = lhs[0] * rhs[1] - lhs[1] * rhs[0];
+  }
+
+  inline void
+  normalize (double v[3])
+  {
+    double n = std::sqrt (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    v[0] /= n;
+    v[1] /= n;
+    v[2] /= n;
+  }
+
+  inline void
+  dot_prod (double& result, const double lhs[3], const double rhs[3])
+  {
+    result = lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2];
+  }
+
+  inline void
+  proj (double result[3], const double lhs[3], const double rhs[3])
+  {
+    double cross_uu;
+    double cross_uv;
+
+    dot_prod (cross_uu, lhs, lhs);
+    dot_prod (cross_uv, lhs, rhs);
+
+    for (std::size_t i = 0; i < 3; ++i)
+      result[i] = cross_uv / cross_uu * lhs[i];
+  }
+
+  /// \name Batched variants.
+  ///
+  /// Vectors are stored by axis: coordinate i of the k-th vector is
+  /// stored at v[i * stride + k]. Each function processes n vectors
+  /// and produces bitwise the same values as its single vector
+  /// counterpart.
+  ///
+  /// The implementation (AVX2, SSE2 or scalar) is selected once at
+  /// run time depending on the CPU features. It can be restricted
+  /// by setting the LIBMOCAP_SIMD environment variable to `sse2' or
+  /// `scalar'.
+  /// \{
+  void cross (std::size_t n, std::size_t stride,
+	      double* result, const double* lhs, const double* rhs);
+  void normalize (std::size_t n, std::size_t stride, double* v);
+  /// \param result n contiguous values
+  void dot_prod (std::size_t n, std::size_t stride,
+		 double* result, const double* lhs, const double* rhs);
+  void proj (std::size_t n, std::size_t stride,
+	     double* result, const double* lhs, const double* rhs);
+  /// \}
+
+  /// \brief Name of the selected batched implementation.
+  const char* mathKernelsName ();
 } // end of namespace libmocap
 
 #endif //! LIBMOCAP_MATH_HH
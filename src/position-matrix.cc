@@ -0,0 +1,144 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <new>
+
+#include <libmocap/position-matrix.hh>
+
+namespace libmocap
+{
+  static double* allocate (std::size_t numElements)
+  {
+    if (!numElements)
+      return 0;
+
+    void* ptr = 0;
+    if (posix_memalign (&ptr, PositionMatrix::alignment,
+			numElements * sizeof (double)) != 0)
+      throw std::bad_alloc ();
+    return static_cast<double*> (ptr);
+  }
+
+  const std::size_t PositionMatrix::alignment;
+
+  PositionMatrix::PositionMatrix ()
+    : numRows_ (),
+      numCols_ (),
+      data_ ()
+  {}
+
+  PositionMatrix::PositionMatrix (std::size_t numRows, std::size_t numCols)
+    : numRows_ (),
+      numCols_ (),
+      data_ ()
+  {
+    resize (numRows, numCols);
+  }
+
+  PositionMatrix::PositionMatrix (const PositionMatrix& rhs)
+    : numRows_ (rhs.numRows_),
+      numCols_ (rhs.numCols_),
+      data_ (allocate (rhs.numRows_ * rhs.numCols_))
+  {
+    if (data_)
+      std::memcpy (data_, rhs.data_, numRows_ * numCols_ * sizeof (double));
+  }
+
+  PositionMatrix::~PositionMatrix ()
+  {
+    std::free (data_);
+  }
+
+  PositionMatrix&
+  PositionMatrix::operator= (const PositionMatrix& rhs)
+  {
+    if (this == &rhs)
+      return *this;
+    PositionMatrix tmp (rhs);
+    swap (tmp);
+    return *this;
+  }
+
+  void
+  PositionMatrix::resize (std::size_t numRows, std::size_t numCols)
+  {
+    double* data = allocate (numRows * numCols);
+    if (data)
+      std::memset (data, 0, numRows * numCols * sizeof (double));
+
+    std::free (data_);
+    data_ = data;
+    numRows_ = numRows;
+    numCols_ = numCols;
+  }
+
+  void
+  PositionMatrix::clear ()
+  {
+    std::free (data_);
+    data_ = 0;
+    numRows_ = 0;
+    numCols_ = 0;
+  }
+
+  void
+  PositionMatrix::swap (PositionMatrix& other)
+  {
+    std::swap (numRows_, other.numRows_);
+    std::swap (numCols_, other.numCols_);
+    std::swap (data_, other.data_);
+  }
+
+  void
+  PositionMatrix::transpose (PositionMatrix& result) const
+  {
+    // Work on square tiles so that both the rows being read and the
+    // rows being written stay in cache.
+    static const std::size_t blockSize = 32;
+
+    if (result.numRows_ != numCols_ || result.numCols_ != numRows_)
+      result.resize (numCols_, numRows_);
+
+    for (std::size_t row0 = 0; row0 < numRows_; row0 += blockSize)
+      {
+	std::size_t rowEnd = std::min (row0 + blockSize, numRows_);
+	for (std::size_t col0 = 0; col0 < numCols_; col0 += blockSize)
+	  {
+	    std::size_t colEnd = std::min (col0 + blockSize, numCols_);
+	    for (std::size_t row = row0; row < rowEnd; ++row)
+	      for (std::size_t col = col0; col < colEnd; ++col)
+		result.data_[col * numRows_ + row] = data_[row * numCols_ + col];
+	  }
+      }
+  }
+
+} // end of namespace libmocap.
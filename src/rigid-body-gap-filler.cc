@@ -0,0 +1,422 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include <libmocap/marker.hh>
+#include <libmocap/marker-set.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/rigid-body-gap-filler.hh>
+
+#include "rigid-transform.hh"
+#include "thread-pool.hh"
+
+namespace libmocap
+{
+  namespace
+  {
+    const std::vector<std::size_t> noNeighbors;
+
+    /// Marker id of a marker set element, -1 if it is not a
+    /// physical marker.
+    int
+    physicalId (const MarkerSet& markerSet, int index)
+    {
+      if (index < 0
+	  || static_cast<std::size_t> (index) >= markerSet.markers ().size ())
+	return -1;
+      const AbstractMarker* marker =
+	markerSet.markers ()[static_cast<std::size_t> (index)];
+      return dynamic_cast<const Marker*> (marker) ? marker->id () : -1;
+    }
+
+    void
+    addNeighbor (std::vector<std::vector<std::size_t> >& neighbors,
+		 int marker, int neighbor)
+    {
+      if (marker < 0 || neighbor < 0 || marker == neighbor)
+	return;
+      std::size_t m = static_cast<std::size_t> (marker);
+      std::size_t n = static_cast<std::size_t> (neighbor);
+      if (neighbors.size () <= m)
+	neighbors.resize (m + 1);
+      if (std::find (neighbors[m].begin (), neighbors[m].end (), n)
+	  == neighbors[m].end ())
+	neighbors[m].push_back (n);
+    }
+
+    /// Shape formed by a marker (first point) and its neighbors.
+    struct Shape
+    {
+      bool valid;
+      std::vector<double> points;
+    };
+
+    /// Trajectory being processed and visibility of its samples
+    /// before filling.
+    ///
+    /// Positions are accessed through the trajectory accessors so that
+    /// single precision trajectories are filled in place.
+    struct FillData
+    {
+      MarkerTrajectory* trajectory;
+      std::size_t numMarkers;
+      std::vector<unsigned char> visible;
+      const std::vector<std::vector<std::size_t> >* neighbors;
+      std::vector<Shape> shapes;
+
+      bool isVisible (std::size_t frame, std::size_t marker) const
+      {
+	return visible[frame * numMarkers + marker] != 0;
+      }
+
+      void position (double* p, std::size_t frame, std::size_t marker) const
+      {
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	  p[axis] = trajectory->position (frame, 1 + 3 * marker + axis);
+      }
+
+      void setPosition (std::size_t frame, std::size_t marker,
+			const double* p) const
+      {
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	  trajectory->setPosition (frame, 1 + 3 * marker + axis, p[axis]);
+      }
+    };
+
+    /// Estimate the shape of a marker from the frames where it is
+    /// visible with all its neighbors, by averaging these frames once
+    /// rigidly aligned on the first one.
+    void
+    estimateShape (FillData& data, std::size_t marker)
+    {
+      Shape& shape = data.shapes[marker];
+      shape.valid = false;
+
+      const std::vector<std::size_t>& neighbors = (*data.neighbors)[marker];
+      if (neighbors.size () < 3)
+	return;
+
+      std::vector<std::size_t> ids (1, marker);
+      ids.insert (ids.end (), neighbors.begin (), neighbors.end ());
+      const std::size_t n = ids.size ();
+
+      std::vector<double> reference;
+      std::vector<double> observed (3 * n);
+      std::vector<double> sum (3 * n, 0.);
+      std::size_t count = 0;
+
+      for (std::size_t frame = 0; frame < data.trajectory->numRows ();
+	   ++frame)
+	{
+	  std::size_t i = 0;
+	  while (i < n && data.isVisible (frame, ids[i]))
+	    ++i;
+	  if (i < n)
+	    continue;
+
+	  for (i = 0; i < n; ++i)
+	    data.position (&observed[3 * i], frame, ids[i]);
+	  if (reference.empty ())
+	    reference = observed;
+
+	  double rotation[9];
+	  double translation[3];
+	  if (!rigidTransform (rotation, translation,
+			       &observed[0], &reference[0], n))
+	    continue;
+	  for (i = 0; i < n; ++i)
+	    {
+	      double aligned[3];
+	      applyRigidTransform (aligned, rotation, translation,
+				   &observed[3 * i]);
+	      for (std::size_t axis = 0; axis < 3; ++axis)
+		sum[3 * i + axis] += aligned[axis];
+	    }
+	  ++count;
+	}
+
+      if (!count)
+	return;
+      shape.points.resize (3 * n);
+      for (std::size_t i = 0; i < 3 * n; ++i)
+	shape.points[i] = sum[i] / static_cast<double> (count);
+      shape.valid = true;
+    }
+
+    /// Reconstruct the missing markers of a range of frames.
+    std::size_t
+    fillFrames (FillData& data, std::size_t first, std::size_t last)
+    {
+      std::size_t filled = 0;
+      std::vector<double> from;
+      std::vector<double> to;
+
+      for (std::size_t frame = first; frame < last; ++frame)
+	for (std::size_t marker = 0; marker < data.shapes.size (); ++marker)
+	  {
+	    const Shape& shape = data.shapes[marker];
+	    if (!shape.valid || data.isVisible (frame, marker))
+	      continue;
+
+	    const std::vector<std::size_t>& neighbors =
+	      (*data.neighbors)[marker];
+	    from.clear ();
+	    to.clear ();
+	    for (std::size_t i = 0; i < neighbors.size (); ++i)
+	      if (data.isVisible (frame, neighbors[i]))
+		{
+		  double p[3];
+		  data.position (p, frame, neighbors[i]);
+		  from.insert (from.end (), &shape.points[3 * (i + 1)],
+			       &shape.points[3 * (i + 1)] + 3);
+		  to.insert (to.end (), p, p + 3);
+		}
+
+	    double rotation[9];
+	    double translation[3];
+	    if (from.size () < 9
+		|| !rigidTransform (rotation, translation,
+				    &from[0], &to[0], from.size () / 3))
+	      continue;
+	    double p[3];
+	    applyRigidTransform (p, rotation, translation, &shape.points[0]);
+	    data.setPosition (frame, marker, p);
+	    ++filled;
+	  }
+      return filled;
+    }
+
+    class ShapeEstimator : public ThreadPool::Task
+    {
+    public:
+      ShapeEstimator (FillData& data, std::size_t marker)
+	: data_ (&data),
+	  marker_ (marker)
+      {}
+
+      void run ()
+      {
+	estimateShape (*data_, marker_);
+      }
+
+    private:
+      FillData* data_;
+      std::size_t marker_;
+    };
+
+    class FramesFiller : public ThreadPool::Task
+    {
+    public:
+      FramesFiller (FillData& data, std::size_t first, std::size_t last)
+	: data_ (&data),
+	  first_ (first),
+	  last_ (last),
+	  filled_ (0)
+      {}
+
+      void run ()
+      {
+	filled_ = fillFrames (*data_, first_, last_);
+      }
+
+      std::size_t filled () const
+      {
+	return filled_;
+      }
+
+    private:
+      FillData* data_;
+      std::size_t first_;
+      std::size_t last_;
+      std::size_t filled_;
+    };
+
+    template <typename T>
+    void
+    runTasks (ThreadPool& pool, std::vector<T>& tasks)
+    {
+      std::vector<ThreadPool::Task*> pointers (tasks.size ());
+      for (std::size_t i = 0; i < tasks.size (); ++i)
+	pointers[i] = &tasks[i];
+      pool.run (pointers);
+    }
+  } // end of anonymous namespace.
+
+  RigidBodyGapFiller::RigidBodyGapFiller ()
+    : neighbors_ (),
+      names_ (),
+      numThreads_ (0)
+  {}
+
+  RigidBodyGapFiller::RigidBodyGapFiller (const MarkerSet& markerSet)
+    : neighbors_ (),
+      names_ (),
+      numThreads_ (0)
+  {
+    for (std::size_t i = 0; i < markerSet.markers ().size (); ++i)
+      {
+	int id = physicalId (markerSet, static_cast<int> (i));
+	if (id < 0)
+	  continue;
+	if (names_.size () <= static_cast<std::size_t> (id))
+	  names_.resize (static_cast<std::size_t> (id) + 1);
+	names_[static_cast<std::size_t> (id)] =
+	  markerSet.markers ()[i]->name ();
+      }
+
+    std::vector<Link>::const_iterator link;
+    for (link = markerSet.links ().begin ();
+	 link != markerSet.links ().end (); ++link)
+      {
+	int marker1 = physicalId (markerSet, link->marker1 ());
+	int marker2 = physicalId (markerSet, link->marker2 ());
+	addNeighbor (neighbors_, marker1, marker2);
+	addNeighbor (neighbors_, marker2, marker1);
+      }
+
+    std::vector<Segment>::const_iterator segment;
+    for (segment = markerSet.segments ().begin ();
+	 segment != markerSet.segments ().end (); ++segment)
+      {
+	int markers[3] =
+	  {
+	    physicalId (markerSet, segment->originMarker ()),
+	    physicalId (markerSet, segment->longAxisMarker ()),
+	    physicalId (markerSet, segment->planeAxisMarker ())
+	  };
+	for (std::size_t i = 0; i < 3; ++i)
+	  for (std::size_t j = 0; j < 3; ++j)
+	    addNeighbor (neighbors_, markers[i], markers[j]);
+      }
+  }
+
+  const std::vector<std::size_t>&
+  RigidBodyGapFiller::neighbors (std::size_t marker) const
+  {
+    return marker < neighbors_.size () ? neighbors_[marker] : noNeighbors;
+  }
+
+  std::size_t
+  RigidBodyGapFiller::fill (MarkerTrajectory& trajectory) const
+  {
+    if (numThreads_ < 0)
+      throw std::runtime_error ("invalid number of threads");
+
+    const std::size_t numFrames = trajectory.numRows ();
+    const std::size_t numMarkers =
+      trajectory.numCols () ? (trajectory.numCols () - 1) / 3 : 0;
+
+    // Marker set ids are bound to the trajectory markers by name, so
+    // that trajectories storing a subset of the markers are supported.
+    const std::vector<std::vector<std::size_t> >* neighbors = &neighbors_;
+    std::vector<std::vector<std::size_t> > boundNeighbors;
+    if (!names_.empty () && !trajectory.markers ().empty ())
+      {
+	std::vector<std::size_t> index (neighbors_.size ());
+	bool identity = true;
+	for (std::size_t marker = 0; marker < neighbors_.size (); ++marker)
+	  if (!neighbors_[marker].empty ())
+	    {
+	      index[marker] = static_cast<std::size_t>
+		(trajectory.markerIndex (names_[marker],
+					 static_cast<int> (marker)));
+	      identity = identity && index[marker] == marker;
+	    }
+
+	if (!identity)
+	  {
+	    boundNeighbors.resize (trajectory.markers ().size ());
+	    for (std::size_t marker = 0; marker < neighbors_.size ();
+		 ++marker)
+	      for (std::size_t i = 0; i < neighbors_[marker].size (); ++i)
+		boundNeighbors[index[marker]].push_back
+		  (index[neighbors_[marker][i]]);
+	    neighbors = &boundNeighbors;
+	  }
+      }
+
+    // Neighbors are symmetric, checking them covers all the markers.
+    for (std::size_t marker = 0; marker < neighbors->size (); ++marker)
+      for (std::size_t i = 0; i < (*neighbors)[marker].size (); ++i)
+	if ((*neighbors)[marker][i] >= numMarkers)
+	  {
+	    std::ostringstream error;
+	    error
+	      << "marker id " << (*neighbors)[marker][i]
+	      << " is not defined by trajectory `"
+	      << trajectory.filename () << "' ("
+	      << numMarkers << " markers)";
+	    throw std::runtime_error (error.str ());
+	  }
+
+    FillData data;
+    data.trajectory = &trajectory;
+    data.numMarkers = numMarkers;
+    data.neighbors = neighbors;
+    data.shapes.resize (neighbors->size ());
+    data.visible.resize (numFrames * numMarkers);
+    for (std::size_t frame = 0; frame < numFrames; ++frame)
+      for (std::size_t marker = 0; marker < numMarkers; ++marker)
+	{
+	  double p[3];
+	  data.position (p, frame, marker);
+	  data.visible[frame * numMarkers + marker] =
+	    !(std::isnan (p[0]) || std::isnan (p[1]) || std::isnan (p[2]));
+	}
+
+    ThreadPool pool (static_cast<std::size_t> (numThreads_));
+
+    std::vector<ShapeEstimator> estimators;
+    estimators.reserve (neighbors->size ());
+    for (std::size_t marker = 0; marker < neighbors->size (); ++marker)
+      estimators.push_back (ShapeEstimator (data, marker));
+    runTasks (pool, estimators);
+
+    // Several chunks are created per thread to balance the load.
+    const std::size_t numChunks =
+      std::min (pool.numThreads () * 4, std::max<std::size_t> (numFrames, 1));
+    std::vector<FramesFiller> fillers;
+    fillers.reserve (numChunks);
+    for (std::size_t i = 0; i < numChunks; ++i)
+      fillers.push_back (FramesFiller (data,
+				       numFrames * i / numChunks,
+				       numFrames * (i + 1) / numChunks));
+    runTasks (pool, fillers);
+
+    std::size_t filled = 0;
+    for (std::size_t i = 0; i < fillers.size (); ++i)
+      filled += fillers[i].filled ();
+    return filled;
+  }
+
+} // end of namespace libmocap.
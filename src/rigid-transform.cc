@@ -0,0 +1,223 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <cmath>
+
+#include "rigid-transform.hh"
+
+namespace libmocap
+{
+  namespace
+  {
+    /// Eigen decomposition of a symmetric N x N matrix (cyclic Jacobi
+    /// method). The matrix a is destroyed, its eigenvalues are left
+    /// on its diagonal and the eigenvectors are the columns of v.
+    template <std::size_t N>
+    void
+    symmetricEigen (double a[N][N], double v[N][N])
+    {
+      for (std::size_t i = 0; i < N; ++i)
+	for (std::size_t j = 0; j < N; ++j)
+	  v[i][j] = i == j ? 1. : 0.;
+
+      for (std::size_t sweep = 0; sweep < 50; ++sweep)
+	{
+	  double offDiagonal = 0.;
+	  double diagonal = 0.;
+	  for (std::size_t i = 0; i < N; ++i)
+	    {
+	      diagonal += a[i][i] * a[i][i];
+	      for (std::size_t j = i + 1; j < N; ++j)
+		offDiagonal += a[i][j] * a[i][j];
+	    }
+	  if (offDiagonal <= 1e-30 * diagonal || offDiagonal == 0.)
+	    return;
+
+	  for (std::size_t p = 0; p < N; ++p)
+	    for (std::size_t q = p + 1; q < N; ++q)
+	      {
+		if (a[p][q] == 0.)
+		  continue;
+		const double theta = (a[q][q] - a[p][p]) / (2. * a[p][q]);
+		const double t = (theta >= 0. ? 1. : -1.)
+		  / (std::fabs (theta) + std::sqrt (theta * theta + 1.));
+		const double c = 1. / std::sqrt (t * t + 1.);
+		const double s = t * c;
+
+		for (std::size_t k = 0; k < N; ++k)
+		  {
+		    const double akp = a[k][p];
+		    const double akq = a[k][q];
+		    a[k][p] = c * akp - s * akq;
+		    a[k][q] = s * akp + c * akq;
+		  }
+		for (std::size_t k = 0; k < N; ++k)
+		  {
+		    const double apk = a[p][k];
+		    const double aqk = a[q][k];
+		    a[p][k] = c * apk - s * aqk;
+		    a[q][k] = s * apk + c * aqk;
+		  }
+		for (std::size_t k = 0; k < N; ++k)
+		  {
+		    const double vkp = v[k][p];
+		    const double vkq = v[k][q];
+		    v[k][p] = c * vkp - s * vkq;
+		    v[k][q] = s * vkp + c * vkq;
+		  }
+	      }
+	}
+    }
+
+    void
+    centroid (double result[3], const double* points, std::size_t n)
+    {
+      result[0] = result[1] = result[2] = 0.;
+      for (std::size_t i = 0; i < n; ++i)
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	  result[axis] += points[3 * i + axis];
+      for (std::size_t axis = 0; axis < 3; ++axis)
+	result[axis] /= static_cast<double> (n);
+    }
+  } // end of anonymous namespace.
+
+  bool
+  rigidTransform (double rotation[9], double translation[3],
+		  const double* from, const double* to, std::size_t n)
+  {
+    if (n < 3)
+      return false;
+
+    double fromCentroid[3];
+    double toCentroid[3];
+    centroid (fromCentroid, from, n);
+    centroid (toCentroid, to, n);
+
+    // Cross-covariance s[a][b] = sum (from_a - c_a) (to_b - c_b) and
+    // scatter of the source points.
+    double s[3][3] = {{0., 0., 0.}, {0., 0., 0.}, {0., 0., 0.}};
+    double scatter[3][3] = {{0., 0., 0.}, {0., 0., 0.}, {0., 0., 0.}};
+    for (std::size_t i = 0; i < n; ++i)
+      {
+	double f[3];
+	double t[3];
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	  {
+	    f[axis] = from[3 * i + axis] - fromCentroid[axis];
+	    t[axis] = to[3 * i + axis] - toCentroid[axis];
+	  }
+	for (std::size_t a = 0; a < 3; ++a)
+	  for (std::size_t b = 0; b < 3; ++b)
+	    {
+	      s[a][b] += f[a] * t[b];
+	      scatter[a][b] += f[a] * f[b];
+	    }
+      }
+
+    // The rotation around the line of collinear points is not
+    // defined: require a significant second principal direction.
+    double axes[3][3];
+    symmetricEigen<3> (scatter, axes);
+    double largest = 0.;
+    double smallest = 0.;
+    double sum = 0.;
+    for (std::size_t i = 0; i < 3; ++i)
+      {
+	const double lambda = std::fabs (scatter[i][i]);
+	sum += lambda;
+	if (i == 0 || lambda > largest)
+	  largest = lambda;
+	if (i == 0 || lambda < smallest)
+	  smallest = lambda;
+      }
+    if (!(sum - largest - smallest > 1e-6 * largest))
+      return false;
+
+    double m[4][4] =
+      {
+	{s[0][0] + s[1][1] + s[2][2], s[1][2] - s[2][1],
+	 s[2][0] - s[0][2], s[0][1] - s[1][0]},
+	{s[1][2] - s[2][1], s[0][0] - s[1][1] - s[2][2],
+	 s[0][1] + s[1][0], s[2][0] + s[0][2]},
+	{s[2][0] - s[0][2], s[0][1] + s[1][0],
+	 -s[0][0] + s[1][1] - s[2][2], s[1][2] + s[2][1]},
+	{s[0][1] - s[1][0], s[2][0] + s[0][2],
+	 s[1][2] + s[2][1], -s[0][0] - s[1][1] + s[2][2]}
+      };
+    double v[4][4];
+    symmetricEigen<4> (m, v);
+
+    // The optimal rotation is the eigenvector of the largest
+    // eigenvalue.
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < 4; ++i)
+      if (m[i][i] > m[best][best])
+	best = i;
+    double w = v[0][best];
+    double x = v[1][best];
+    double y = v[2][best];
+    double z = v[3][best];
+    const double norm = std::sqrt (w * w + x * x + y * y + z * z);
+    w /= norm;
+    x /= norm;
+    y /= norm;
+    z /= norm;
+
+    rotation[0] = w * w + x * x - y * y - z * z;
+    rotation[1] = 2. * (x * y - w * z);
+    rotation[2] = 2. * (x * z + w * y);
+    rotation[3] = 2. * (x * y + w * z);
+    rotation[4] = w * w - x * x + y * y - z * z;
+    rotation[5] = 2. * (y * z - w * x);
+    rotation[6] = 2. * (x * z - w * y);
+    rotation[7] = 2. * (y * z + w * x);
+    rotation[8] = w * w - x * x - y * y + z * z;
+
+    for (std::size_t i = 0; i < 3; ++i)
+      translation[i] = toCentroid[i]
+	- rotation[3 * i] * fromCentroid[0]
+	- rotation[3 * i + 1] * fromCentroid[1]
+	- rotation[3 * i + 2] * fromCentroid[2];
+    return true;
+  }
+
+  void
+  applyRigidTransform (double result[3],
+		       const double rotation[9],
+		       const double translation[3],
+		       const double point[3])
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+      result[i] = rotation[3 * i] * point[0]
+	+ rotation[3 * i + 1] * point[1]
+	+ rotation[3 * i + 2] * point[2]
+	+ translation[i];
+  }
+
+} // end of namespace libmocap.
@@ -0,0 +1,61 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_RIGID_TRANSFORM_HH
+# define LIBMOCAP_RIGID_TRANSFORM_HH
+# include <cstddef>
+
+namespace libmocap
+{
+  /// \brief Least-squares rigid transformation between two sets of
+  /// points.
+  ///
+  /// Compute the rotation R and translation t minimizing
+  /// sum_i |R from_i + t - to_i|^2 (Kabsch problem), using Horn's
+  /// closed-form unit quaternion solution.
+  ///
+  /// \param rotation resulting rotation matrix (row-major)
+  /// \param translation resulting translation
+  /// \param from n points, stored as consecutive X, Y, Z triplets
+  /// \param to n points, stored as consecutive X, Y, Z triplets
+  /// \return false if the transformation is not unique, i.e. if
+  /// there are less than three points or if the points of from are
+  /// (nearly) collinear.
+  bool rigidTransform (double rotation[9], double translation[3],
+		       const double* from, const double* to, std::size_t n);
+
+  /// \brief Apply a rigid transformation to a point.
+  void applyRigidTransform (double result[3],
+			    const double rotation[9],
+			    const double translation[3],
+			    const double point[3]);
+} // end of namespace libmocap
+
+#endif //! LIBMOCAP_RIGID_TRANSFORM_HH
@@ -37,10 +37,12 @@ namespace libmocap
 {
   MarkerSetLinkView::MarkerSetLinkView
   (const MarkerTrajectory& trajectory,
-   const MarkerSet& markerSet)
+   const MarkerSet& markerSet,
+   MarkerPositionCache& cache)
     : View (),
       trajectory_ (trajectory),
-      markerSet_ (markerSet)
+      markerSet_ (markerSet),
+      cache_ (cache)
   {
     msg_.type = visualization_msgs::Marker::LINE_LIST;
     msg_.ns = "markers/links";
@@ -62,16 +64,14 @@ namespace libmocap
     std::size_t marker2;
     std::size_t missingData = 0;
 
-    std::size_t frameId_ = static_cast<std::size_t> (frameId);
-
     msg_.action = visualization_msgs::Marker::ADD;
 
-    if (frameId >= static_cast<int> (trajectory_.positions ().size ()))
+    if (frameId >= static_cast<int> (trajectory_.numRows ()))
       {
 	std::cerr << "size mismatch (trajectory)" << std::endl;
 	return;
       }
-    if (trajectory_.positions ()[frameId_].empty ())
+    if (!trajectory_.numCols ())
       {
 	std::cerr << "size mismatch (frame in trajectory)" << std::endl;
 	return;
@@ -97,12 +97,8 @@ namespace libmocap
 	    continue;
 	  }
 
-	double position1[3];
-	double position2[3];
-	markerSet_.markers ()[marker1]->position
-	  (position1, markerSet_, trajectory_, frameId);
-	markerSet_.markers ()[marker2]->position
-	  (position2, markerSet_, trajectory_, frameId);
+	const double* position1 = cache_.position (marker1, frameId);
+	const double* position2 = cache_.position (marker2, frameId);
 
 	std::size_t id = (i - missingData) * 2;
 	msg.points[id].x = position1[0];
@@ -31,6 +31,7 @@
 #ifndef LIBMOCAP_ROS_VIEWER_MARKER_SET_LINK_VIEW_HH
 # define LIBMOCAP_ROS_VIEWER_MARKER_SET_LINK_VIEW_HH
 # include <libmocap/marker-trajectory.hh>
+# include <libmocap/marker-position-cache.hh>
 # include <libmocap/marker-set.hh>
 
 # include "view.hh"
@@ -40,7 +41,8 @@ namespace libmocap
   class MarkerSetLinkView : public View
   {
   public:
-    MarkerSetLinkView (const MarkerTrajectory&, const MarkerSet&);
+    MarkerSetLinkView (const MarkerTrajectory&, const MarkerSet&,
+		       MarkerPositionCache&);
     ~MarkerSetLinkView ();
 
     virtual void
@@ -48,6 +50,7 @@ namespace libmocap
   private:
     const MarkerTrajectory& trajectory_;
     const MarkerSet& markerSet_;
+    MarkerPositionCache& cache_;
   };
 } // end of namespace libmocap
 
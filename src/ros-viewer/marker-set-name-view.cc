@@ -38,10 +38,12 @@ namespace libmocap
   MarkerSetNameView::MarkerSetNameView
   (const MarkerTrajectory& trajectory,
    const MarkerSet& markerSet,
+   MarkerPositionCache& cache,
    std::size_t id)
     : View (),
       trajectory_ (trajectory),
       markerSet_ (markerSet),
+      cache_ (cache),
       id_ (id)
   {
     if (id >= markerSet_.markers ().size ())
@@ -67,12 +69,12 @@ namespace libmocap
 
     msg_.action = visualization_msgs::Marker::ADD;
 
-    if (frameId_ >= trajectory_.positions ().size ())
+    if (frameId_ >= trajectory_.numRows ())
       {
 	std::cerr << "size mismatch (trajectory)" << std::endl;
 	return;
       }
-    if (trajectory_.positions ()[frameId_].empty ())
+    if (!trajectory_.numCols ())
       {
 	std::cerr << "size mismatch (frame in trajectory)" << std::endl;
 	return;
@@ -94,9 +96,7 @@ namespace libmocap
 	return;
       }
 
-    double position[3];
-    markerSet_.markers ()[id_]->position
-      (position, markerSet_, trajectory_, frameId);
+    const double* position = cache_.position (id_, frameId);
 
     msg.pose.position.x = position[0] + .5 * msg_.scale.z;
     msg.pose.position.y = position[1] + .5 * msg_.scale.z;
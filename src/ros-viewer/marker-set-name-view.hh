@@ -31,6 +31,7 @@
 #ifndef LIBMOCAP_ROS_VIEWER_MARKER_SET_NAME_VIEW_HH
 # define LIBMOCAP_ROS_VIEWER_MARKER_SET_NAME_VIEW_HH
 # include <libmocap/marker-trajectory.hh>
+# include <libmocap/marker-position-cache.hh>
 # include <libmocap/marker-set.hh>
 
 # include "view.hh"
@@ -40,7 +41,8 @@ namespace libmocap
   class MarkerSetNameView : public View
   {
   public:
-    MarkerSetNameView (const MarkerTrajectory&, const MarkerSet&, std::size_t id);
+    MarkerSetNameView (const MarkerTrajectory&, const MarkerSet&,
+		       MarkerPositionCache&, std::size_t id);
     ~MarkerSetNameView ();
 
     virtual void
@@ -48,6 +50,7 @@ namespace libmocap
   private:
     const MarkerTrajectory& trajectory_;
     const MarkerSet& markerSet_;
+    MarkerPositionCache& cache_;
     std::size_t id_;
   };
 } // end of namespace libmocap
@@ -37,13 +37,14 @@
 namespace libmocap
 {
   MarkerSetSegmentView::MarkerSetSegmentView
-  (const MarkerTrajectory& trajectory,
-   const MarkerSet& markerSet,
-   std::size_t segmentId)
+  (const MarkerSet& markerSet,
+   MarkerPositionCache& cache,
+   std::size_t segmentId,
+   double axisLength)
     : View (),
-      trajectory_ (trajectory),
-      markerSet_ (markerSet),
-      segmentId_ (segmentId)
+      cache_ (cache),
+      segmentId_ (segmentId),
+      axisLength_ (axisLength)
   {
     if (segmentId >= markerSet.segments ().size ())
       throw std::runtime_error ("segment id too high");
@@ -87,109 +88,34 @@ namespace libmocap
   MarkerSetSegmentView::~MarkerSetSegmentView ()
   {}
 
-  static void cross (double result[3], const double lhs[3], const double rhs[3])
-  {
-    result[0] = lhs[1] * rhs[2] - lhs[2] * rhs[1];
-    result[1] = lhs[2] * rhs[0] - lhs[0] * rhs[2];
-    result[2] = lhs[0] * rhs[1] - lhs[1] * rhs[0];
-  }
-
-  static void dot_prod (double& result, const double lhs[3], const double rhs[3])
-  {
-    result = lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2];
-  }
-
-  static void proj (double result[3], const double lhs[3], const double rhs[3])
-  {
-    double cross_uu;
-    double cross_uv;
-
-    dot_prod (cross_uu, lhs, lhs);
-    dot_prod (cross_uv, lhs, rhs);
-
-    for (std::size_t i = 0; i < 3; ++i)
-      result[i] = cross_uv / cross_uu * lhs[i];
-  }
-
   void
   MarkerSetSegmentView::updateMessage (int frameId, visualization_msgs::Marker& msg)
   {
     msg_.action = visualization_msgs::Marker::ADD;
 
-    std::size_t originMarkerId;
-    std::size_t longAxisMarkerId;
-    std::size_t planeAxisMarkerId;
-
-    originMarkerId = static_cast<std::size_t>
-      (markerSet_.segments ()[segmentId_].originMarker ());
-    longAxisMarkerId = static_cast<std::size_t>
-      (markerSet_.segments ()[segmentId_].longAxisMarker ());
-    planeAxisMarkerId = static_cast<std::size_t>
-      (markerSet_.segments ()[segmentId_].planeAxisMarker ());
-
-    double originMarkerPos[3];
-    double longAxisMarkerPos[3];
-    double planeAxisMarkerPos[3];
-
-    markerSet_.markers ()[originMarkerId]->position
-      (originMarkerPos, markerSet_, trajectory_, frameId);
-    markerSet_.markers ()[longAxisMarkerId]->position
-      (longAxisMarkerPos, markerSet_, trajectory_, frameId);
-    markerSet_.markers ()[planeAxisMarkerId]->position
-      (planeAxisMarkerPos, markerSet_, trajectory_, frameId);
-
-    for (std::size_t i = 0; i < 3; ++i)
-      if (std::isnan (originMarkerPos[i])
-	  || std::isnan (longAxisMarkerPos[i])
-	  || std::isnan (planeAxisMarkerPos[i]))
-	{
-	  msg_.action = visualization_msgs::Marker::DELETE;
-	  return;
-	}
-
-    double ox[3];
-    double oy[3];
-    double oz[3];
-
-    for (std::size_t i = 0; i < 3; ++i)
+    if (!cache_.segmentsValid (frameId)[segmentId_])
       {
-	ox[i] = longAxisMarkerPos[i] - originMarkerPos[i];
-	oy[i] = planeAxisMarkerPos[i] - originMarkerPos[i];
+	msg_.action = visualization_msgs::Marker::DELETE;
+	return;
       }
 
-    double proj_ox_oy[3];
-    proj (proj_ox_oy, ox, oy);
-    for (std::size_t i = 0; i < 3; ++i)
-      oy[i] -= proj_ox_oy[i];
-
-    cross (oz, ox, oy);
-
-
-    // draw ox
-    msg_.points[0].x = originMarkerPos[0];
-    msg_.points[0].y = originMarkerPos[1];
-    msg_.points[0].z = originMarkerPos[2];
-
-    msg_.points[1].x = originMarkerPos[0] + ox[0];
-    msg_.points[1].y = originMarkerPos[1] + ox[1];
-    msg_.points[1].z = originMarkerPos[2] + ox[2];
-    // draw oy
-    msg_.points[2 + 0].x = originMarkerPos[0];
-    msg_.points[2 + 0].y = originMarkerPos[1];
-    msg_.points[2 + 0].z = originMarkerPos[2];
+    const double* frame =
+      cache_.segmentFrames (frameId) + segmentId_ * SegmentFrames::frameSize;
+    const double* origin = frame + 9;
 
-    msg_.points[2 + 1].x = originMarkerPos[0] + oy[0];
-    msg_.points[2 + 1].y = originMarkerPos[1] + oy[1];
-    msg_.points[2 + 1].z = originMarkerPos[2] + oy[2];
-
-    // draw oz
-    msg_.points[4 + 0].x = originMarkerPos[0];
-    msg_.points[4 + 0].y = originMarkerPos[1];
-    msg_.points[4 + 0].z = originMarkerPos[2];
-
-    msg_.points[4 + 1].x = originMarkerPos[0] + oz[0];
-    msg_.points[4 + 1].y = originMarkerPos[1] + oz[1];
-    msg_.points[4 + 1].z = originMarkerPos[2] + oz[2];
+    // draw the rotation matrix columns: ox, oy and oz
+    for (std::size_t axis = 0; axis < 3; ++axis)
+      {
+	msg_.points[2 * axis].x = origin[0];
+	msg_.points[2 * axis].y = origin[1];
+	msg_.points[2 * axis].z = origin[2];
+
+	msg_.points[2 * axis + 1].x = origin[0] + axisLength_ * frame[axis];
+	msg_.points[2 * axis + 1].y =
+	  origin[1] + axisLength_ * frame[3 + axis];
+	msg_.points[2 * axis + 1].z =
+	  origin[2] + axisLength_ * frame[6 + axis];
+      }
 
     ++msg.header.seq;
     msg.header.stamp = ros::Time::now ();
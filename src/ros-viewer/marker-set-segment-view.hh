@@ -30,26 +30,34 @@
 
 #ifndef LIBMOCAP_ROS_VIEWER_MARKER_SET_SEGMENT_VIEW_HH
 # define LIBMOCAP_ROS_VIEWER_MARKER_SET_SEGMENT_VIEW_HH
-# include <libmocap/marker-trajectory.hh>
 # include <libmocap/marker-set.hh>
+# include <libmocap/marker-position-cache.hh>
 
 # include "view.hh"
 
 namespace libmocap
 {
+  /// \brief Display the frame of a marker set segment.
+  ///
+  /// The segment frame, including its rotation offset, is drawn as
+  /// three axes of the same length starting at the segment origin.
   class MarkerSetSegmentView : public View
   {
   public:
+    /// \brief Build the view of a segment.
+    ///
+    /// \param axisLength length, in meters, of the displayed axes
     MarkerSetSegmentView
-    (const MarkerTrajectory&, const MarkerSet&, std::size_t segmentId);
+    (const MarkerSet&, MarkerPositionCache&, std::size_t segmentId,
+     double axisLength = 0.1);
     ~MarkerSetSegmentView ();
 
     virtual void
     updateMessage (int frameId, visualization_msgs::Marker& msg);
   private:
-    const MarkerTrajectory& trajectory_;
-    const MarkerSet& markerSet_;
+    MarkerPositionCache& cache_;
     std::size_t segmentId_;
+    double axisLength_;
   };
 } // end of namespace libmocap
 
@@ -37,10 +37,12 @@ namespace libmocap
 {
   MarkerTrajectoryView::MarkerTrajectoryView
   (const MarkerTrajectory& trajectory,
-   const MarkerSet& markerSet)
+   const MarkerSet& markerSet,
+   MarkerPositionCache& cache)
     : View (),
       trajectory_ (trajectory),
-      markerSet_ (markerSet)
+      markerSet_ (markerSet),
+      cache_ (cache)
   {
     msg_.points.resize (markerSet.markers ().size ());
     msg_.colors.resize (markerSet.markers ().size ());
@@ -52,16 +54,14 @@ namespace libmocap
   void
   MarkerTrajectoryView::updateMessage (int frameId, visualization_msgs::Marker& msg)
   {
-    std::size_t frameId_ =static_cast<std::size_t> (frameId);
-
     msg_.action = visualization_msgs::Marker::ADD;
 
-    if (frameId >= static_cast<int> (trajectory_.positions ().size ()))
+    if (frameId >= static_cast<int> (trajectory_.numRows ()))
       {
 	std::cerr << "size mismatch (trajectory)" << std::endl;
 	return;
       }
-    if (trajectory_.positions ()[frameId_].empty ())
+    if (!trajectory_.numCols ())
       {
 	std::cerr << "size mismatch (frame in trajectory)" << std::endl;
 	return;
@@ -79,8 +79,7 @@ namespace libmocap
 	  }
 
 	const AbstractMarker& marker = *markerSet_.markers ()[i];
-	double position[3];
-	marker.position (position, markerSet_, trajectory_, frameId);
+	const double* position = cache_.position (i, frameId);
 
 	std::size_t id = i - missingData;
 	msg.points[id].x = position[0];
@@ -31,6 +31,7 @@
 #ifndef LIBMOCAP_ROS_VIEWER_MARKER_TRAJECTORY_VIEW_HH
 # define LIBMOCAP_ROS_VIEWER_MARKER_TRAJECTORY_VIEW_HH
 # include <libmocap/marker-trajectory.hh>
+# include <libmocap/marker-position-cache.hh>
 # include <libmocap/marker-set.hh>
 
 # include "view.hh"
@@ -41,7 +42,8 @@ namespace libmocap
   {
   public:
     MarkerTrajectoryView (const MarkerTrajectory&,
-			  const MarkerSet&);
+			  const MarkerSet&,
+			  MarkerPositionCache&);
     ~MarkerTrajectoryView ();
 
     virtual void
@@ -49,6 +51,7 @@ namespace libmocap
   private:
     const MarkerTrajectory& trajectory_;
     const MarkerSet& markerSet_;
+    MarkerPositionCache& cache_;
   };
 } // end of namespace libmocap
 
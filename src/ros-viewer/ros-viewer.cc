@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <libmocap/marker-position-cache.hh>
 #include <libmocap/marker-set-factory.hh>
 #include <libmocap/marker-trajectory-factory.hh>
 
@@ -29,15 +30,22 @@ namespace libmocap
 	pub_ (n.advertise<visualization_msgs::MarkerArray>
 	      ("markers", 1, true)),
 	msg_ (),
+	cache_ (markerSet, trajectory),
 	views_ ()
     {
-      views_.push_back (new MarkerTrajectoryView (trajectory, markerSet));
-      views_.push_back (new MarkerSetLinkView (trajectory, markerSet));
+      // All views share the same cache so that markers are evaluated
+      // once per frame.
+      views_.push_back
+	(new MarkerTrajectoryView (trajectory, markerSet, cache_));
+      views_.push_back
+	(new MarkerSetLinkView (trajectory, markerSet, cache_));
 
       for (std::size_t i = 0; i < markerSet.markers ().size (); ++i)
-	views_.push_back (new MarkerSetNameView (trajectory, markerSet, i));
+	views_.push_back
+	  (new MarkerSetNameView (trajectory, markerSet, cache_, i));
       for (std::size_t i = 0; i < markerSet.segments ().size (); ++i)
-	views_.push_back (new MarkerSetSegmentView (trajectory, markerSet, i));
+	views_.push_back
+	  (new MarkerSetSegmentView (markerSet, cache_, i));
     }
 
     ~MarkerPublisher ()
@@ -68,6 +76,7 @@ namespace libmocap
     ros::Publisher pub_;
     visualization_msgs::MarkerArray msg_;
 
+    MarkerPositionCache cache_;
     std::vector<View*> views_;
   };
 } // end of namespace libmocap.
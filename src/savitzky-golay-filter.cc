@@ -0,0 +1,175 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <libmocap/savitzky-golay-filter.hh>
+
+namespace libmocap
+{
+  SavitzkyGolayFilter::SavitzkyGolayFilter ()
+    : AbstractTrajectoryFilter (),
+      windowLength_ (11),
+      polynomialOrder_ (3)
+  {}
+
+  SavitzkyGolayFilter::SavitzkyGolayFilter (int windowLength,
+					    int polynomialOrder)
+    : AbstractTrajectoryFilter (),
+      windowLength_ (windowLength),
+      polynomialOrder_ (polynomialOrder)
+  {}
+
+  SavitzkyGolayFilter::~SavitzkyGolayFilter ()
+  {}
+
+  void
+  SavitzkyGolayFilter::coefficients (std::vector<double>& coefficients,
+				     double) const
+  {
+    if (windowLength_ < 1 || windowLength_ % 2 == 0)
+      throw std::runtime_error
+	("Savitzky-Golay window length must be a positive odd number");
+    if (polynomialOrder_ < 0 || polynomialOrder_ >= windowLength_)
+      throw std::runtime_error
+	("Savitzky-Golay polynomial order must be lower than the window"
+	 " length");
+
+    const std::size_t w = static_cast<std::size_t> (windowLength_);
+    const std::size_t p = static_cast<std::size_t> (polynomialOrder_) + 1;
+    const std::size_t half = w / 2;
+
+    // Abscissas are scaled to [-1, 1] to keep the system well
+    // conditioned.
+    std::vector<double> powers (w * p);
+    for (std::size_t j = 0; j < w; ++j)
+      {
+	const double x = half
+	  ? (static_cast<double> (j) - static_cast<double> (half))
+	  / static_cast<double> (half)
+	  : 0.;
+	double power = 1.;
+	for (std::size_t k = 0; k < p; ++k, power *= x)
+	  powers[j * p + k] = power;
+      }
+
+    // Solve (A^T A) C = A^T, with A the w x p Vandermonde matrix, by
+    // Gauss-Jordan elimination with partial pivoting.
+    std::vector<double> normal (p * p, 0.);
+    std::vector<double> c (p * w);
+    for (std::size_t k = 0; k < p; ++k)
+      {
+	for (std::size_t l = 0; l < p; ++l)
+	  for (std::size_t j = 0; j < w; ++j)
+	    normal[k * p + l] += powers[j * p + k] * powers[j * p + l];
+	for (std::size_t j = 0; j < w; ++j)
+	  c[k * w + j] = powers[j * p + k];
+      }
+
+    for (std::size_t k = 0; k < p; ++k)
+      {
+	std::size_t pivot = k;
+	for (std::size_t l = k + 1; l < p; ++l)
+	  if (std::fabs (normal[l * p + k]) > std::fabs (normal[pivot * p + k]))
+	    pivot = l;
+	for (std::size_t l = 0; l < p; ++l)
+	  std::swap (normal[k * p + l], normal[pivot * p + l]);
+	for (std::size_t j = 0; j < w; ++j)
+	  std::swap (c[k * w + j], c[pivot * w + j]);
+
+	const double diagonal = normal[k * p + k];
+	for (std::size_t l = 0; l < p; ++l)
+	  normal[k * p + l] /= diagonal;
+	for (std::size_t j = 0; j < w; ++j)
+	  c[k * w + j] /= diagonal;
+
+	for (std::size_t r = 0; r < p; ++r)
+	  {
+	    if (r == k)
+	      continue;
+	    const double factor = normal[r * p + k];
+	    for (std::size_t l = 0; l < p; ++l)
+	      normal[r * p + l] -= factor * normal[k * p + l];
+	    for (std::size_t j = 0; j < w; ++j)
+	      c[r * w + j] -= factor * c[k * w + j];
+	  }
+      }
+
+    // Row t of the table holds the weights evaluating the fitted
+    // polynomial at the t-th sample of the window.
+    coefficients.assign (w * w, 0.);
+    for (std::size_t t = 0; t < w; ++t)
+      for (std::size_t k = 0; k < p; ++k)
+	for (std::size_t j = 0; j < w; ++j)
+	  coefficients[t * w + j] += powers[t * p + k] * c[k * w + j];
+  }
+
+  void
+  SavitzkyGolayFilter::filterSegment
+  (double* samples, std::size_t size,
+   const std::vector<double>& coefficients) const
+  {
+    const std::size_t w = static_cast<std::size_t> (windowLength_);
+    const std::size_t half = w / 2;
+    if (size < w)
+      return;
+
+    std::vector<double> result (size);
+    for (std::size_t i = 0; i < size; ++i)
+      {
+	std::size_t start;
+	std::size_t t;
+	if (i < half)
+	  {
+	    start = 0;
+	    t = i;
+	  }
+	else if (i + half >= size)
+	  {
+	    start = size - w;
+	    t = i - start;
+	  }
+	else
+	  {
+	    start = i - half;
+	    t = half;
+	  }
+
+	const double* weights = &coefficients[t * w];
+	double value = 0.;
+	for (std::size_t j = 0; j < w; ++j)
+	  value += weights[j] * samples[start + j];
+	result[i] = value;
+      }
+    std::copy (result.begin (), result.end (), samples);
+  }
+
+} // end of namespace libmocap.
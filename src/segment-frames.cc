@@ -0,0 +1,260 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <libmocap/marker-set.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/segment-frames.hh>
+
+#include "math.hh"
+
+namespace libmocap
+{
+  namespace
+  {
+    /// \brief Number of frames processed at once.
+    static const std::size_t blockSize = 256;
+
+    /// \brief Squared sine of the angle between the long and plane
+    /// axes below which the markers are considered collinear.
+    static const double collinearThreshold = 1e-12;
+
+    std::size_t
+    segmentMarker (const MarkerSet& markerSet, const Segment& segment,
+		   int marker, const char* role)
+    {
+      std::ostringstream error;
+      error << "segment " << segment.name () << ": ";
+      if (marker < 0)
+	{
+	  error << "negative " << role << " marker";
+	  throw std::runtime_error (error.str ());
+	}
+      if (static_cast<std::size_t> (marker) >= markerSet.markers ().size ())
+	{
+	  error << role << " marker id too large";
+	  throw std::runtime_error (error.str ());
+	}
+      return static_cast<std::size_t> (marker);
+    }
+
+    // result = lhs * rhs for 3x3 row-major matrices.
+    void
+    multiply (double result[9], const double lhs[9], const double rhs[9])
+    {
+      for (std::size_t i = 0; i < 3; ++i)
+	for (std::size_t j = 0; j < 3; ++j)
+	  result[3 * i + j] =
+	    lhs[3 * i] * rhs[j]
+	    + lhs[3 * i + 1] * rhs[3 + j]
+	    + lhs[3 * i + 2] * rhs[6 + j];
+    }
+
+    // Rz (yaw) * Ry (pitch) * Rx (roll).
+    void
+    rotationOffsetMatrix (double result[9],
+			  const Segment::RotationOffset& offset)
+    {
+      double cr = std::cos (offset.roll ());
+      double sr = std::sin (offset.roll ());
+      double cp = std::cos (offset.pitch ());
+      double sp = std::sin (offset.pitch ());
+      double cy = std::cos (offset.yaw ());
+      double sy = std::sin (offset.yaw ());
+
+      const double rx[9] = {1., 0., 0., 0., cr, -sr, 0., sr, cr};
+      const double ry[9] = {cp, 0., sp, 0., 1., 0., -sp, 0., cp};
+      const double rz[9] = {cy, -sy, 0., sy, cy, 0., 0., 0., 1.};
+
+      double rzy[9];
+      multiply (rzy, rz, ry);
+      multiply (result, rzy, rx);
+    }
+  } // end of anonymous namespace.
+
+  const std::size_t SegmentFrames::frameSize;
+
+  SegmentFrames::SegmentFrames ()
+    : program_ (),
+      segments_ ()
+  {}
+
+  SegmentFrames::SegmentFrames (const MarkerSet& markerSet)
+    : program_ (markerSet),
+      segments_ (markerSet.segments ().size ())
+  {
+    for (std::size_t s = 0; s < segments_.size (); ++s)
+      {
+	const Segment& segment = markerSet.segments ()[s];
+	segments_[s].originMarker =
+	  segmentMarker (markerSet, segment, segment.originMarker (),
+			 "origin");
+	segments_[s].longAxisMarker =
+	  segmentMarker (markerSet, segment, segment.longAxisMarker (),
+			 "long axis");
+	segments_[s].planeAxisMarker =
+	  segmentMarker (markerSet, segment, segment.planeAxisMarker (),
+			 "plane axis");
+	rotationOffsetMatrix (segments_[s].rotationOffset,
+			      segment.rotationOffset ());
+      }
+  }
+
+  void
+  SegmentFrames::bind (const MarkerTrajectory& trajectory)
+  {
+    program_.bind (trajectory);
+  }
+
+  void
+  SegmentFrames::compute (double* frames,
+			  unsigned char* valid,
+			  const MarkerTrajectory& trajectory,
+			  int firstFrame,
+			  int numFrames) const
+  {
+    if (firstFrame < 0)
+      throw std::runtime_error ("negative frame id");
+    if (numFrames < 0)
+      throw std::runtime_error ("negative number of frames");
+    if (static_cast<std::size_t> (firstFrame)
+	+ static_cast<std::size_t> (numFrames)
+	> trajectory.numRows ())
+      throw std::runtime_error ("frame id is too large");
+
+    const std::size_t numSegments = segments_.size ();
+    if (!numSegments)
+      return;
+
+    const MarkerSetProgram* program = &program_;
+    MarkerSetProgram boundProgram;
+    if (!program_.bound (trajectory))
+      {
+	boundProgram = program_;
+	boundProgram.bind (trajectory);
+	program = &boundProgram;
+      }
+
+    const std::size_t totalFrames = static_cast<std::size_t> (numFrames);
+    std::vector<double> positions
+      (3 * program->numMarkers () * std::min (blockSize, totalFrames));
+    std::vector<double> axes (3 * 3 * blockSize);
+    double* ox = &axes[0];
+    double* oy = &axes[3 * blockSize];
+    double* oz = &axes[6 * blockSize];
+    std::vector<double> norms (2 * blockSize);
+    double* planeNorm = &norms[0];
+    double* orthogonalNorm = &norms[blockSize];
+
+    for (std::size_t first = 0; first < totalFrames; first += blockSize)
+      {
+	const std::size_t n = std::min (blockSize, totalFrames - first);
+	program->evaluate (&positions[0], trajectory,
+			   firstFrame + static_cast<int> (first),
+			   static_cast<int> (n));
+
+	for (std::size_t s = 0; s < numSegments; ++s)
+	  {
+	    const SegmentData& segment = segments_[s];
+	    const double* origin = &positions[3 * segment.originMarker * n];
+	    const double* longAxis =
+	      &positions[3 * segment.longAxisMarker * n];
+	    const double* planeAxis =
+	      &positions[3 * segment.planeAxisMarker * n];
+
+	    // Gram-Schmidt orthonormalization, axis by axis over the
+	    // whole block.
+	    for (std::size_t i = 0; i < 3; ++i)
+	      for (std::size_t k = 0; k < n; ++k)
+		{
+		  ox[i * blockSize + k] =
+		    longAxis[i * n + k] - origin[i * n + k];
+		  oy[i * blockSize + k] =
+		    planeAxis[i * n + k] - origin[i * n + k];
+		}
+	    dot_prod (n, blockSize, planeNorm, oy, oy);
+	    proj (n, blockSize, oz, ox, oy);
+	    for (std::size_t i = 0; i < 3; ++i)
+	      for (std::size_t k = 0; k < n; ++k)
+		oy[i * blockSize + k] -= oz[i * blockSize + k];
+	    dot_prod (n, blockSize, orthogonalNorm, oy, oy);
+	    cross (n, blockSize, oz, ox, oy);
+	    normalize (n, blockSize, ox);
+	    normalize (n, blockSize, oy);
+	    normalize (n, blockSize, oz);
+
+	    const double* offset = segment.rotationOffset;
+	    for (std::size_t k = 0; k < n; ++k)
+	      {
+		const std::size_t index = (first + k) * numSegments + s;
+		double* frame = frames + index * frameSize;
+
+		// Coincident or collinear markers do not define a frame:
+		// the orthogonalized plane axis vanishes, or is NaN when
+		// the long axis itself vanishes.
+		bool missing = !(orthogonalNorm[k]
+				 > collinearThreshold * planeNorm[k]);
+		for (std::size_t i = 0; i < 3; ++i)
+		  missing = missing
+		    || std::isnan (origin[i * n + k])
+		    || std::isnan (longAxis[i * n + k])
+		    || std::isnan (planeAxis[i * n + k])
+		    || std::isnan (ox[i * blockSize + k])
+		    || std::isnan (oy[i * blockSize + k])
+		    || std::isnan (oz[i * blockSize + k]);
+
+		if (valid)
+		  valid[index] = !missing;
+		if (missing)
+		  {
+		    std::fill (frame, frame + frameSize,
+			       std::numeric_limits<double>::quiet_NaN ());
+		    continue;
+		  }
+
+		for (std::size_t i = 0; i < 3; ++i)
+		  {
+		    for (std::size_t j = 0; j < 3; ++j)
+		      frame[3 * i + j] =
+			ox[i * blockSize + k] * offset[j]
+			+ oy[i * blockSize + k] * offset[3 + j]
+			+ oz[i * blockSize + k] * offset[6 + j];
+		    frame[9 + i] = origin[i * n + k];
+		  }
+	      }
+	  }
+      }
+  }
+
+} // end of namespace libmocap.
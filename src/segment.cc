@@ -35,6 +35,7 @@ namespace libmocap
   Segment::Segment ()
     : id_ (),
       name_ (),
+      parent_ (-1),
       children_ (),
       originMarker_ (),
       longAxisMarker_ (),
@@ -45,6 +46,7 @@ namespace libmocap
   Segment::Segment (const Segment& rhs)
     : id_ (rhs.id_),
       name_ (rhs.name_),
+      parent_ (rhs.parent_),
       children_ (rhs.children_),
       originMarker_ (rhs.originMarker_),
       longAxisMarker_ (rhs.longAxisMarker_),
@@ -62,6 +64,7 @@ namespace libmocap
       return *this;
     id_ = rhs.id_;
     name_ = rhs.name_;
+    parent_ = rhs.parent_;
     children_ = rhs.children_;
     originMarker_ = rhs.originMarker_;
     longAxisMarker_ = rhs.longAxisMarker_;
@@ -77,7 +80,7 @@ namespace libmocap
       << "segment:\n"
       << "id: " << id () << '\n'
       << "name: " << name () << '\n'
-      << "name: " << name () << '\n'
+      << "parent: " << parent () << '\n'
       << "number of children: " << children ().size () << '\n'
       << "origin marker: " << originMarker () << '\n'
       << "long axis marker: " << longAxisMarker () << '\n'
@@ -0,0 +1,208 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <libmocap/marker-set.hh>
+#include <libmocap/skeleton-frames.hh>
+
+namespace libmocap
+{
+  namespace
+  {
+    static const std::size_t frameSize = SegmentFrames::frameSize;
+
+    // result = inverse (parent) * child
+    void
+    relativeTransform (double result[12],
+		       const double parent[12], const double child[12])
+    {
+      double dt[3];
+      for (std::size_t i = 0; i < 3; ++i)
+	dt[i] = child[9 + i] - parent[9 + i];
+
+      for (std::size_t i = 0; i < 3; ++i)
+	{
+	  for (std::size_t j = 0; j < 3; ++j)
+	    result[3 * i + j] =
+	      parent[i] * child[j]
+	      + parent[3 + i] * child[3 + j]
+	      + parent[6 + i] * child[6 + j];
+	  result[9 + i] =
+	    parent[i] * dt[0] + parent[3 + i] * dt[1] + parent[6 + i] * dt[2];
+	}
+    }
+
+    // result = parent * joint
+    void
+    composeTransforms (double result[12],
+		       const double parent[12], const double joint[12])
+    {
+      for (std::size_t i = 0; i < 3; ++i)
+	{
+	  for (std::size_t j = 0; j < 3; ++j)
+	    result[3 * i + j] =
+	      parent[3 * i] * joint[j]
+	      + parent[3 * i + 1] * joint[3 + j]
+	      + parent[3 * i + 2] * joint[6 + j];
+	  result[9 + i] =
+	    parent[3 * i] * joint[9]
+	    + parent[3 * i + 1] * joint[10]
+	    + parent[3 * i + 2] * joint[11]
+	    + parent[9 + i];
+	}
+    }
+  } // end of anonymous namespace.
+
+  SkeletonFrames::SkeletonFrames ()
+    : segmentFrames_ (),
+      order_ (),
+      parents_ ()
+  {}
+
+  SkeletonFrames::SkeletonFrames (const MarkerSet& markerSet)
+    : segmentFrames_ (markerSet),
+      order_ (),
+      parents_ ()
+  {
+    const std::vector<Segment>& segments = markerSet.segments ();
+    const std::size_t numSegments = segments.size ();
+
+    parents_.reserve (numSegments);
+    for (std::size_t s = 0; s < numSegments; ++s)
+      {
+	if (segments[s].parent () >= static_cast<int> (numSegments))
+	  {
+	    std::ostringstream error;
+	    error << "segment " << segments[s].name ()
+		  << ": parent id too large";
+	    throw std::runtime_error (error.str ());
+	  }
+	parents_.push_back (std::max (segments[s].parent (), -1));
+      }
+
+    // Breadth-first traversal from the roots.
+    std::vector<std::vector<std::size_t> > children (numSegments);
+    for (std::size_t s = 0; s < numSegments; ++s)
+      if (parents_[s] < 0)
+	order_.push_back (s);
+      else
+	children[static_cast<std::size_t> (parents_[s])].push_back (s);
+
+    for (std::size_t i = 0; i < order_.size (); ++i)
+      order_.insert (order_.end (),
+		     children[order_[i]].begin (),
+		     children[order_[i]].end ());
+
+    if (order_.size () != numSegments)
+      throw std::runtime_error ("cyclic segment hierarchy");
+  }
+
+  void
+  SkeletonFrames::compute (double* worldFrames,
+			   double* jointFrames,
+			   unsigned char* valid,
+			   const MarkerTrajectory& trajectory,
+			   int firstFrame,
+			   int numFrames) const
+  {
+    const std::size_t numSegments = parents_.size ();
+    const std::size_t n = static_cast<std::size_t> (std::max (numFrames, 0));
+
+    std::vector<unsigned char> worldValid (n * numSegments);
+    segmentFrames_.compute (worldFrames,
+			    worldValid.empty () ? 0 : &worldValid[0],
+			    trajectory, firstFrame, numFrames);
+
+    for (std::size_t k = 0; k < n; ++k)
+      {
+	const std::size_t base = k * numSegments;
+	std::vector<std::size_t>::const_iterator it;
+	for (it = order_.begin (); it != order_.end (); ++it)
+	  {
+	    const std::size_t s = *it;
+	    const double* world = worldFrames + (base + s) * frameSize;
+	    double* joint = jointFrames + (base + s) * frameSize;
+	    bool ok = worldValid[base + s] != 0;
+
+	    if (parents_[s] < 0)
+	      std::copy (world, world + frameSize, joint);
+	    else
+	      {
+		const std::size_t parent =
+		  static_cast<std::size_t> (parents_[s]);
+		ok = ok && worldValid[base + parent];
+		relativeTransform
+		  (joint, worldFrames + (base + parent) * frameSize, world);
+	      }
+
+	    if (!ok)
+	      std::fill (joint, joint + frameSize,
+			 std::numeric_limits<double>::quiet_NaN ());
+	    if (valid)
+	      valid[base + s] = ok;
+	  }
+      }
+  }
+
+  void
+  SkeletonFrames::forward (double* worldFrames,
+			   const double* jointFrames,
+			   std::size_t numFrames) const
+  {
+    const std::size_t numSegments = parents_.size ();
+
+    for (std::size_t k = 0; k < numFrames; ++k)
+      {
+	const std::size_t base = k * numSegments;
+	std::vector<std::size_t>::const_iterator it;
+	for (it = order_.begin (); it != order_.end (); ++it)
+	  {
+	    const std::size_t s = *it;
+	    const double* joint = jointFrames + (base + s) * frameSize;
+	    double* world = worldFrames + (base + s) * frameSize;
+
+	    // Parents come first: their world transform is already
+	    // available.
+	    if (parents_[s] < 0)
+	      std::copy (joint, joint + frameSize, world);
+	    else
+	      composeTransforms
+		(world,
+		 worldFrames
+		 + (base + static_cast<std::size_t> (parents_[s])) * frameSize,
+		 joint);
+	  }
+      }
+  }
+
+} // end of namespace libmocap.
@@ -27,6 +27,10 @@
 // THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <limits>
+#include <locale>
+#include <sstream>
+
 #include "string.hh"
 
 namespace libmocap
@@ -51,4 +55,187 @@ namespace libmocap
     s.erase (s.find_last_not_of (' ') + 1);
   }
 
+  namespace
+  {
+    /// Exactly representable powers of ten.
+    const double powersOfTen[] =
+      {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+      };
+
+    bool isDigit (char c)
+    {
+      return c >= '0' && c <= '9';
+    }
+
+    /// Case-insensitive match of a lower case word.
+    const char* matchWord (const char* first, const char* last,
+			   const char* word)
+    {
+      for (; *word; ++word, ++first)
+	if (first == last || (*first | 0x20) != *word)
+	  return 0;
+      return first;
+    }
+
+    /// Parse the digits of an unsigned integer, null on overflow.
+    template <typename T>
+    const char* parseDigits (const char* first, const char* last,
+			     T& value, T max)
+    {
+      if (first == last || !isDigit (*first))
+	return 0;
+      T result = 0;
+      for (; first < last && isDigit (*first); ++first)
+	{
+	  T digit = static_cast<T> (*first - '0');
+	  if (result > (max - digit) / 10)
+	    return 0;
+	  result = static_cast<T> (result * 10 + digit);
+	}
+      value = result;
+      return first;
+    }
+  } // end of anonymous namespace.
+
+  // Decimal numbers are parsed into an integer mantissa and a power
+  // of ten. When both are small enough to be represented exactly
+  // as doubles, a single multiplication or division yields the
+  // correctly rounded result (Clinger's fast path). This covers the
+  // fixed-point values written in TRC and MARS files. Other numbers
+  // fall back to a stream using the classic locale.
+  const char* parseNumber (const char* first, const char* last,
+			   double& value)
+  {
+    const char* p = first;
+    bool negative = false;
+    if (p < last && (*p == '-' || *p == '+'))
+      negative = *p++ == '-';
+
+    if (const char* end = matchWord (p, last, "nan"))
+      {
+	value = std::numeric_limits<double>::quiet_NaN ();
+	return end;
+      }
+    if (const char* end = matchWord (p, last, "inf"))
+      {
+	if (const char* longEnd = matchWord (end, last, "inity"))
+	  end = longEnd;
+	value = negative
+	  ? -std::numeric_limits<double>::infinity ()
+	  : std::numeric_limits<double>::infinity ();
+	return end;
+      }
+
+    // 19 decimal digits always fit in 64 bits.
+    const int maxDigits = 19;
+    unsigned long long mantissa = 0;
+    int numDigits = 0;
+    int exponent = 0;
+    bool truncated = false;
+    bool hasDigits = false;
+
+    for (; p < last && isDigit (*p); ++p)
+      {
+	hasDigits = true;
+	if (numDigits < maxDigits)
+	  {
+	    mantissa = mantissa * 10 + static_cast<unsigned> (*p - '0');
+	    if (mantissa)
+	      ++numDigits;
+	  }
+	else
+	  {
+	    truncated = true;
+	    ++exponent;
+	  }
+      }
+    if (p < last && *p == '.')
+      for (++p; p < last && isDigit (*p); ++p)
+	{
+	  hasDigits = true;
+	  if (numDigits < maxDigits)
+	    {
+	      mantissa = mantissa * 10 + static_cast<unsigned> (*p - '0');
+	      if (mantissa)
+		++numDigits;
+	      --exponent;
+	    }
+	  else
+	    truncated = true;
+	}
+    if (!hasDigits)
+      return 0;
+
+    // The exponent is only consumed if it is well formed.
+    if (p < last && (*p == 'e' || *p == 'E'))
+      {
+	const char* e = p + 1;
+	bool negativeExponent = false;
+	if (e < last && (*e == '-' || *e == '+'))
+	  negativeExponent = *e++ == '-';
+	if (e < last && isDigit (*e))
+	  {
+	    int explicitExponent = 0;
+	    for (; e < last && isDigit (*e); ++e)
+	      if (explicitExponent < 100000)
+		explicitExponent =
+		  explicitExponent * 10 + (*e - '0');
+	    exponent += negativeExponent
+	      ? -explicitExponent : explicitExponent;
+	    p = e;
+	  }
+      }
+
+    if (!truncated && mantissa <= (1ULL << 53)
+	&& exponent >= -22 && exponent <= 22)
+      {
+	double result = static_cast<double> (mantissa);
+	if (exponent < 0)
+	  result /= powersOfTen[-exponent];
+	else
+	  result *= powersOfTen[exponent];
+	value = negative ? -result : result;
+	return p;
+      }
+
+    std::istringstream stream (std::string (first, p));
+    stream.imbue (std::locale::classic ());
+    double result;
+    if (!(stream >> result))
+      return 0;
+    value = result;
+    return p;
+  }
+
+  const char* parseNumber (const char* first, const char* last, int& value)
+  {
+    bool negative = false;
+    if (first < last && (*first == '-' || *first == '+'))
+      negative = *first++ == '-';
+
+    // The magnitude of INT_MIN is one more than INT_MAX.
+    const unsigned max = negative
+      ? static_cast<unsigned> (std::numeric_limits<int>::max ()) + 1u
+      : static_cast<unsigned> (std::numeric_limits<int>::max ());
+    unsigned magnitude;
+    const char* end = parseDigits (first, last, magnitude, max);
+    if (!end)
+      return 0;
+    value = negative
+      ? static_cast<int> (0u - magnitude)
+      : static_cast<int> (magnitude);
+    return end;
+  }
+
+  const char* parseNumber (const char* first, const char* last,
+			   std::size_t& value)
+  {
+    if (first < last && *first == '+')
+      ++first;
+    return parseDigits (first, last, value,
+			std::numeric_limits<std::size_t>::max ());
+  }
+
 } // end of namespace libmocap
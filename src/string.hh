@@ -30,8 +30,9 @@
 
 #ifndef LIBMOCAP_STRING_HH
 # define LIBMOCAP_STRING_HH
+# include <cstddef>
+# include <stdexcept>
 # include <string>
-# include <sstream>
 
 namespace libmocap
 {
@@ -39,13 +40,61 @@ namespace libmocap
   void trimEndOfLine (std::string& s);
   void trimWhitespace (std::string& s);
 
+  inline bool isBlank (char c)
+  {
+    return c == ' '
+      || c == '\t'
+      || c == '\r'
+      || c == '\b';
+  }
+
+  /// \name Number parsing.
+  ///
+  /// These functions parse the number starting at first, without
+  /// skipping any whitespace, and return a pointer to the first
+  /// character after it. Parsing does not depend on the current
+  /// locale: the decimal separator is always a dot.
+  ///
+  /// Integers and the fixed-point decimals found in TRC files are
+  /// parsed without allocating. Decimals whose significand does not
+  /// fit in 53 bits, or whose decimal exponent exceeds 22 in
+  /// magnitude, fall back to a stream, which allocates.
+  ///
+  /// If no number can be parsed, or if it is out of the range of
+  /// the type, null is returned and value is left unchanged.
+  /// \{
+  const char* parseNumber (const char* first, const char* last,
+			   double& value);
+  const char* parseNumber (const char* first, const char* last,
+			   int& value);
+  const char* parseNumber (const char* first, const char* last,
+			   std::size_t& value);
+  /// \}
+
+  /// \brief Convert the character range [first, last) in place.
+  ///
+  /// Leading and trailing blanks are ignored but the remaining
+  /// characters must form exactly one number, or a
+  /// std::runtime_error is thrown.
+  template <typename T>
+  T convert (const char* first, const char* last)
+  {
+    while (first < last && isBlank (*first))
+      ++first;
+    while (last > first && isBlank (last[-1]))
+      --last;
+
+    T value = T ();
+    if (parseNumber (first, last, value) != last || first == last)
+      throw std::runtime_error
+	("invalid number `" + std::string (first, last) + "'");
+    return value;
+  }
+
   template <typename T>
   T convert (const std::string& s)
   {
-    T res;
-    std::istringstream ss (s);
-    ss >> res;
-    return res;
+    return convert<T> (s.data (), s.data () + s.size ());
   }
 } // end of namespace libmocap
 
@@ -0,0 +1,143 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include "thread-pool.hh"
+
+namespace libmocap
+{
+  namespace
+  {
+    struct WorkQueue
+    {
+      const std::vector<ThreadPool::Task*>* tasks;
+      std::size_t next;
+      bool failed;
+      std::string error;
+      pthread_mutex_t mutex;
+    };
+
+    void fail (WorkQueue& queue, const std::string& error)
+    {
+      pthread_mutex_lock (&queue.mutex);
+      if (!queue.failed)
+	{
+	  queue.failed = true;
+	  queue.error = error;
+	}
+      pthread_mutex_unlock (&queue.mutex);
+    }
+
+    void* work (void* arg)
+    {
+      WorkQueue& queue = *static_cast<WorkQueue*> (arg);
+      while (true)
+	{
+	  pthread_mutex_lock (&queue.mutex);
+	  std::size_t taskId = queue.next++;
+	  pthread_mutex_unlock (&queue.mutex);
+
+	  if (taskId >= queue.tasks->size ())
+	    break;
+
+	  try
+	    {
+	      if ((*queue.tasks)[taskId])
+		(*queue.tasks)[taskId]->run ();
+	    }
+	  catch (const std::exception& e)
+	    {
+	      fail (queue, e.what ());
+	    }
+	  catch (...)
+	    {
+	      fail (queue, "unknown error in worker thread");
+	    }
+	}
+      return 0;
+    }
+  } // end of anonymous namespace.
+
+  ThreadPool::Task::~Task ()
+  {}
+
+  ThreadPool::ThreadPool (std::size_t numThreads)
+    : numThreads_ (numThreads ? numThreads : hardwareConcurrency ())
+  {}
+
+  ThreadPool::~ThreadPool ()
+  {}
+
+  void
+  ThreadPool::run (const std::vector<Task*>& tasks)
+  {
+    WorkQueue queue;
+    queue.tasks = &tasks;
+    queue.next = 0;
+    queue.failed = false;
+    pthread_mutex_init (&queue.mutex, 0);
+
+    std::size_t numWorkers = std::min (numThreads_, tasks.size ());
+    std::vector<pthread_t> workers;
+    workers.reserve (numWorkers);
+
+    // The calling thread works too, so start one thread less.
+    for (std::size_t i = 1; i < numWorkers; ++i)
+      {
+	pthread_t worker;
+	if (pthread_create (&worker, 0, &work, &queue) != 0)
+	  break;
+	workers.push_back (worker);
+      }
+
+    work (&queue);
+
+    for (std::size_t i = 0; i < workers.size (); ++i)
+      pthread_join (workers[i], 0);
+    pthread_mutex_destroy (&queue.mutex);
+
+    if (queue.failed)
+      throw std::runtime_error (queue.error);
+  }
+
+  std::size_t
+  ThreadPool::hardwareConcurrency ()
+  {
+    long n = sysconf (_SC_NPROCESSORS_ONLN);
+    return n > 0 ? static_cast<std::size_t> (n) : 1;
+  }
+
+} // end of namespace libmocap
@@ -0,0 +1,79 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_THREAD_POOL_HH
+# define LIBMOCAP_THREAD_POOL_HH
+# include <cstddef>
+# include <vector>
+
+namespace libmocap
+{
+  /// \brief Run independent tasks on a fixed number of threads.
+  ///
+  /// Worker threads are started by run and pick tasks in order until
+  /// none is left. The calling thread is one of the workers.
+  ///
+  /// If any task throws, the remaining tasks are still executed and
+  /// the first error is reported by run as a std::runtime_error once
+  /// all the workers are done.
+  class ThreadPool
+  {
+  public:
+    class Task
+    {
+    public:
+      virtual ~Task ();
+      virtual void run () = 0;
+    };
+
+    /// \param numThreads number of threads, zero meaning one per
+    /// available core.
+    explicit ThreadPool (std::size_t numThreads);
+    ~ThreadPool ();
+
+    std::size_t numThreads () const
+    {
+      return numThreads_;
+    }
+
+    void run (const std::vector<Task*>& tasks);
+
+    /// \brief Number of cores available on this machine.
+    static std::size_t hardwareConcurrency ();
+
+  private:
+    ThreadPool (const ThreadPool&);
+    ThreadPool& operator= (const ThreadPool&);
+
+    std::size_t numThreads_;
+  };
+} // end of namespace libmocap
+
+#endif //! LIBMOCAP_THREAD_POOL_HH
@@ -0,0 +1,219 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <libmocap/binary-marker-trajectory-reader.hh>
+#include <libmocap/binary-marker-trajectory-writer.hh>
+
+#include "binary-marker-trajectory-format.hh"
+#include "mapped-file.hh"
+#include "trajectory-cache.hh"
+
+namespace libmocap
+{
+  namespace
+  {
+    const char trailerMagic[] = "LMCACHE2";
+    const std::size_t trailerMagicSize = 8;
+    const std::size_t trailerSize = trailerMagicSize + 4 * 8;
+
+    // 64-bit hash processing the data eight bytes at a time, so that
+    // hashing is much cheaper than parsing the file again.
+    uint64_t hashContent (const char* data, std::size_t size)
+    {
+      const uint64_t prime = 0x100000001b3ULL;
+      uint64_t hash = 0xcbf29ce484222325ULL ^ size;
+      uint64_t word;
+
+      std::size_t i = 0;
+      for (; i + sizeof (word) <= size; i += sizeof (word))
+	{
+	  std::memcpy (&word, data + i, sizeof (word));
+	  hash = (hash ^ word) * prime;
+	  hash ^= hash >> 29;
+	}
+      for (; i < size; ++i)
+	hash = (hash ^ static_cast<unsigned char> (data[i])) * prime;
+      return hash;
+    }
+
+    void writeKey (std::ofstream& file, uint64_t value)
+    {
+      binaryTrajectory::toLittleEndian (&value, sizeof (value));
+      file.write (reinterpret_cast<const char*> (&value), sizeof (value));
+    }
+  } // end of anonymous namespace.
+
+  TrajectoryCache::TrajectoryCache (const std::string& directory, bool hash)
+    : directory_ (directory),
+      hash_ (hash),
+      source_ (),
+      fingerprint_ ()
+  {}
+
+  TrajectoryCache::~TrajectoryCache ()
+  {}
+
+  std::string
+  TrajectoryCache::entryPath (const std::string& filename) const
+  {
+    if (directory_.empty ())
+      return filename + ".cache.btrc";
+
+    // Entries of files with the same name but living in different
+    // directories must not collide.
+    std::string path = filename;
+    char* absolutePath = ::realpath (filename.c_str (), 0);
+    if (absolutePath)
+      {
+	path = absolutePath;
+	std::free (absolutePath);
+      }
+
+    std::string basename = path.substr (path.rfind ('/') + 1);
+    std::ostringstream stream;
+    stream << directory_ << '/' << basename << '.' << std::hex
+	   << hashContent (path.data (), path.size ()) << ".btrc";
+    return stream.str ();
+  }
+
+  bool
+  TrajectoryCache::fingerprint (const std::string& filename)
+  {
+    if (!source_.empty () && source_ == filename)
+      return true;
+    source_.clear ();
+
+    struct stat status;
+    if (::stat (filename.c_str (), &status) < 0)
+      return false;
+    fingerprint_.size = static_cast<uint64_t> (status.st_size);
+    fingerprint_.mtime = static_cast<int64_t> (status.st_mtim.tv_sec);
+    fingerprint_.mtimeNsec = static_cast<int64_t> (status.st_mtim.tv_nsec);
+    fingerprint_.hash = 0;
+    if (hash_)
+      {
+	MappedFile file (filename);
+	fingerprint_.hash = hashContent (file.data (), file.size ());
+      }
+    source_ = filename;
+    return true;
+  }
+
+  bool
+  TrajectoryCache::load (const std::string& filename,
+			 MarkerTrajectory& trajectory)
+  {
+    std::string entry = entryPath (filename);
+
+    try
+      {
+	if (!fingerprint (filename) || ::access (entry.c_str (), R_OK) < 0)
+	  return false;
+
+	{
+	  MappedFile file (entry);
+	  if (file.size () < trailerSize)
+	    return false;
+	  const char* trailer = file.data () + file.size () - trailerSize;
+	  if (std::memcmp (trailer, trailerMagic, trailerMagicSize) != 0)
+	    return false;
+	  trailer += trailerMagicSize;
+
+	  // Entries built without hashing store a null hash: they are
+	  // rebuilt the first time hashing is requested.
+	  using binaryTrajectory::read;
+	  if (read<uint64_t> (trailer) != fingerprint_.size
+	      || read<int64_t> (trailer + 8) != fingerprint_.mtime
+	      || read<int64_t> (trailer + 16) != fingerprint_.mtimeNsec
+	      || (hash_ && read<uint64_t> (trailer + 24) != fingerprint_.hash))
+	    return false;
+	}
+
+	BinaryMarkerTrajectoryReader reader (entry);
+	trajectory = reader.load ();
+	return true;
+      }
+    catch (const std::exception& e)
+      {
+	std::cerr << "warning: ignoring trajectory cache entry `"
+		  << entry << "': " << e.what () << std::endl;
+	return false;
+      }
+  }
+
+  void
+  TrajectoryCache::store (const std::string& filename,
+			  const MarkerTrajectory& trajectory)
+  {
+    std::string entry = entryPath (filename);
+    std::ostringstream tmpStream;
+    tmpStream << entry << ".tmp." << ::getpid ();
+    std::string tmp = tmpStream.str ();
+
+    try
+      {
+	if (!fingerprint (filename))
+	  throw std::runtime_error ("cannot stat source file");
+
+	BinaryMarkerTrajectoryWriter writer;
+	writer.write (tmp, trajectory);
+
+	std::ofstream file
+	  (tmp.c_str (), std::ios::out | std::ios::binary | std::ios::app);
+	file.exceptions (std::ofstream::failbit | std::ofstream::badbit);
+	file.write (trailerMagic, trailerMagicSize);
+	writeKey (file, fingerprint_.size);
+	writeKey (file, static_cast<uint64_t> (fingerprint_.mtime));
+	writeKey (file, static_cast<uint64_t> (fingerprint_.mtimeNsec));
+	writeKey (file, fingerprint_.hash);
+	file.close ();
+
+	if (std::rename (tmp.c_str (), entry.c_str ()) != 0)
+	  throw std::runtime_error ("cannot rename temporary file");
+      }
+    catch (const std::exception& e)
+      {
+	std::remove (tmp.c_str ());
+	std::cerr << "warning: failed to write trajectory cache entry `"
+		  << entry << "': " << e.what () << std::endl;
+      }
+  }
+
+} // end of namespace libmocap
@@ -0,0 +1,103 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_TRAJECTORY_CACHE_HH
+# define LIBMOCAP_TRAJECTORY_CACHE_HH
+# include <string>
+# include <stdint.h>
+
+# include <libmocap/marker-trajectory.hh>
+
+namespace libmocap
+{
+  /// \brief On-disk cache of parsed trajectories.
+  ///
+  /// A cache entry is a binary trajectory file (*.btrc) followed by
+  /// a trailer identifying the source file it has been built from:
+  /// its size, its modification time in nanoseconds and, optionally,
+  /// a hash of its content. An entry is only used if these keys
+  /// still match the source file, so that it is invalidated as soon
+  /// as the source changes.
+  ///
+  /// The source file is fingerprinted once, by load, before being
+  /// parsed; store reuses this fingerprint so that an entry never
+  /// claims to match a source modified while it was parsed.
+  ///
+  /// Entries are stored next to the source file, or in a dedicated
+  /// directory if one is given. They are written to a temporary file
+  /// first and then renamed so that concurrent processes never see a
+  /// partial entry.
+  class TrajectoryCache
+  {
+  public:
+    /// \param directory cache directory, empty to store entries next
+    /// to the source files.
+    /// \param hash also key entries on a hash of the source content.
+    explicit TrajectoryCache (const std::string& directory,
+			      bool hash = false);
+    ~TrajectoryCache ();
+
+    /// \brief Load the cached version of a file if it is up to date.
+    /// \return true if the cache has been used.
+    bool load (const std::string& filename, MarkerTrajectory& trajectory);
+
+    /// \brief Store the parsed version of a file.
+    ///
+    /// Failures are not fatal: they are reported on the standard
+    /// error and the cache is left untouched.
+    void store (const std::string& filename,
+		const MarkerTrajectory& trajectory);
+
+    /// \brief Path of the cache entry for a source file.
+    std::string entryPath (const std::string& filename) const;
+
+  private:
+    struct Fingerprint
+    {
+      uint64_t size;
+      int64_t mtime;
+      int64_t mtimeNsec;
+      uint64_t hash;
+    };
+
+    /// \brief Fingerprint a source file, reusing the last fingerprint
+    /// of the same file.
+    bool fingerprint (const std::string& filename);
+
+    std::string directory_;
+    bool hash_;
+
+    /// \brief Last fingerprinted source file and its fingerprint.
+    std::string source_;
+    Fingerprint fingerprint_;
+  };
+} // end of namespace libmocap
+
+#endif //! LIBMOCAP_TRAJECTORY_CACHE_HH
@@ -0,0 +1,272 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <libmocap/marker-set.hh>
+#include <libmocap/marker-set-program.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-columns.hh>
+#include <libmocap/trajectory-differentiator.hh>
+
+namespace libmocap
+{
+  namespace
+  {
+    /// Inverse time steps shared by all coordinates.
+    struct TimeSteps
+    {
+      /// 1 / (t[k + 1] - t[k])
+      std::vector<double> inverseStep;
+      /// 1 / (t[k + 1] - t[k - 1])
+      std::vector<double> inverseSpan;
+    };
+
+    void
+    computeTimeSteps (TimeSteps& steps, const double* time, std::size_t n)
+    {
+      steps.inverseStep.assign (n, 0.);
+      steps.inverseSpan.assign (n, 0.);
+      for (std::size_t k = 0; k + 1 < n; ++k)
+	{
+	  if (!(time[k + 1] > time[k]))
+	    throw std::runtime_error
+	      ("trajectory time is not strictly increasing");
+	  steps.inverseStep[k] = 1. / (time[k + 1] - time[k]);
+	}
+      for (std::size_t k = 1; k + 1 < n; ++k)
+	steps.inverseSpan[k] = 1. / (time[k + 1] - time[k - 1]);
+    }
+
+    /// Second derivative of the parabola through three samples.
+    double
+    secondDerivative (const double* p, const double* time,
+		      std::size_t i0, std::size_t i1, std::size_t i2)
+    {
+      return 2. * ((p[i2] - p[i1]) / (time[i2] - time[i1])
+		   - (p[i1] - p[i0]) / (time[i1] - time[i0]))
+	/ (time[i2] - time[i0]);
+    }
+
+    /// Differentiate one coordinate. Either output may be null.
+    void
+    differentiateCoordinate (double* v, double* a,
+			     const double* p, const double* time,
+			     std::size_t n, const TimeSteps& steps)
+    {
+      const double* inverseStep = &steps.inverseStep[0];
+      const double* inverseSpan = &steps.inverseSpan[0];
+
+      // Central differences. Missing samples propagate NaN to their
+      // neighbors, which are fixed below.
+      if (v)
+	for (std::size_t k = 1; k + 1 < n; ++k)
+	  v[k] = (p[k + 1] - p[k - 1]) * inverseSpan[k];
+      if (a)
+	for (std::size_t k = 1; k + 1 < n; ++k)
+	  a[k] = 2. * ((p[k + 1] - p[k]) * inverseStep[k]
+		       - (p[k] - p[k - 1]) * inverseStep[k - 1])
+	    * inverseSpan[k];
+
+      // One-sided differences at the ends and next to gaps.
+      const double nan = std::numeric_limits<double>::quiet_NaN ();
+      for (std::size_t k = 0; k < n; ++k)
+	{
+	  const bool valid = !std::isnan (p[k]);
+	  if (valid && k > 0 && k + 1 < n
+	      && (!v || !std::isnan (v[k]))
+	      && (!a || !std::isnan (a[k])))
+	    continue;
+
+	  const bool next = valid && k + 1 < n && !std::isnan (p[k + 1]);
+	  const bool previous = valid && k > 0 && !std::isnan (p[k - 1]);
+
+	  if (v)
+	    {
+	      if (next && previous)
+		v[k] = (p[k + 1] - p[k - 1]) * inverseSpan[k];
+	      else if (next)
+		v[k] = (p[k + 1] - p[k]) * inverseStep[k];
+	      else if (previous)
+		v[k] = (p[k] - p[k - 1]) * inverseStep[k - 1];
+	      else
+		v[k] = nan;
+	    }
+	  if (a)
+	    {
+	      if (next && previous)
+		a[k] = secondDerivative (p, time, k - 1, k, k + 1);
+	      else if (next && k + 2 < n && !std::isnan (p[k + 2]))
+		a[k] = secondDerivative (p, time, k, k + 1, k + 2);
+	      else if (previous && k > 1 && !std::isnan (p[k - 2]))
+		a[k] = secondDerivative (p, time, k - 2, k - 1, k);
+	      else
+		a[k] = nan;
+	    }
+	}
+    }
+
+    void
+    prepareResult (MarkerTrajectoryColumns& result,
+		   const MarkerTrajectoryColumns& positions)
+    {
+      const PositionMatrix& data = positions.data ();
+      result.data ().resize (data.numRows (), data.numCols ());
+      if (data.numRows ())
+	std::copy (positions.time (), positions.time () + data.numCols (),
+		   result.time ());
+    }
+
+    /// Copy the metadata of a trajectory, for a new set of markers.
+    void
+    setMetadata (MarkerTrajectory& result,
+		 const MarkerTrajectory& source,
+		 const std::vector<std::string>& markers)
+    {
+      result.filename () = source.filename ();
+      result.dataRate () = source.dataRate ();
+      result.cameraRate () = source.cameraRate ();
+      result.numFrames () = source.numFrames ();
+      result.numMarkers () = static_cast<int> (markers.size ());
+      result.units () = source.units ();
+      result.origDataRate () = source.origDataRate ();
+      result.origDataStartFrame () = source.origDataStartFrame ();
+      result.origNumFrames () = source.origNumFrames ();
+      result.firstFrame () = source.firstFrame ();
+      result.markers () = markers;
+      result.indexMarkers ();
+
+      // Derivatives are stored with the precision of the source.
+      result.resize (0, 0);
+      result.setPrecision (source.precision ());
+    }
+
+    void
+    differentiateColumns (const TrajectoryDifferentiator& differentiator,
+			  MarkerTrajectory* velocity,
+			  MarkerTrajectory* acceleration,
+			  const MarkerTrajectoryColumns& positions,
+			  const MarkerTrajectory& trajectory,
+			  const std::vector<std::string>& markers)
+    {
+      MarkerTrajectoryColumns velocityColumns;
+      MarkerTrajectoryColumns accelerationColumns;
+      differentiator.differentiate
+	(velocity ? &velocityColumns : 0,
+	 acceleration ? &accelerationColumns : 0,
+	 positions);
+
+      if (velocity)
+	{
+	  setMetadata (*velocity, trajectory, markers);
+	  velocityColumns.toTrajectory (*velocity);
+	}
+      if (acceleration)
+	{
+	  setMetadata (*acceleration, trajectory, markers);
+	  accelerationColumns.toTrajectory (*acceleration);
+	}
+    }
+  } // end of anonymous namespace.
+
+  TrajectoryDifferentiator::TrajectoryDifferentiator ()
+  {}
+
+  TrajectoryDifferentiator::~TrajectoryDifferentiator ()
+  {}
+
+  void
+  TrajectoryDifferentiator::differentiate
+  (MarkerTrajectoryColumns* velocity,
+   MarkerTrajectoryColumns* acceleration,
+   const MarkerTrajectoryColumns& positions) const
+  {
+    if (velocity)
+      prepareResult (*velocity, positions);
+    if (acceleration)
+      prepareResult (*acceleration, positions);
+
+    const std::size_t n = positions.numFrames ();
+    if (!n || (!velocity && !acceleration))
+      return;
+
+    TimeSteps steps;
+    computeTimeSteps (steps, positions.time (), n);
+
+    for (std::size_t marker = 0; marker < positions.numMarkers (); ++marker)
+      for (std::size_t axis = 0; axis < 3; ++axis)
+	differentiateCoordinate
+	  (velocity ? velocity->coordinate (marker, axis) : 0,
+	   acceleration ? acceleration->coordinate (marker, axis) : 0,
+	   positions.coordinate (marker, axis), positions.time (), n, steps);
+  }
+
+  void
+  TrajectoryDifferentiator::differentiate
+  (MarkerTrajectory* velocity,
+   MarkerTrajectory* acceleration,
+   const MarkerTrajectory& trajectory) const
+  {
+    MarkerTrajectoryColumns positions (trajectory);
+    differentiateColumns (*this, velocity, acceleration,
+			  positions, trajectory, trajectory.markers ());
+  }
+
+  void
+  TrajectoryDifferentiator::differentiate
+  (MarkerTrajectory* velocity,
+   MarkerTrajectory* acceleration,
+   const MarkerSet& markerSet,
+   const MarkerTrajectory& trajectory) const
+  {
+    // The batch evaluation layout of the program is the layout of
+    // MarkerTrajectoryColumns, without the time row.
+    MarkerSetProgram program (markerSet);
+    program.bind (trajectory);
+    const std::size_t numFrames = trajectory.numRows ();
+
+    MarkerTrajectoryColumns positions;
+    positions.data ().resize (1 + 3 * program.numMarkers (), numFrames);
+    for (std::size_t frame = 0; frame < numFrames; ++frame)
+      positions.time ()[frame] = trajectory.time (frame);
+    if (numFrames && program.numMarkers ())
+      program.evaluate (positions.x (0), trajectory, 0,
+			static_cast<int> (numFrames));
+    else
+      program.validate (trajectory);
+
+    differentiateColumns (*this, velocity, acceleration,
+			  positions, trajectory, program.markerNames ());
+  }
+
+} // end of namespace libmocap.
@@ -0,0 +1,244 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-columns.hh>
+#include <libmocap/trajectory-resampler.hh>
+
+#include "thread-pool.hh"
+
+namespace libmocap
+{
+  namespace
+  {
+    /// Location of the resampled frames in the source frames: frame
+    /// j lies in [time[interval[j]], time[interval[j] + 1]), at
+    /// fraction[j] of this interval.
+    struct Sampling
+    {
+      const double* time;
+      std::size_t numSourceFrames;
+      std::vector<std::size_t> interval;
+      std::vector<double> fraction;
+    };
+
+    /// Tangent at frame k, estimated from its valid neighbors.
+    double
+    tangent (const double* p, const double* time, std::size_t n,
+	     std::size_t k)
+    {
+      const bool previous = k > 0 && !std::isnan (p[k - 1]);
+      const bool next = k + 1 < n && !std::isnan (p[k + 1]);
+      if (previous && next)
+	return (p[k + 1] - p[k - 1]) / (time[k + 1] - time[k - 1]);
+      if (next)
+	return (p[k + 1] - p[k]) / (time[k + 1] - time[k]);
+      if (previous)
+	return (p[k] - p[k - 1]) / (time[k] - time[k - 1]);
+      return 0.;
+    }
+
+    void
+    resampleCoordinate (double* result, const double* p,
+			const Sampling& sampling,
+			TrajectoryResampler::Interpolation interpolation)
+    {
+      const double nan = std::numeric_limits<double>::quiet_NaN ();
+      const double* time = sampling.time;
+      const std::size_t n = sampling.numSourceFrames;
+
+      for (std::size_t j = 0; j < sampling.interval.size (); ++j)
+	{
+	  const std::size_t k = sampling.interval[j];
+	  const double u = sampling.fraction[j];
+	  if (u == 0.)
+	    {
+	      result[j] = p[k];
+	      continue;
+	    }
+
+	  const double p0 = p[k];
+	  const double p1 = p[k + 1];
+	  if (std::isnan (p0) || std::isnan (p1))
+	    {
+	      result[j] = nan;
+	      continue;
+	    }
+
+	  if (interpolation == TrajectoryResampler::LINEAR)
+	    {
+	      result[j] = p0 + (p1 - p0) * u;
+	      continue;
+	    }
+
+	  const double h = time[k + 1] - time[k];
+	  const double m0 = tangent (p, time, n, k);
+	  const double m1 = tangent (p, time, n, k + 1);
+	  const double u2 = u * u;
+	  const double u3 = u2 * u;
+	  result[j] = (2. * u3 - 3. * u2 + 1.) * p0
+	    + (u3 - 2. * u2 + u) * h * m0
+	    + (-2. * u3 + 3. * u2) * p1
+	    + (u3 - u2) * h * m1;
+	}
+    }
+
+    class MarkerResampler : public ThreadPool::Task
+    {
+    public:
+      MarkerResampler (MarkerTrajectoryColumns& result,
+		       const MarkerTrajectoryColumns& positions,
+		       const Sampling& sampling,
+		       TrajectoryResampler::Interpolation interpolation,
+		       std::size_t marker)
+	: result_ (&result),
+	  positions_ (&positions),
+	  sampling_ (&sampling),
+	  interpolation_ (interpolation),
+	  marker_ (marker)
+      {}
+
+      void run ()
+      {
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	  resampleCoordinate (result_->coordinate (marker_, axis),
+			      positions_->coordinate (marker_, axis),
+			      *sampling_, interpolation_);
+      }
+
+    private:
+      MarkerTrajectoryColumns* result_;
+      const MarkerTrajectoryColumns* positions_;
+      const Sampling* sampling_;
+      TrajectoryResampler::Interpolation interpolation_;
+      std::size_t marker_;
+    };
+  } // end of anonymous namespace.
+
+  TrajectoryResampler::TrajectoryResampler ()
+    : interpolation_ (LINEAR),
+      numThreads_ (0)
+  {}
+
+  TrajectoryResampler::TrajectoryResampler (Interpolation interpolation)
+    : interpolation_ (interpolation),
+      numThreads_ (0)
+  {}
+
+  void
+  TrajectoryResampler::resample (MarkerTrajectoryColumns& result,
+				 const MarkerTrajectoryColumns& positions,
+				 double dataRate) const
+  {
+    if (!(dataRate > 0.))
+      throw std::runtime_error ("invalid data rate");
+    if (numThreads_ < 0)
+      throw std::runtime_error ("invalid number of threads");
+
+    const std::size_t n = positions.numFrames ();
+    const std::size_t numRows = positions.data ().numRows ();
+    if (!n)
+      {
+	result.data ().resize (numRows, 0);
+	return;
+      }
+
+    const double* time = positions.time ();
+    for (std::size_t k = 0; k + 1 < n; ++k)
+      if (!(time[k + 1] > time[k]))
+	throw std::runtime_error
+	  ("trajectory time is not strictly increasing");
+
+    // A small tolerance keeps the last frame when the duration is a
+    // multiple of the period up to rounding errors.
+    const double duration = time[n - 1] - time[0];
+    const std::size_t numFrames =
+      static_cast<std::size_t> (std::floor (duration * dataRate + 1e-6)) + 1;
+
+    Sampling sampling;
+    sampling.time = time;
+    sampling.numSourceFrames = n;
+    sampling.interval.resize (numFrames);
+    sampling.fraction.resize (numFrames);
+
+    result.data ().resize (numRows, numFrames);
+    std::size_t k = 0;
+    for (std::size_t j = 0; j < numFrames; ++j)
+      {
+	const double t = time[0] + static_cast<double> (j) / dataRate;
+	result.time ()[j] = t;
+	while (k + 1 < n && time[k + 1] <= t)
+	  ++k;
+	sampling.interval[j] = k;
+	sampling.fraction[j] =
+	  k + 1 < n ? (t - time[k]) / (time[k + 1] - time[k]) : 0.;
+      }
+
+    std::vector<MarkerResampler> resamplers;
+    resamplers.reserve (positions.numMarkers ());
+    for (std::size_t marker = 0; marker < positions.numMarkers (); ++marker)
+      resamplers.push_back (MarkerResampler (result, positions, sampling,
+					     interpolation_, marker));
+
+    std::vector<ThreadPool::Task*> tasks (resamplers.size ());
+    for (std::size_t i = 0; i < resamplers.size (); ++i)
+      tasks[i] = &resamplers[i];
+    ThreadPool pool (static_cast<std::size_t> (numThreads_));
+    pool.run (tasks);
+  }
+
+  MarkerTrajectory
+  TrajectoryResampler::resample (const MarkerTrajectory& trajectory,
+				 double dataRate) const
+  {
+    MarkerTrajectoryColumns positions (trajectory);
+    MarkerTrajectoryColumns resampled;
+    resample (resampled, positions, dataRate);
+
+    MarkerTrajectory result;
+    result.filename () = trajectory.filename ();
+    result.dataRate () = dataRate;
+    result.cameraRate () = trajectory.cameraRate ();
+    result.units () = trajectory.units ();
+    result.origDataRate () = trajectory.origDataRate ();
+    result.origDataStartFrame () = trajectory.origDataStartFrame ();
+    result.origNumFrames () = trajectory.origNumFrames ();
+    result.markers () = trajectory.markers ();
+    result.indexMarkers ();
+    result.setPrecision (trajectory.precision ());
+    resampled.toTrajectory (result);
+    return result;
+  }
+
+} // end of namespace libmocap.
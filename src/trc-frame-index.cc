@@ -0,0 +1,304 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "binary-marker-trajectory-format.hh"
+#include "mapped-file.hh"
+#include "trc-frame-index.hh"
+#include "trc-marker-trajectory-factory.hh"
+
+namespace libmocap
+{
+  // Sidecar file format, all values are little-endian.
+  //
+  // offset  size  content
+  // ------  ----  -------
+  //      0     8  magic string "LMTRCIX2"
+  //      8     8  size of the TRC file (uint64)
+  //     16     8  modification time of the TRC file, seconds (int64)
+  //     24     8  modification time of the TRC file, nanoseconds (int64)
+  //     32     8  stride (uint64)
+  //     40     8  number of rows (uint64)
+  //     48     8  number of offsets N (uint64)
+  //     56  8 * N offsets of the indexed rows (uint64)
+  namespace
+  {
+    const char indexMagic[] = "LMTRCIX2";
+    const std::size_t indexMagicSize = 8;
+    const std::size_t indexHeaderSize = indexMagicSize + 6 * 8;
+
+    bool statFile (const std::string& filename,
+		   uint64_t& size, int64_t& mtime, int64_t& mtimeNsec)
+    {
+      struct stat status;
+      if (::stat (filename.c_str (), &status) < 0)
+	return false;
+      size = static_cast<uint64_t> (status.st_size);
+      mtime = static_cast<int64_t> (status.st_mtim.tv_sec);
+      mtimeNsec = static_cast<int64_t> (status.st_mtim.tv_nsec);
+      return true;
+    }
+
+    /// Parse the frame id of the row starting at an offset.
+    bool frameIdAt (const MappedFile& file, uint64_t offset, int& frameId)
+    {
+      const char* first = file.data () + offset;
+      const char* last = file.data () + file.size ();
+      if (offset && first[-1] != '\n')
+	return false;
+      const char* eol = static_cast<const char*>
+	(std::memchr (first, '\n', static_cast<std::size_t> (last - first)));
+      eol = TrcMarkerTrajectoryFactory::stripEndOfLine
+	(first, eol ? eol : last);
+      try
+	{
+	  return TrcMarkerTrajectoryFactory::loadFrameId
+	    (first, eol, frameId) != 0;
+	}
+      catch (const std::runtime_error&)
+	{
+	  return false;
+	}
+    }
+
+    template <typename T>
+    void writeValue (std::ofstream& file, T value)
+    {
+      binaryTrajectory::toLittleEndian (&value, sizeof (T));
+      file.write (reinterpret_cast<const char*> (&value), sizeof (T));
+    }
+  } // end of anonymous namespace.
+
+  TrcFrameIndex::TrcFrameIndex (std::size_t stride)
+    : stride_ (stride ? stride : 1),
+      numRows_ (0),
+      offsets_ ()
+  {}
+
+  TrcFrameIndex::~TrcFrameIndex ()
+  {}
+
+  std::size_t
+  TrcFrameIndex::offset (std::size_t row) const
+  {
+    if (row >= numRows_)
+      throw std::runtime_error ("row is out of the frame index");
+    return static_cast<std::size_t> (offsets_[row / stride_]);
+  }
+
+  const char*
+  TrcFrameIndex::seek (const char* data, const char* first, const char* last,
+		       std::size_t row) const
+  {
+    if (empty ())
+      return TrcMarkerTrajectoryFactory::skipRows (first, last, row);
+    if (row >= numRows_)
+      return last;
+
+    first = data + offset (row);
+    if (first > last)
+      throw std::runtime_error ("frame index does not match the file");
+    return TrcMarkerTrajectoryFactory::skipRows (first, last, row % stride_);
+  }
+
+  void
+  TrcFrameIndex::build (const char* data, std::size_t size,
+			std::size_t dataOffset)
+  {
+    if (dataOffset > size)
+      throw std::runtime_error ("invalid data section offset");
+
+    offsets_.clear ();
+    numRows_ = 0;
+
+    const char* first = data + dataOffset;
+    const char* last = data + size;
+    const char* eol;
+    while (first < last)
+      {
+	eol = static_cast<const char*>
+	  (std::memchr (first, '\n', static_cast<std::size_t> (last - first)));
+	if (!eol)
+	  eol = last;
+
+	if (!TrcMarkerTrajectoryFactory::isEmptyRow (first, eol))
+	  {
+	    if (numRows_ % stride_ == 0)
+	      offsets_.push_back (static_cast<uint64_t> (first - data));
+	    ++numRows_;
+	  }
+	first = eol < last ? eol + 1 : last;
+      }
+  }
+
+  bool
+  TrcFrameIndex::load (const std::string& filename)
+  {
+    std::string path = indexPath (filename);
+
+    uint64_t size;
+    int64_t mtime;
+    int64_t mtimeNsec;
+    if (!statFile (filename, size, mtime, mtimeNsec)
+	|| ::access (path.c_str (), R_OK) < 0)
+      return false;
+
+    try
+      {
+	MappedFile file (path);
+	const char* data = file.data ();
+	if (file.size () < indexHeaderSize
+	    || std::memcmp (data, indexMagic, indexMagicSize) != 0)
+	  return false;
+	data += indexMagicSize;
+
+	if (binaryTrajectory::read<uint64_t> (data) != size
+	    || binaryTrajectory::read<int64_t> (data + 8) != mtime
+	    || binaryTrajectory::read<int64_t> (data + 16) != mtimeNsec)
+	  return false;
+
+	uint64_t stride = binaryTrajectory::read<uint64_t> (data + 24);
+	uint64_t numRows = binaryTrajectory::read<uint64_t> (data + 32);
+	uint64_t numOffsets = binaryTrajectory::read<uint64_t> (data + 40);
+	if (!stride
+	    || numOffsets != (numRows + stride - 1) / stride
+	    || numOffsets > (file.size () - indexHeaderSize) / 8)
+	  throw std::runtime_error ("inconsistent index size");
+	if (stride != stride_)
+	  return false;
+	data += 48;
+
+	std::vector<uint64_t> offsets (static_cast<std::size_t> (numOffsets));
+	for (std::size_t i = 0; i < offsets.size (); ++i)
+	  {
+	    offsets[i] = binaryTrajectory::read<uint64_t> (data + 8 * i);
+	    if (offsets[i] >= size)
+	      throw std::runtime_error ("invalid row offset");
+	  }
+
+	// Edits preserving the size and the modification time are
+	// caught by checking that the last indexed row still holds the
+	// expected frame.
+	if (!offsets.empty ())
+	  {
+	    MappedFile trc (filename);
+	    int firstId;
+	    int lastId;
+	    if (trc.size () != size
+		|| !frameIdAt (trc, offsets.front (), firstId)
+		|| !frameIdAt (trc, offsets.back (), lastId)
+		|| static_cast<uint64_t> (lastId - firstId)
+		!= (offsets.size () - 1) * stride)
+	      return false;
+	  }
+
+	numRows_ = static_cast<std::size_t> (numRows);
+	offsets_.swap (offsets);
+	return true;
+      }
+    catch (const std::exception& e)
+      {
+	std::cerr << "warning: ignoring frame index `"
+		  << path << "': " << e.what () << std::endl;
+	return false;
+      }
+  }
+
+  void
+  TrcFrameIndex::store (const std::string& filename) const
+  {
+    std::string path = indexPath (filename);
+    std::ostringstream tmpStream;
+    tmpStream << path << ".tmp." << ::getpid ();
+    std::string tmp = tmpStream.str ();
+
+    try
+      {
+	uint64_t size;
+	int64_t mtime;
+	int64_t mtimeNsec;
+	if (!statFile (filename, size, mtime, mtimeNsec))
+	  throw std::runtime_error ("cannot stat source file");
+
+	std::ofstream file
+	  (tmp.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+	file.exceptions (std::ofstream::failbit | std::ofstream::badbit);
+	file.write (indexMagic, indexMagicSize);
+	writeValue (file, size);
+	writeValue (file, mtime);
+	writeValue (file, mtimeNsec);
+	writeValue (file, static_cast<uint64_t> (stride_));
+	writeValue (file, static_cast<uint64_t> (numRows_));
+	writeValue (file, static_cast<uint64_t> (offsets_.size ()));
+	for (std::size_t i = 0; i < offsets_.size (); ++i)
+	  writeValue (file, offsets_[i]);
+	file.close ();
+
+	if (std::rename (tmp.c_str (), path.c_str ()) != 0)
+	  throw std::runtime_error ("cannot rename temporary file");
+      }
+    catch (const std::exception& e)
+      {
+	std::remove (tmp.c_str ());
+	std::cerr << "warning: failed to write frame index `"
+		  << path << "': " << e.what () << std::endl;
+      }
+  }
+
+  void
+  TrcFrameIndex::open (const std::string& filename, std::size_t dataOffset,
+		       bool sidecar)
+  {
+    if (sidecar && load (filename))
+      return;
+
+    {
+      MappedFile file (filename);
+      build (file.data (), file.size (), dataOffset);
+    }
+    if (sidecar)
+      store (filename);
+  }
+
+  std::string
+  TrcFrameIndex::indexPath (const std::string& filename)
+  {
+    return filename + ".index";
+  }
+
+} // end of namespace libmocap
@@ -0,0 +1,129 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_TRC_FRAME_INDEX_HH
+# define LIBMOCAP_TRC_FRAME_INDEX_HH
+# include <cstddef>
+# include <string>
+# include <vector>
+# include <stdint.h>
+
+namespace libmocap
+{
+  /// \brief Sparse index of the rows of a TRC file data section.
+  ///
+  /// The byte offset of every stride-th non-empty row is recorded,
+  /// so that reaching any row only requires to skip less than
+  /// stride rows from the closest indexed one.
+  ///
+  /// The index can be stored in a sidecar file next to the TRC file
+  /// (see indexPath). The sidecar records the size and modification
+  /// time, in nanoseconds, of the TRC file and is rebuilt as soon as
+  /// they change, as soon as the last indexed row no longer holds
+  /// the expected frame id, or if it has been built with another
+  /// stride.
+  class TrcFrameIndex
+  {
+  public:
+    /// \brief Default number of rows between two indexed rows.
+    static const std::size_t defaultStride = 256;
+
+    explicit TrcFrameIndex (std::size_t stride = defaultStride);
+    ~TrcFrameIndex ();
+
+    /// \brief Number of rows between two indexed rows.
+    std::size_t stride () const
+    {
+      return stride_;
+    }
+
+    /// \brief Number of non-empty rows in the data section.
+    std::size_t numRows () const
+    {
+      return numRows_;
+    }
+
+    /// \brief Has the index been built or loaded?
+    bool empty () const
+    {
+      return offsets_.empty ();
+    }
+
+    /// \brief Byte offset, from the beginning of the file, of the
+    /// closest indexed row preceding a row.
+    ///
+    /// The requested row is then reached by skipping
+    /// row % stride () non-empty rows.
+    std::size_t offset (std::size_t row) const;
+
+    /// \brief Locate a row in the mapped file [data, last).
+    ///
+    /// \param first beginning of the data section, rows are skipped
+    /// from there if the index is empty
+    /// \return beginning of the row, or last if there is no such row
+    const char* seek (const char* data, const char* first, const char* last,
+		      std::size_t row) const;
+
+    /// \brief Build the index with a single newline scan.
+    ///
+    /// \param data mapped file
+    /// \param size file size
+    /// \param dataOffset offset of the data section in the file
+    void build (const char* data, std::size_t size, std::size_t dataOffset);
+
+    /// \brief Load the sidecar file of a TRC file.
+    /// \return false if there is no up to date sidecar file with
+    /// the same stride
+    bool load (const std::string& filename);
+
+    /// \brief Write the sidecar file of a TRC file.
+    ///
+    /// Failures are not fatal: they are reported on the standard
+    /// error and the sidecar file is left untouched.
+    void store (const std::string& filename) const;
+
+    /// \brief Load the index of a TRC file, building it if needed.
+    ///
+    /// \param dataOffset offset of the data section in the file
+    /// \param sidecar use, and update, the sidecar file
+    void open (const std::string& filename, std::size_t dataOffset,
+	       bool sidecar);
+
+    /// \brief Path of the sidecar file of a TRC file.
+    static std::string indexPath (const std::string& filename);
+
+  private:
+    std::size_t stride_;
+    std::size_t numRows_;
+    std::vector<uint64_t> offsets_;
+  };
+} // end of namespace libmocap
+
+#endif //! LIBMOCAP_TRC_FRAME_INDEX_HH
@@ -28,6 +28,7 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cmath>
+#include <cstring>
 
 #include <algorithm>
 #include <fstream>
@@ -35,8 +36,11 @@
 #include <sstream>
 #include <stdexcept>
 
-#include "trc-marker-trajectory-factory.hh"
+#include "mapped-file.hh"
 #include "string.hh"
+#include "thread-pool.hh"
+#include "trc-frame-index.hh"
+#include "trc-marker-trajectory-factory.hh"
 
 namespace libmocap
 {
@@ -60,7 +64,10 @@ namespace libmocap
   };
 
 
+  const std::size_t TrcMarkerTrajectoryFactory::skippedColumn;
+
   TrcMarkerTrajectoryFactory::TrcMarkerTrajectoryFactory ()
+    : columns_ ()
   {
   }
 
@@ -73,11 +80,19 @@ namespace libmocap
   {
     if (this == &rhs)
       return *this;
+    columns_ = rhs.columns_;
     return *this;
   }
 
   MarkerTrajectory
   TrcMarkerTrajectoryFactory::load (const std::string& filename)
+  {
+    return load (filename, MarkerTrajectoryLoadOptions ());
+  }
+
+  MarkerTrajectory
+  TrcMarkerTrajectoryFactory::load
+  (const std::string& filename, const MarkerTrajectoryLoadOptions& options)
   {
     std::ifstream file (filename.c_str ());
     file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
@@ -85,11 +100,42 @@ namespace libmocap
     MarkerTrajectory trajectory;
 
     loadHeader (file, trajectory);
-    loadData (file, trajectory);
+    loadColumns (file, trajectory);
+    selectMarkers (options, trajectory);
+    if (options.singlePrecision ())
+      trajectory.setPrecision (MarkerTrajectory::SINGLE_PRECISION);
+
+    if (options.numThreads () < 0)
+      throw std::runtime_error ("invalid number of threads");
+
+    // Partial loads always rely on a mapped file so that skipped
+    // rows are never copied nor parsed.
+    if (options.memoryMapped () || options.numThreads () != 1
+	|| options.partial ())
+      {
+	// The header is small and is still read through the stream,
+	// the data section is then parsed from the mapped file.
+	std::streamoff offset = file.tellg ();
+	file.close ();
+	loadMappedData (filename, offset, options, trajectory);
+      }
+    else
+      {
+	resizePositions (trajectory);
+	loadData (file, trajectory);
+      }
 
     return trajectory;
   }
 
+  void
+  TrcMarkerTrajectoryFactory::resizePositions (MarkerTrajectory& trajectory)
+  {
+    trajectory.resize
+      (static_cast<std::size_t> (trajectory.numFrames ()),
+       1 + static_cast<std::size_t> (trajectory.numMarkers ()) * 3);
+  }
+
   void
   TrcMarkerTrajectoryFactory::loadHeader (std::ifstream& file, MarkerTrajectory& trajectory)
   {
@@ -169,19 +215,11 @@ namespace libmocap
       }
   }
 
-  static bool isBlank (char c)
-  {
-    return c == ' '
-      || c == '\t'
-      || c == '\r'
-      || c == '\b';
-  }
-
   void
-  TrcMarkerTrajectoryFactory::loadData (std::ifstream& file, MarkerTrajectory& trajectory)
+  TrcMarkerTrajectoryFactory::loadColumns
+  (std::ifstream& file, MarkerTrajectory& trajectory)
   {
     std::string line;
-    int frameId;
 
     // Read columns
     std::getline (file, line);
@@ -196,17 +234,54 @@ namespace libmocap
       throw std::runtime_error ("failed to read columns titles");
     while (stream >> value)
       trajectory.markers ().push_back (value);
+    trajectory.indexMarkers ();
 
     // The other two lines are discarded as they contain no
     // interesting information.
     std::getline (file, line);
     std::getline (file, line);
+  }
 
-    trajectory.positions ().clear ();
-    trajectory.positions ().resize
-      (static_cast<std::size_t> (trajectory.numFrames ()),
-       std::vector<double>
-       (1 + static_cast<std::size_t> (trajectory.numMarkers ()) * 3));
+  void
+  TrcMarkerTrajectoryFactory::selectMarkers
+  (const MarkerTrajectoryLoadOptions& options, MarkerTrajectory& trajectory)
+  {
+    columns_.clear ();
+    if (options.markers ().empty ())
+      return;
+
+    std::vector<std::size_t> indices;
+    options.markerIndices (indices, trajectory.markers ());
+
+    // Columns are mapped one by one so that rows are still parsed
+    // sequentially, the time column is always loaded.
+    columns_.resize
+      (1 + static_cast<std::size_t> (trajectory.numMarkers ()) * 3,
+       skippedColumn);
+    columns_[0] = 0;
+
+    std::vector<std::string> markers;
+    for (std::size_t i = 0; i < indices.size (); ++i)
+      {
+	if (1 + indices[i] * 3 + 3 > columns_.size ())
+	  throw std::runtime_error
+	    ("marker `" + trajectory.markers ()[indices[i]]
+	     + "' has no data column");
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	  columns_[1 + indices[i] * 3 + axis] = 1 + i * 3 + axis;
+	markers.push_back (trajectory.markers ()[indices[i]]);
+      }
+
+    trajectory.markers () = markers;
+    trajectory.numMarkers () = static_cast<int> (markers.size ());
+    trajectory.indexMarkers ();
+  }
+
+  void
+  TrcMarkerTrajectoryFactory::loadData (std::ifstream& file, MarkerTrajectory& trajectory)
+  {
+    std::string line;
+    std::vector<double> buffer;
 
     while (!file.eof ())
       {
@@ -225,87 +300,340 @@ namespace libmocap
 	  }
 	trimEndOfLine (line);
 
-	std::size_t start = 0;
-	std::size_t end = 0;
+	loadRow (line.data (), line.data () + line.size (), trajectory, buffer);
+      }
+  }
+
+  /// \brief Parse a chunk of whole rows of the data section.
+  class TrcMarkerTrajectoryFactory::RowsParser : public ThreadPool::Task
+  {
+  public:
+    RowsParser (TrcMarkerTrajectoryFactory& factory,
+		const char* first, const char* last,
+		MarkerTrajectory& trajectory)
+      : factory_ (&factory),
+	first_ (first),
+	last_ (last),
+	trajectory_ (&trajectory)
+    {}
+
+    void run ()
+    {
+      factory_->loadRows (first_, last_, *trajectory_);
+    }
+
+  private:
+    TrcMarkerTrajectoryFactory* factory_;
+    const char* first_;
+    const char* last_;
+    MarkerTrajectory* trajectory_;
+  };
+
+  void
+  TrcMarkerTrajectoryFactory::loadMappedData
+  (const std::string& filename, std::streamoff offset,
+   const MarkerTrajectoryLoadOptions& options, MarkerTrajectory& trajectory)
+  {
+    MappedFile file (filename);
+
+    if (offset < 0 || static_cast<std::size_t> (offset) > file.size ())
+      throw std::runtime_error ("invalid data section offset");
+
+    const char* first = file.data () + offset;
+    const char* last = file.data () + file.size ();
+
+    if (options.partial ())
+      {
+	TrcFrameIndex index (options.frameIndexStride ());
+	if (options.frameIndex ())
+	  index.open (filename, static_cast<std::size_t> (offset), true);
+	selectFrames (file.data (), first, last, index, options, trajectory);
+      }
+    resizePositions (trajectory);
 
-	std::vector<std::string> data;
-	while (start < line.size () && end < line.size ())
+    ThreadPool pool (static_cast<std::size_t> (options.numThreads ()));
+    if (pool.numThreads () == 1)
+      {
+	loadRows (first, last, trajectory);
+	return;
+      }
+
+    // Rows are independent as each of them starts with its frame
+    // id: cut the data section at line boundaries and fill the
+    // preallocated frames concurrently. Several chunks are created
+    // per thread to balance the load.
+    std::size_t size = static_cast<std::size_t> (last - first);
+    std::size_t numChunks = pool.numThreads () * 4;
+
+    std::vector<RowsParser> parsers;
+    parsers.reserve (numChunks);
+
+    const char* chunkStart = first;
+    const char* chunkEnd;
+    for (std::size_t i = 1; i <= numChunks && chunkStart < last; ++i)
+      {
+	chunkEnd = std::max (first + size * i / numChunks, chunkStart);
+	if (chunkEnd < last)
 	  {
-	    if (isBlank (line[start]))
-	      start++;
-
-	    // no more to read
-	    if (start >= line.size ())
-	      break;
-
-	    end = start;
-	    while (!isBlank (line[end]))
-	      end++;
-	    data.push_back (line.substr (start, end - start));
-	    start = end;
+	    chunkEnd = static_cast<const char*>
+	      (std::memchr (chunkEnd, '\n',
+			    static_cast<std::size_t> (last - chunkEnd)));
+	    chunkEnd = chunkEnd ? chunkEnd + 1 : last;
 	  }
+	parsers.push_back (RowsParser (*this, chunkStart, chunkEnd, trajectory));
+	chunkStart = chunkEnd;
+      }
+
+    std::vector<ThreadPool::Task*> tasks (parsers.size ());
+    for (std::size_t i = 0; i < parsers.size (); ++i)
+      tasks[i] = &parsers[i];
+    pool.run (tasks);
+  }
+
+  void
+  TrcMarkerTrajectoryFactory::selectFrames
+  (const char* data, const char*& first, const char*& last,
+   const TrcFrameIndex& index,
+   const MarkerTrajectoryLoadOptions& options, MarkerTrajectory& trajectory)
+  {
+    // Time ranges are converted to frames using the time of the
+    // first row of the file.
+    double firstTime = 0.;
+    const char* row = skipRows (first, last, 0);
+    if (row < last)
+      {
+	const char* eol = static_cast<const char*>
+	  (std::memchr (row, '\n', static_cast<std::size_t> (last - row)));
+	eol = stripEndOfLine (row, eol ? eol : last);
+
+	int frameId;
+	const char* time = loadFrameId (row, eol, frameId);
+	if (time < eol && isBlank (*time))
+	  time++;
+	const char* end = time;
+	while (end < eol && !isBlank (*end))
+	  end++;
+	if (time < end)
+	  firstTime = convert<double> (time, end);
+      }
 
-	// skip empty lines
-	if (data.empty ())
-	  continue;
+    int firstFrame;
+    int numFrames;
+    options.frameRange (firstFrame, numFrames, trajectory.numFrames (),
+			firstTime, trajectory.dataRate ());
 
-	frameId = convert<int> (data[0]) - 1;
-	std::size_t frameId_ = static_cast<std::size_t> (frameId);
+    first = index.seek
+      (data, first, last, static_cast<std::size_t> (firstFrame));
+    last = skipRows (first, last, static_cast<std::size_t> (numFrames));
+
+    trajectory.firstFrame () = firstFrame;
+    trajectory.numFrames () = numFrames;
+  }
 
-	if (frameId < 0
-	    || frameId >= static_cast<int> (trajectory.positions ().size ()))
+  const char*
+  TrcMarkerTrajectoryFactory::skipRows
+  (const char* first, const char* last, std::size_t numRows)
+  {
+    // Empty lines are not counted, as they are ignored by loadRow.
+    const char* eol;
+    while (first < last)
+      {
+	eol = static_cast<const char*>
+	  (std::memchr (first, '\n', static_cast<std::size_t> (last - first)));
+	if (!eol)
+	  eol = last;
+
+	if (!isEmptyRow (first, eol))
 	  {
-	    std::stringstream error;
-	    error << "invalid frame id (number of frames is "
-		  << trajectory.numFrames ()
-		  << " but data size is "
-		  << frameId
-		  << ")";
-	    throw std::runtime_error (error.str ());
+	    if (!numRows)
+	      return first;
+	    --numRows;
 	  }
+	first = eol < last ? eol + 1 : last;
+      }
+    return last;
+  }
 
-	std::size_t markerId = 0;
-	std::vector<std::string>::const_iterator it = data.begin ();
-	for (++it; it != data.end (); ++it)
-	  {
-	    if (markerId >=
-		1 + static_cast<std::size_t> (trajectory.numMarkers ()) * 3)
-	      {
-		std::stringstream stream;
-		stream
-		  << "size data mismatch, expected size is "
-		  << 1 + trajectory.numMarkers () * 3
-		  << ", but "
-		  << markerId
-		  << " have already been read";
-		std::cerr << stream.str () << std::endl;
-		continue;
-	      }
+  void
+  TrcMarkerTrajectoryFactory::loadRows
+  (const char* first, const char* last, MarkerTrajectory& trajectory)
+  {
+    std::vector<double> buffer;
+    const char* eol;
+    while (first < last)
+      {
+	eol = static_cast<const char*>
+	  (std::memchr (first, '\n', static_cast<std::size_t> (last - first)));
+	if (!eol)
+	  eol = last;
 
-	    // Missing marker, put NaN to signal it.
-	    if (it->empty ())
-	      {
-		trajectory.positions ()[frameId_][markerId++] = nan ("");
-	      }
-	    else
-	      trajectory.positions ()[frameId_][markerId++] = convert<double> (*it);
+	loadRow (first, eol, trajectory, buffer);
+	first = eol + 1;
+      }
+  }
+
+  void
+  TrcMarkerTrajectoryFactory::loadRow
+  (const char* first, const char* last, MarkerTrajectory& trajectory,
+   std::vector<double>& buffer)
+  {
+    last = stripEndOfLine (first, last);
+
+    int frameId;
+    const char* values = loadFrameId (first, last, frameId);
+
+    // skip empty lines
+    if (!values)
+      return;
+
+    // Rows are stored relatively to the first loaded frame.
+    int rowId = frameId - trajectory.firstFrame ();
+    if (rowId < 0
+	|| rowId >= static_cast<int> (trajectory.numRows ()))
+      {
+	std::stringstream error;
+	error << "invalid frame id (number of frames is "
+	      << trajectory.numFrames ()
+	      << " but data size is "
+	      << frameId
+	      << ")";
+	throw std::runtime_error (error.str ());
+      }
+
+    try
+      {
+	// Single precision rows are parsed in double precision first.
+	double* row;
+	if (trajectory.precision () == MarkerTrajectory::DOUBLE_PRECISION)
+	  row = trajectory.positions ().row
+	    (static_cast<std::size_t> (rowId)).data ();
+	else
+	  {
+	    buffer.resize (trajectory.numCols ());
+	    row = &buffer[0];
 	  }
-	if (markerId !=
-	    1 + static_cast<std::size_t> (trajectory.numMarkers ()) * 3)
+
+	if (columns_.empty ())
+	  loadValues (values, last, row, trajectory.numCols ());
+	else
+	  loadValues (values, last, row, columns_.size (), &columns_[0]);
+
+	if (trajectory.precision () == MarkerTrajectory::SINGLE_PRECISION)
+	  trajectory.writeRow (static_cast<std::size_t> (rowId), row);
+      }
+    catch (const std::runtime_error& e)
+      {
+	std::stringstream error;
+	error << "frame " << frameId + 1 << ": " << e.what ();
+	throw std::runtime_error (error.str ());
+      }
+  }
+
+  const char*
+  TrcMarkerTrajectoryFactory::stripEndOfLine
+  (const char* first, const char* last)
+  {
+    // Strip the end of line, including Windows line terminators.
+    while (last != first && (last[-1] == '\n' || last[-1] == '\r'))
+      --last;
+    return last;
+  }
+
+  bool
+  TrcMarkerTrajectoryFactory::isEmptyRow (const char* first, const char* last)
+  {
+    // A row holding a single blank is empty too, see loadFrameId.
+    last = stripEndOfLine (first, last);
+    return last == first || (last - first == 1 && isBlank (*first));
+  }
+
+  // Tokens are delimited by a single blank: two consecutive blanks
+  // denote an empty cell, i.e. a missing marker.
+
+  const char*
+  TrcMarkerTrajectoryFactory::loadFrameId
+  (const char* first, const char* last, int& frameId)
+  {
+    if (first < last && isBlank (*first))
+      first++;
+
+    // no more to read
+    if (first >= last)
+      return 0;
+
+    const char* end = first;
+    while (end < last && !isBlank (*end))
+      end++;
+
+    frameId = convert<int> (first, end) - 1;
+    return end;
+  }
+
+  void
+  TrcMarkerTrajectoryFactory::loadValues
+  (const char* first, const char* last, double* row, std::size_t rowSize,
+   const std::size_t* columns)
+  {
+    const char* start = first;
+    const char* end;
+    std::size_t markerId = 0;
+    while (start < last)
+      {
+	if (isBlank (*start))
+	  start++;
+
+	// no more to read
+	if (start >= last)
+	  break;
+
+	end = start;
+	while (end < last && !isBlank (*end))
+	  end++;
+
+	if (markerId >= rowSize)
 	  {
 	    std::stringstream stream;
 	    stream
 	      << "size data mismatch, expected size is "
-	      << 1 + trajectory.numMarkers () * 3
-	      << ", but only "
+	      << rowSize
+	      << ", but "
 	      << markerId
-	      << " have been read";
+	      << " have already been read";
 	    std::cerr << stream.str () << std::endl;
-
-	    while (markerId <
-		   1 + static_cast<std::size_t> (trajectory.numMarkers ()) * 3)
-	      trajectory.positions ()[frameId_][markerId++] = 0.;
 	  }
+	// Unselected marker, skip it without any conversion.
+	else if (columns && columns[markerId] == skippedColumn)
+	  markerId++;
+	else
+	  {
+	    double& value = row[columns ? columns[markerId] : markerId];
+	    // Missing marker, put NaN to signal it.
+	    if (start == end)
+	      value = nan ("");
+	    else
+	      value = convert<double> (start, end);
+	    markerId++;
+	  }
+
+	start = end;
+      }
+
+    if (markerId != rowSize)
+      {
+	std::stringstream stream;
+	stream
+	  << "size data mismatch, expected size is "
+	  << rowSize
+	  << ", but only "
+	  << markerId
+	  << " have been read";
+	std::cerr << stream.str () << std::endl;
+
+	for (; markerId < rowSize; ++markerId)
+	  if (!columns)
+	    row[markerId] = 0.;
+	  else if (columns[markerId] != skippedColumn)
+	    row[columns[markerId]] = 0.;
       }
   }
 
@@ -30,13 +30,17 @@
 
 #ifndef LIBMOCAP_TRC_MARKER_TRAJECTORY_FACTORY_HH
 # define LIBMOCAP_TRC_MARKER_TRAJECTORY_FACTORY_HH
+# include <cstddef>
 # include <iosfwd>
 # include <string>
+# include <vector>
 
 # include <libmocap/marker-trajectory.hh>
+# include <libmocap/marker-trajectory-load-options.hh>
 
 namespace libmocap
 {
+  class TrcFrameIndex;
   class VariableMapper;
 
   class TrcMarkerTrajectoryFactory
@@ -47,6 +51,8 @@ namespace libmocap
     TrcMarkerTrajectoryFactory& operator= (const TrcMarkerTrajectoryFactory& rhs);
 
     MarkerTrajectory load (const std::string& filename);
+    MarkerTrajectory load (const std::string& filename,
+			   const MarkerTrajectoryLoadOptions& options);
 
     static bool canLoad (const std::string& filename);
 
@@ -76,10 +82,94 @@ namespace libmocap
     loadOrigNumFrames
     (MarkerTrajectory& trajectory, const std::string& value);
 
-  private:
+    /// \name Header and rows parsing
+    /// \{
+
+    /// \brief Load the file prologue and metadata.
     void loadHeader (std::ifstream& file, MarkerTrajectory& trajectory);
+
+    /// \brief Load the column titles (i.e. the marker names).
+    ///
+    /// The file is left at the beginning of the data section.
+    void loadColumns (std::ifstream& file, MarkerTrajectory& trajectory);
+
+    /// \brief Remove the end of line characters of [first, last).
+    /// \return new end of the range
+    static const char* stripEndOfLine (const char* first, const char* last);
+
+    /// \brief Skip numRows non-empty rows of [first, last) without
+    /// parsing them.
+    /// \return beginning of the following non-empty row, or last
+    static const char* skipRows (const char* first, const char* last,
+				 std::size_t numRows);
+
+    /// \brief Is [first, last) an empty row, i.e. a row ignored by
+    /// the parser?
+    static bool isEmptyRow (const char* first, const char* last);
+
+    /// \brief Parse the frame id (zero-based) starting a row.
+    /// \return end of the frame id token, or zero if the row is empty
+    static const char* loadFrameId (const char* first, const char* last,
+				    int& frameId);
+
+    /// \brief Column index marking a skipped column.
+    static const std::size_t skippedColumn = static_cast<std::size_t> (-1);
+
+    /// \brief Parse the values following the frame id of a row.
+    ///
+    /// Empty cells are stored as NaN, missing trailing values are
+    /// set to zero and extra values are ignored.
+    ///
+    /// \param rowSize number of values of the row
+    /// \param columns if not null, index in row of each of the
+    /// rowSize values, values whose index is skippedColumn are not
+    /// parsed
+    static void loadValues (const char* first, const char* last,
+			    double* row, std::size_t rowSize,
+			    const std::size_t* columns = 0);
+
+    /// \}
+
+  private:
+    class RowsParser;
+
+    /// \brief Restrict the trajectory markers to the ones selected
+    /// by the options and fill columns_ accordingly.
+    void selectMarkers (const MarkerTrajectoryLoadOptions& options,
+			MarkerTrajectory& trajectory);
+
     void loadData (std::ifstream& file, MarkerTrajectory& trajectory);
+    void loadMappedData (const std::string& filename, std::streamoff offset,
+			 const MarkerTrajectoryLoadOptions& options,
+			 MarkerTrajectory& trajectory);
+
+    /// \brief Allocate the positions of the frames to be loaded.
+    static void resizePositions (MarkerTrajectory& trajectory);
+
+    /// \brief Restrict the data section [first, last) of the mapped
+    /// file data to the frames selected by the options and update
+    /// the trajectory frame range accordingly.
+    ///
+    /// Rows are skipped from first unless the index is not empty.
+    static void selectFrames (const char* data,
+			      const char*& first, const char*& last,
+			      const TrcFrameIndex& index,
+			      const MarkerTrajectoryLoadOptions& options,
+			      MarkerTrajectory& trajectory);
+
+    /// \brief Parse the whole rows stored in [first, last).
+    void loadRows (const char* first, const char* last,
+		   MarkerTrajectory& trajectory);
+
+    /// \brief Parse one data row stored in [first, last).
+    ///
+    /// \param buffer row buffer used in single precision
+    void loadRow (const char* first, const char* last,
+		  MarkerTrajectory& trajectory, std::vector<double>& buffer);
 
+    /// \brief Index in the loaded rows of each column of the file,
+    /// empty if every column is loaded.
+    std::vector<std::size_t> columns_;
   };
 } // end of namespace libmocap.
 
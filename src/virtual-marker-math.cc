@@ -0,0 +1,275 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "math.hh"
+#include "virtual-marker-math.hh"
+
+namespace libmocap
+{
+  // Compute the frame attached to three markers: ox is the long axis,
+  // oy the plane axis made orthogonal to ox and oz their cross product.
+  static void
+  threePointsFrame
+  (double ox[3], double oy[3], double oz[3],
+   const double origin[3], const double longAxis[3],
+   const double planeAxis[3])
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+      {
+	ox[i] = longAxis[i] - origin[i];
+	oy[i] = planeAxis[i] - origin[i];
+      }
+
+    double proj_ox_oy[3];
+    proj (proj_ox_oy, ox, oy);
+    for (std::size_t i = 0; i < 3; ++i)
+      oy[i] -= proj_ox_oy[i];
+
+    cross (oz, ox, oy);
+  }
+
+  void onePointMeasured
+  (double position[3], const double origin[3], const double offset[3])
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+      position[i] = origin[i] + offset[i];
+  }
+
+  void twoPointsRatio
+  (double position[3], const double origin[3], const double longAxis[3],
+   double weight)
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+      position[i] = origin[i] + weight * (longAxis[i] - origin[i]);
+  }
+
+  void twoPointsMeasured
+  (double position[3], const double origin[3], const double longAxis[3],
+   double offset)
+  {
+    double norm = 0.;
+    for (std::size_t i = 0; i < 3; ++i)
+      norm += std::pow (longAxis[i] - origin[i], 2);
+    norm = std::sqrt (norm);
+
+    for (std::size_t i = 0; i < 3; ++i)
+      position[i] = origin[i] + offset * (longAxis[i] - origin[i]) / norm;
+  }
+
+  void threePointsRatio
+  (double position[3], const double origin[3], const double longAxis[3],
+   const double planeAxis[3], const double weights[3])
+  {
+    double ox[3];
+    double oy[3];
+    double oz[3];
+    threePointsFrame (ox, oy, oz, origin, longAxis, planeAxis);
+
+    //FIXME: should be plus and not minus... (?)
+    for (std::size_t i = 0; i < 3; ++i)
+      position[i] =
+	origin[i]
+	- weights[0] * ox[i]
+	- weights[1] * oy[i]
+	- weights[2] * oz[i];
+  }
+
+  void threePointsMeasured
+  (double position[3], const double origin[3], const double longAxis[3],
+   const double planeAxis[3], const double offset[3])
+  {
+    double ox[3];
+    double oy[3];
+    double oz[3];
+    threePointsFrame (ox, oy, oz, origin, longAxis, planeAxis);
+
+    normalize (ox);
+    normalize (oy);
+    normalize (oz);
+
+    for (std::size_t i = 0; i < 3; ++i)
+      position[i] =
+	origin[i]
+	+ offset[0] * ox[i]
+	+ offset[1] * oy[i]
+	+ offset[2] * oz[i];
+  }
+
+  static inline void
+  gather (double v[3], const double* p, std::size_t stride, std::size_t k)
+  {
+    v[0] = p[k];
+    v[1] = p[stride + k];
+    v[2] = p[2 * stride + k];
+  }
+
+  static inline void
+  scatter (double* p, std::size_t stride, std::size_t k, const double v[3])
+  {
+    p[k] = v[0];
+    p[stride + k] = v[1];
+    p[2 * stride + k] = v[2];
+  }
+
+  void onePointMeasured
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double offset[3])
+  {
+    for (std::size_t k = 0; k < n; ++k)
+      {
+	double o[3];
+	double p[3];
+	gather (o, origin, stride, k);
+	onePointMeasured (p, o, offset);
+	scatter (position, stride, k, p);
+      }
+  }
+
+  void twoPointsRatio
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double* longAxis,
+   double weight)
+  {
+    for (std::size_t k = 0; k < n; ++k)
+      {
+	double o[3];
+	double l[3];
+	double p[3];
+	gather (o, origin, stride, k);
+	gather (l, longAxis, stride, k);
+	twoPointsRatio (p, o, l, weight);
+	scatter (position, stride, k, p);
+      }
+  }
+
+  void twoPointsMeasured
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double* longAxis,
+   double offset)
+  {
+    for (std::size_t k = 0; k < n; ++k)
+      {
+	double o[3];
+	double l[3];
+	double p[3];
+	gather (o, origin, stride, k);
+	gather (l, longAxis, stride, k);
+	twoPointsMeasured (p, o, l, offset);
+	scatter (position, stride, k, p);
+      }
+  }
+
+  // Batched counterpart of threePointsFrame: frames are processed by
+  // chunks stored in local buffers so that the batched vector
+  // primitives can be used.
+  static const std::size_t chunkSize = 64;
+
+  static void
+  threePointsFrame
+  (std::size_t n, std::size_t stride,
+   double ox[3 * chunkSize], double oy[3 * chunkSize],
+   double oz[3 * chunkSize],
+   const double* origin, const double* longAxis, const double* planeAxis)
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t k = 0; k < n; ++k)
+	{
+	  ox[i * chunkSize + k] =
+	    longAxis[i * stride + k] - origin[i * stride + k];
+	  oy[i * chunkSize + k] =
+	    planeAxis[i * stride + k] - origin[i * stride + k];
+	}
+
+    double proj_ox_oy[3 * chunkSize];
+    proj (n, chunkSize, proj_ox_oy, ox, oy);
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t k = 0; k < n; ++k)
+	oy[i * chunkSize + k] -= proj_ox_oy[i * chunkSize + k];
+
+    cross (n, chunkSize, oz, ox, oy);
+  }
+
+  void threePointsRatio
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double* longAxis,
+   const double* planeAxis, const double weights[3])
+  {
+    for (std::size_t first = 0; first < n; first += chunkSize)
+      {
+	const std::size_t m = std::min (chunkSize, n - first);
+	double ox[3 * chunkSize];
+	double oy[3 * chunkSize];
+	double oz[3 * chunkSize];
+	threePointsFrame (m, stride, ox, oy, oz, origin + first,
+			  longAxis + first, planeAxis + first);
+
+	//FIXME: should be plus and not minus... (?)
+	for (std::size_t i = 0; i < 3; ++i)
+	  for (std::size_t k = 0; k < m; ++k)
+	    position[i * stride + first + k] =
+	      origin[i * stride + first + k]
+	      - weights[0] * ox[i * chunkSize + k]
+	      - weights[1] * oy[i * chunkSize + k]
+	      - weights[2] * oz[i * chunkSize + k];
+      }
+  }
+
+  void threePointsMeasured
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double* longAxis,
+   const double* planeAxis, const double offset[3])
+  {
+    for (std::size_t first = 0; first < n; first += chunkSize)
+      {
+	const std::size_t m = std::min (chunkSize, n - first);
+	double ox[3 * chunkSize];
+	double oy[3 * chunkSize];
+	double oz[3 * chunkSize];
+	threePointsFrame (m, stride, ox, oy, oz, origin + first,
+			  longAxis + first, planeAxis + first);
+
+	normalize (m, chunkSize, ox);
+	normalize (m, chunkSize, oy);
+	normalize (m, chunkSize, oz);
+
+	for (std::size_t i = 0; i < 3; ++i)
+	  for (std::size_t k = 0; k < m; ++k)
+	    position[i * stride + first + k] =
+	      origin[i * stride + first + k]
+	      + offset[0] * ox[i * chunkSize + k]
+	      + offset[1] * oy[i * chunkSize + k]
+	      + offset[2] * oz[i * chunkSize + k];
+      }
+  }
+
+} // end of namespace libmocap
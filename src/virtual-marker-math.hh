@@ -0,0 +1,95 @@
+// Copyright (c) 2014, CNRS-AIST JRL/UMI3218
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LIBMOCAP_VIRTUAL_MARKER_MATH_HH
+# define LIBMOCAP_VIRTUAL_MARKER_MATH_HH
+# include <cstddef>
+
+namespace libmocap
+{
+  /// \name Virtual markers position computation.
+  ///
+  /// These functions are shared by the virtual markers classes and
+  /// MarkerSetProgram so that both evaluation paths perform exactly
+  /// the same floating point operations.
+  /// \{
+  void onePointMeasured
+  (double position[3], const double origin[3], const double offset[3]);
+
+  void twoPointsRatio
+  (double position[3], const double origin[3], const double longAxis[3],
+   double weight);
+
+  void twoPointsMeasured
+  (double position[3], const double origin[3], const double longAxis[3],
+   double offset);
+
+  void threePointsRatio
+  (double position[3], const double origin[3], const double longAxis[3],
+   const double planeAxis[3], const double weights[3]);
+
+  void threePointsMeasured
+  (double position[3], const double origin[3], const double longAxis[3],
+   const double planeAxis[3], const double offset[3]);
+  /// \}
+
+  /// \name Batch computation over consecutive frames.
+  ///
+  /// Positions are stored by axis: coordinate i of frame k is
+  /// stored at p[i * stride + k]. Each function processes n frames
+  /// and produces the same values as its single frame counterpart.
+  /// \{
+  void onePointMeasured
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double offset[3]);
+
+  void twoPointsRatio
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double* longAxis,
+   double weight);
+
+  void twoPointsMeasured
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double* longAxis,
+   double offset);
+
+  void threePointsRatio
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double* longAxis,
+   const double* planeAxis, const double weights[3]);
+
+  void threePointsMeasured
+  (std::size_t n, std::size_t stride,
+   double* position, const double* origin, const double* longAxis,
+   const double* planeAxis, const double offset[3]);
+  /// \}
+} // end of namespace libmocap
+
+#endif //! LIBMOCAP_VIRTUAL_MARKER_MATH_HH
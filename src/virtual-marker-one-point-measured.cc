@@ -34,6 +34,8 @@
 #include <libmocap/marker-set.hh>
 #include <libmocap/virtual-marker-one-point-measured.hh>
 
+#include "virtual-marker-math.hh"
+
 namespace libmocap
 {
   VirtualMarkerOnePointMeasured::VirtualMarkerOnePointMeasured
@@ -50,7 +52,7 @@ namespace libmocap
 
   VirtualMarkerOnePointMeasured::VirtualMarkerOnePointMeasured
   (const VirtualMarkerOnePointMeasured& rhs)
-    : AbstractVirtualMarker (),
+    : AbstractVirtualMarker (rhs),
       offset_ (rhs.offset_)
   {}
 
@@ -86,18 +88,17 @@ namespace libmocap
   {
     if (frameId < 0)
       throw std::runtime_error ("negative frame id");
-    if (frameId >= static_cast<int> (trajectory.positions ().size ()))
+    if (frameId >= static_cast<int> (trajectory.numRows ()))
       throw std::runtime_error ("frame id is too large");
     if (originMarker () < 0)
       throw std::runtime_error ("negative origin marker");
     if (originMarker () >= static_cast<int> (markerSet.markers ().size ()))
       throw std::runtime_error ("origin marker id too large");
 
+    double originPos[3];
     markerSet.markers ()[static_cast<std::size_t> (originMarker ())]->position
-      (position, markerSet, trajectory, frameId);
-    position[0] += offset ()[0];
-    position[1] += offset ()[1];
-    position[2] += offset ()[2];
+      (originPos, markerSet, trajectory, frameId);
+    onePointMeasured (position, originPos, &offset ()[0]);
   }
 
   std::ostream&
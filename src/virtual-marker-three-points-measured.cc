@@ -34,7 +34,7 @@
 #include <libmocap/marker-set.hh>
 #include <libmocap/virtual-marker-three-points-measured.hh>
 
-#include "math.hh"
+#include "virtual-marker-math.hh"
 
 namespace libmocap
 {
@@ -50,7 +50,7 @@ namespace libmocap
 
   VirtualMarkerThreePointsMeasured::VirtualMarkerThreePointsMeasured
   (const VirtualMarkerThreePointsMeasured& rhs)
-    : AbstractVirtualMarker (),
+    : AbstractVirtualMarker (rhs),
       offset_ (rhs.offset_)
   {}
 
@@ -92,7 +92,7 @@ namespace libmocap
 
     if (frameId < 0)
       throw std::runtime_error ("negative frame id");
-    if (frameId >= static_cast<int> (trajectory.positions ().size ()))
+    if (frameId >= static_cast<int> (trajectory.numRows ()))
       throw std::runtime_error ("frame id is too large");
     if (offset ().size () != 3)
       throw std::runtime_error ("offset vector too large");
@@ -126,34 +126,8 @@ namespace libmocap
     markerSet.markers ()[planeAxisMarker_]->position
       (planeAxisMarkerPos, markerSet, trajectory, frameId);
 
-
-    double ox[3];
-    double oy[3];
-    double oz[3];
-
-    for (std::size_t i = 0; i < 3; ++i)
-      {
-	ox[i] = longAxisMarkerPos[i] - originPos[i];
-	oy[i] = planeAxisMarkerPos[i] - originPos[i];
-      }
-
-    double proj_ox_oy[3];
-    proj (proj_ox_oy, ox, oy);
-    for (std::size_t i = 0; i < 3; ++i)
-      oy[i] -= proj_ox_oy[i];
-
-    cross (oz, ox, oy);
-
-    normalize (ox);
-    normalize (oy);
-    normalize (oz);
-
-    for (std::size_t i = 0; i < 3; ++i)
-      position[i] =
-	originPos[i]
-	+ offset_[0] * ox[i]
-	+ offset_[1] * oy[i]
-	+ offset_[2] * oz[i];
+    threePointsMeasured
+      (position, originPos, longAxisMarkerPos, planeAxisMarkerPos, &offset_[0]);
   }
 
   std::ostream&
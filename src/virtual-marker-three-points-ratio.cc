@@ -34,7 +34,7 @@
 #include <libmocap/marker-set.hh>
 #include <libmocap/virtual-marker-three-points-ratio.hh>
 
-#include "math.hh"
+#include "virtual-marker-math.hh"
 
 namespace libmocap
 {
@@ -52,7 +52,7 @@ namespace libmocap
 
   VirtualMarkerThreePointsRatio::VirtualMarkerThreePointsRatio
   (const VirtualMarkerThreePointsRatio& rhs)
-    : AbstractVirtualMarker (),
+    : AbstractVirtualMarker (rhs),
       weights_ (rhs.weights_)
   {}
 
@@ -93,7 +93,7 @@ namespace libmocap
 
     if (frameId < 0)
       throw std::runtime_error ("negative frame id");
-    if (frameId >= static_cast<int> (trajectory.positions ().size ()))
+    if (frameId >= static_cast<int> (trajectory.numRows ()))
       throw std::runtime_error ("frame id is too large");
     if (weights ().size () != 3)
       throw std::runtime_error ("weights vector too large");
@@ -127,31 +127,8 @@ namespace libmocap
     markerSet.markers ()[planeAxisMarker_]->position
       (planeAxisMarkerPos, markerSet, trajectory, frameId);
 
-
-    double ox[3];
-    double oy[3];
-    double oz[3];
-
-    for (std::size_t i = 0; i < 3; ++i)
-      {
-	ox[i] = longAxisMarkerPos[i] - originPos[i];
-	oy[i] = planeAxisMarkerPos[i] - originPos[i];
-      }
-
-    double proj_ox_oy[3];
-    proj (proj_ox_oy, ox, oy);
-    for (std::size_t i = 0; i < 3; ++i)
-      oy[i] -= proj_ox_oy[i];
-
-    cross (oz, ox, oy);
-
-    //FIXME: should be plus and not minus... (?)
-    for (std::size_t i = 0; i < 3; ++i)
-      position[i] =
-	originPos[i]
-	- weights_[0] * ox[i]
-	- weights_[1] * oy[i]
-	- weights_[2] * oz[i];
+    threePointsRatio
+      (position, originPos, longAxisMarkerPos, planeAxisMarkerPos, &weights_[0]);
   }
 
   std::ostream&
@@ -27,7 +27,6 @@
 // THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-#include <cmath>
 #include <stdexcept>
 
 #include <libmocap/abstract-virtual-marker.hh>
@@ -35,6 +34,8 @@
 #include <libmocap/marker-trajectory.hh>
 #include <libmocap/virtual-marker-two-points-measured.hh>
 
+#include "virtual-marker-math.hh"
+
 namespace libmocap
 {
   VirtualMarkerTwoPointsMeasured::VirtualMarkerTwoPointsMeasured
@@ -88,7 +89,7 @@ namespace libmocap
 
     if (frameId < 0)
       throw std::runtime_error ("negative frame id");
-    if (frameId >= static_cast<int> (trajectory.positions ().size ()))
+    if (frameId >= static_cast<int> (trajectory.numRows ()))
       throw std::runtime_error ("frame id is too large");
     if (originMarker () < 0)
       throw std::runtime_error ("negative origin marker");
@@ -109,13 +110,7 @@ namespace libmocap
     markerSet.markers ()[longAxisMarker_]->position
       (marker2, markerSet, trajectory, frameId);
 
-    double norm = 0.;
-    for (std::size_t i = 0; i < 3; ++i)
-      norm += std::pow (marker2[i] - marker1[i], 2);
-    norm = std::sqrt (norm);
-
-    for (std::size_t i = 0; i < 3; ++i)
-      position[i] = marker1[i] + offset_ * (marker2[i] - marker1[i]) / norm;
+    twoPointsMeasured (position, marker1, marker2, offset_);
   }
 
   std::ostream&
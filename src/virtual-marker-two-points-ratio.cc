@@ -34,6 +34,8 @@
 #include <libmocap/marker-set.hh>
 #include <libmocap/virtual-marker-two-points-ratio.hh>
 
+#include "virtual-marker-math.hh"
+
 namespace libmocap
 {
   VirtualMarkerTwoPointsRatio::VirtualMarkerTwoPointsRatio
@@ -44,7 +46,7 @@ namespace libmocap
 
   VirtualMarkerTwoPointsRatio::VirtualMarkerTwoPointsRatio
   (const VirtualMarkerTwoPointsRatio& rhs)
-    : AbstractVirtualMarker (),
+    : AbstractVirtualMarker (rhs),
       weight_ (rhs.weight_)
   {}
 
@@ -85,7 +87,7 @@ namespace libmocap
 
     if (frameId < 0)
       throw std::runtime_error ("negative frame id");
-    if (frameId >= static_cast<int> (trajectory.positions ().size ()))
+    if (frameId >= static_cast<int> (trajectory.numRows ()))
       throw std::runtime_error ("frame id is too large");
     if (originMarker () < 0)
       throw std::runtime_error ("negative origin marker");
@@ -106,8 +108,7 @@ namespace libmocap
     markerSet.markers ()[longAxisMarker_]->position
       (marker2, markerSet, trajectory, frameId);
 
-    for (std::size_t i = 0; i < 3; ++i)
-      position[i] = marker1[i] + weight_ * (marker2[i] - marker1[i]);
+    twoPointsRatio (position, marker1, marker2, weight_);
   }
 
   std::ostream&
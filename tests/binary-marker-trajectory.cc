@@ -0,0 +1,143 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <libmocap/binary-marker-trajectory-reader.hh>
+#include <libmocap/binary-marker-trajectory-writer.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+
+static void checkMetadata (const libmocap::MarkerTrajectory& reference,
+			   const libmocap::MarkerTrajectory& trajectory)
+{
+  if (reference.filename () != trajectory.filename ()
+      || reference.dataRate () != trajectory.dataRate ()
+      || reference.cameraRate () != trajectory.cameraRate ()
+      || reference.numFrames () != trajectory.numFrames ()
+      || reference.numMarkers () != trajectory.numMarkers ()
+      || reference.units () != trajectory.units ()
+      || reference.origDataRate () != trajectory.origDataRate ()
+      || reference.origDataStartFrame () != trajectory.origDataStartFrame ()
+      || reference.origNumFrames () != trajectory.origNumFrames ()
+      || reference.markers () != trajectory.markers ())
+    throw std::runtime_error ("metadata mismatch");
+}
+
+// Copy a binary trajectory, overwriting one of its 32-bit header
+// fields, and check that the copy is rejected.
+static void checkCorrupted (const std::string& filename,
+			    std::size_t offset, uint32_t value)
+{
+  std::ifstream input (filename.c_str (), std::ios::binary);
+  std::string data ((std::istreambuf_iterator<char> (input)),
+		    std::istreambuf_iterator<char> ());
+  for (std::size_t i = 0; i < 4; ++i)
+    data[offset + i] = static_cast<char> ((value >> (8 * i)) & 0xff);
+
+  const char* corrupted = "corrupted.btrc";
+  {
+    std::ofstream output (corrupted, std::ios::binary);
+    output.write (data.data (), static_cast<std::streamsize> (data.size ()));
+  }
+
+  bool rejected = false;
+  try
+    {
+      libmocap::BinaryMarkerTrajectoryReader reader (corrupted);
+    }
+  catch (const std::runtime_error&)
+    {
+      rejected = true;
+    }
+  std::remove (corrupted);
+  if (!rejected)
+    throw std::runtime_error ("corrupted header accepted");
+}
+
+int main ()
+{
+  libmocap::MarkerTrajectoryFactory factory;
+  libmocap::BinaryMarkerTrajectoryWriter writer;
+
+  std::string humanTrc = LIBMOCAP_DATA_PATH "human.trc";
+  try
+    {
+      libmocap::MarkerTrajectory reference = factory.load (humanTrc);
+      const libmocap::PositionMatrix& positions = reference.positions ();
+      std::size_t size = positions.numRows () * positions.numCols ();
+
+      // Double precision: the conversion is lossless.
+      writer.write ("human.btrc", reference);
+      libmocap::MarkerTrajectory trajectory = factory.load ("human.btrc");
+      checkMetadata (reference, trajectory);
+      if (std::memcmp (positions.data (), trajectory.positions ().data (),
+		       size * sizeof (double)))
+	throw std::runtime_error ("positions mismatch");
+
+      // Random access to frames.
+      libmocap::BinaryMarkerTrajectoryReader reader ("human.btrc");
+      std::vector<double> row (reader.numColumns ());
+      std::size_t frame = reader.numFrames () / 2;
+      reader.readFrame (frame, &row[0]);
+      if (std::memcmp (&row[0], positions.row (frame).data (),
+		       row.size () * sizeof (double)))
+	throw std::runtime_error ("frame mismatch");
+      if (reader.frameData (frame)
+	  && std::memcmp (reader.frameData (frame),
+			  positions.row (frame).data (),
+			  row.size () * sizeof (double)))
+	throw std::runtime_error ("mapped frame mismatch");
+
+      // Frame range, the frame numbering is kept when the range is
+      // written back.
+      libmocap::MarkerTrajectoryLoadOptions options;
+      options.firstFrame () = 1000;
+      options.numFrames () = 10;
+      trajectory = factory.load ("human.btrc", options);
+      writer.write ("human-range.btrc", trajectory);
+      trajectory = factory.load ("human-range.btrc");
+      if (trajectory.firstFrame () != 1000
+	  || trajectory.numFrames () != 10
+	  || std::memcmp (trajectory.positions ().data (),
+			  positions.row (1000).data (),
+			  10 * positions.numCols () * sizeof (double)))
+	throw std::runtime_error ("frame range mismatch");
+
+      // Single precision.
+      writer.write ("human-float.btrc", reference,
+		    libmocap::BinaryMarkerTrajectoryWriter::SINGLE_PRECISION);
+      trajectory = factory.load ("human-float.btrc");
+      checkMetadata (reference, trajectory);
+      for (std::size_t i = 0; i < size; ++i)
+	{
+	  double expected = positions.data ()[i];
+	  double value = trajectory.positions ().data ()[i];
+	  if (expected != expected)
+	    {
+	      if (value == value)
+		throw std::runtime_error ("missing sample lost");
+	    }
+	  else if (value != static_cast<float> (expected))
+	    throw std::runtime_error ("single precision positions mismatch");
+	}
+
+      // Corrupted headers: the number of frames and of markers sit
+      // after the magic, the version, the precision and the payload
+      // offset.
+      checkCorrupted ("human.btrc", 20, 0x7fffffff);
+      checkCorrupted ("human.btrc", 24,
+		      static_cast<uint32_t> (reference.numMarkers ()) + 1);
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "binary trajectories are consistent" << std::endl;
+  return 0;
+}
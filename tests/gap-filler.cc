@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <libmocap/gap-filler.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-columns.hh>
+
+namespace
+{
+  const std::size_t numFrames = 20;
+
+  // Marker 0 moves along a line, marker 1 along a parabola.
+  double expected (std::size_t marker, std::size_t axis, std::size_t frame)
+  {
+    const double t = static_cast<double> (frame);
+    const double s = static_cast<double> (axis + 1);
+    return marker == 0 ? s * t - 1. : s * t * t / 10.;
+  }
+
+  libmocap::MarkerTrajectory makeTrajectory ()
+  {
+    libmocap::MarkerTrajectory trajectory;
+    trajectory.numFrames () = static_cast<int> (numFrames);
+    trajectory.numMarkers () = 2;
+    trajectory.dataRate () = 100.;
+    trajectory.markers ().push_back ("line");
+    trajectory.markers ().push_back ("parabola");
+    trajectory.positions ().resize (numFrames, 7);
+    for (std::size_t frame = 0; frame < numFrames; ++frame)
+      {
+	trajectory.positions ()(frame, 0) = static_cast<double> (frame) / 100.;
+	for (std::size_t marker = 0; marker < 2; ++marker)
+	  for (std::size_t axis = 0; axis < 3; ++axis)
+	    trajectory.positions ()(frame, 1 + 3 * marker + axis) =
+	      expected (marker, axis, frame);
+      }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN ();
+    // Marker 0: leading gap, short gap, long gap.
+    const std::size_t missing0[] = {0, 1, 5, 6, 7, 12, 13, 14, 15, 16, 17};
+    for (std::size_t i = 0; i < sizeof (missing0) / sizeof (std::size_t); ++i)
+      trajectory.positions ()(missing0[i], 1) = nan;
+    // Marker 1: a single missing coordinate is enough, trailing gap.
+    const std::size_t missing1[] = {9, 10, 11, 19};
+    for (std::size_t i = 0; i < sizeof (missing1) / sizeof (std::size_t); ++i)
+      trajectory.positions ()(missing1[i], 5) = nan;
+    return trajectory;
+  }
+
+  void check (bool condition, const std::string& message)
+  {
+    if (!condition)
+      throw std::runtime_error (message);
+  }
+
+  // Largest error over the gap of marker 1.
+  double parabolaError (const libmocap::MarkerTrajectory& trajectory)
+  {
+    double error = 0.;
+    for (std::size_t frame = 9; frame <= 11; ++frame)
+      for (std::size_t axis = 0; axis < 3; ++axis)
+	error = std::max
+	  (error, std::fabs (trajectory.positions ()(frame, 4 + axis)
+			     - expected (1, axis, frame)));
+    return error;
+  }
+} // end of anonymous namespace.
+
+int main ()
+{
+  try
+    {
+      libmocap::GapFiller filler;
+      filler.maxGapLength () = 5;
+
+      libmocap::MarkerTrajectory trajectory = makeTrajectory ();
+      std::vector<libmocap::GapFiller::Gap> gaps;
+      libmocap::GapFiller::Statistics statistics =
+	filler.findGaps (gaps, trajectory);
+      std::cout << statistics << std::endl;
+
+      check (gaps.size () == 5, "wrong number of gaps");
+      check (gaps[0].marker == 0 && gaps[0].firstFrame == 0
+	     && gaps[0].length == 2 && !gaps[0].filled, "wrong leading gap");
+      check (gaps[1].firstFrame == 5 && gaps[1].length == 3
+	     && gaps[1].filled, "wrong short gap");
+      check (gaps[2].firstFrame == 12 && gaps[2].length == 6
+	     && !gaps[2].filled, "wrong long gap");
+      check (gaps[3].marker == 1 && gaps[3].firstFrame == 9
+	     && gaps[3].length == 3 && gaps[3].filled, "wrong partial gap");
+      check (gaps[4].firstFrame == 19 && gaps[4].length == 1
+	     && !gaps[4].filled, "wrong trailing gap");
+      check (statistics.numGaps == 5 && statistics.numFilledGaps == 2
+	     && statistics.numMissingSamples == 15
+	     && statistics.numFilledSamples == 6
+	     && statistics.longestGap == 6, "wrong statistics");
+      check (std::isnan (trajectory.positions ()(5, 1)),
+	     "findGaps modified the trajectory");
+
+      // Linear interpolation restores the line exactly.
+      libmocap::MarkerTrajectory linear = trajectory;
+      statistics = filler.fill (linear);
+      check (statistics.numFilledSamples == 6, "wrong filled samples");
+      for (std::size_t frame = 5; frame <= 7; ++frame)
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	  check (std::fabs (linear.positions ()(frame, 1 + axis)
+			    - expected (0, axis, frame)) < 1e-12,
+		 "wrong linear interpolation");
+      check (std::isnan (linear.positions ()(0, 1))
+	     && std::isnan (linear.positions ()(12, 1))
+	     && std::isnan (linear.positions ()(19, 5)),
+	     "unfillable gaps should be left untouched");
+
+      // The cubic spline also restores the line and follows the
+      // parabola more closely.
+      libmocap::MarkerTrajectory cubic = trajectory;
+      filler.interpolation () = libmocap::GapFiller::CUBIC;
+      filler.fill (cubic);
+      for (std::size_t frame = 5; frame <= 7; ++frame)
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	  check (std::fabs (cubic.positions ()(frame, 1 + axis)
+			    - expected (0, axis, frame)) < 1e-12,
+		 "wrong cubic interpolation");
+      check (parabolaError (cubic) < parabolaError (linear),
+	     "cubic interpolation should be more accurate");
+
+      // Without limit, the long gap is filled as well.
+      filler.maxGapLength () = 0;
+      libmocap::MarkerTrajectoryColumns columns (trajectory);
+      statistics = filler.fill (columns, &gaps);
+      check (statistics.numFilledGaps == 3 && gaps.size () == 5
+	     && !std::isnan (columns.x (0)[12]), "long gap not filled");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  return 0;
+}
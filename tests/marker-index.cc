@@ -0,0 +1,62 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <libmocap/abstract-virtual-marker.hh>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+
+int main ()
+{
+  libmocap::MarkerSetFactory markerSetFactory;
+  libmocap::MarkerTrajectoryFactory trajectoryFactory;
+
+  std::string humanMars = LIBMOCAP_DATA_PATH "human.mars";
+  std::string humanTrc = LIBMOCAP_DATA_PATH "human.trc";
+  try
+    {
+      libmocap::MarkerSet markerSet = markerSetFactory.load (humanMars);
+
+      // Every marker is found at its own index.
+      for (std::size_t i = 0; i < markerSet.markers ().size (); ++i)
+	if (markerSet.markerIndex (markerSet.markers ()[i]->name ())
+	    != static_cast<int> (i))
+	  throw std::runtime_error ("wrong marker index");
+
+      // Copies keep the markers names, ids and dependencies.
+      libmocap::MarkerSet copy;
+      copy = markerSet;
+      const libmocap::AbstractVirtualMarker* midHip =
+	dynamic_cast<const libmocap::AbstractVirtualMarker*>
+	(&copy.markerByName ("Mid_Hip"));
+      if (!midHip || midHip->id () != 36
+	  || midHip->originMarker () != 16
+	  || copy.markerIndex ("V_R_Hip") != markerSet.markerIndex ("V_R_Hip"))
+	throw std::runtime_error ("copied virtual marker is inconsistent");
+
+      // Lookups remain correct when the markers are modified.
+      copy.markers ()[0]->name () = "renamed";
+      if (copy.markerIndex ("renamed") != 0)
+	throw std::runtime_error ("stale index not detected");
+      try
+	{
+	  copy.markerIndex ("does not exist");
+	  throw std::logic_error ("missing marker not detected");
+	}
+      catch (const std::runtime_error&)
+	{}
+
+      libmocap::MarkerTrajectory trajectory =
+	trajectoryFactory.load (humanTrc);
+      for (std::size_t i = 0; i < trajectory.markers ().size (); ++i)
+	if (trajectory.markerIndex (trajectory.markers ()[i])
+	    != static_cast<int> (i))
+	  throw std::runtime_error ("wrong trajectory marker index");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "markers are indexed by name" << std::endl;
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <libmocap/marker-position-cache.hh>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+
+int main ()
+{
+  libmocap::MarkerSetFactory markerSetFactory;
+  libmocap::MarkerTrajectoryFactory trajectoryFactory;
+
+  std::string humanMars = LIBMOCAP_DATA_PATH "human.mars";
+  std::string humanTrc = LIBMOCAP_DATA_PATH "human.trc";
+  try
+    {
+      libmocap::MarkerSet markerSet = markerSetFactory.load (humanMars);
+      libmocap::MarkerTrajectory trajectory =
+	trajectoryFactory.load (humanTrc);
+      libmocap::MarkerPositionCache cache (markerSet, trajectory);
+
+      const int frames[] = {0, 0, 10, 3, 3, 10};
+      for (std::size_t f = 0; f < sizeof (frames) / sizeof (int); ++f)
+	for (std::size_t marker = 0; marker < cache.numMarkers (); ++marker)
+	  {
+	    double expected[3];
+	    markerSet.markers ()[marker]->position
+	      (expected, markerSet, trajectory, frames[f]);
+	    if (std::memcmp (expected, cache.position (marker, frames[f]),
+			     sizeof (expected)))
+	      throw std::runtime_error ("cached position mismatch");
+	  }
+
+      // Segments frames are served from the cache as well.
+      libmocap::SegmentFrames segmentFrames (markerSet);
+      const std::size_t size =
+	segmentFrames.numSegments () * libmocap::SegmentFrames::frameSize;
+      std::vector<double> expected (size);
+      segmentFrames.compute (&expected[0], 0, trajectory, 42, 1);
+      if (cache.segmentFrames (42) != cache.segmentFrames (42)
+	  || std::memcmp (&expected[0], cache.segmentFrames (42),
+			  size * sizeof (double)))
+	throw std::runtime_error ("cached segment frames mismatch");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "cached positions are consistent" << std::endl;
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <libmocap/abstract-virtual-marker.hh>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-set-program.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+
+int main ()
+{
+  libmocap::MarkerSetFactory markerSetFactory;
+  libmocap::MarkerTrajectoryFactory trajectoryFactory;
+
+  std::string humanMars = LIBMOCAP_DATA_PATH "human.mars";
+  std::string humanTrc = LIBMOCAP_DATA_PATH "human.trc";
+  try
+    {
+      libmocap::MarkerSet markerSet = markerSetFactory.load (humanMars);
+      libmocap::MarkerTrajectory trajectory =
+	trajectoryFactory.load (humanTrc);
+
+      libmocap::MarkerSetProgram program = markerSet.compile ();
+      std::cout << program << std::endl;
+
+      if (program.numMarkers () != markerSet.markers ().size ()
+	  || program.instructions ().size () != program.numMarkers ())
+	throw std::runtime_error ("each marker must be evaluated once");
+
+      std::vector<double> positions (3 * program.numMarkers ());
+      for (int frame = 0; frame < trajectory.numFrames (); ++frame)
+	{
+	  program.evaluate (&positions[0], trajectory, frame);
+	  for (std::size_t marker = 0;
+	       marker < markerSet.markers ().size (); ++marker)
+	    {
+	      double expected[3];
+	      markerSet.markers ()[marker]->position
+		(expected, markerSet, trajectory, frame);
+	      if (std::memcmp (expected, &positions[3 * marker],
+			       sizeof (expected)))
+		throw std::runtime_error
+		  ("compiled program does not match marker "
+		   + markerSet.markers ()[marker]->name ());
+	    }
+	}
+
+      // Once validated, the unchecked path gives the same results.
+      program.validate (trajectory);
+      std::vector<double> unchecked (positions.size ());
+      for (int frame = 0; frame < trajectory.numFrames (); ++frame)
+	{
+	  program.evaluate (&positions[0], trajectory, frame);
+	  program.evaluateUnchecked (&unchecked[0], trajectory, frame);
+	  if (std::memcmp (&positions[0], &unchecked[0],
+			   positions.size () * sizeof (double)))
+	    throw std::runtime_error ("unchecked evaluation mismatch");
+	}
+
+      // A trajectory with too few markers is rejected up front.
+      libmocap::MarkerTrajectory box =
+	trajectoryFactory.load (LIBMOCAP_DATA_PATH "box.trc");
+      try
+	{
+	  program.validate (box);
+	  throw std::logic_error ("missing markers not detected");
+	}
+      catch (const std::runtime_error&)
+	{}
+
+      // Markers are checked by name: a trajectory storing them in
+      // another order is rejected.
+      libmocap::MarkerTrajectory swapped = trajectory;
+      std::swap (swapped.markers ()[0], swapped.markers ()[1]);
+      try
+	{
+	  program.validate (swapped);
+	  throw std::logic_error ("misplaced markers not detected");
+	}
+      catch (const std::runtime_error& e)
+	{
+	  std::cout << e.what () << std::endl;
+	}
+
+      // Batch evaluation over a frame range.
+      int firstFrame = 3;
+      int numFrames = trajectory.numFrames () - 2 * firstFrame;
+      std::size_t stride = static_cast<std::size_t> (numFrames);
+      std::vector<double> batch (3 * program.numMarkers () * stride);
+      program.evaluate (&batch[0], trajectory, firstFrame, numFrames);
+      for (int frame = 0; frame < numFrames; ++frame)
+	{
+	  program.evaluate (&positions[0], trajectory, firstFrame + frame);
+	  std::size_t k = static_cast<std::size_t> (frame);
+	  for (std::size_t i = 0; i < positions.size (); ++i)
+	    if (std::memcmp (&positions[i], &batch[i * stride + k],
+			     sizeof (double)))
+	      throw std::runtime_error
+		("batch evaluation does not match frame evaluation");
+	}
+
+      // Cyclic dependencies must be rejected.
+      libmocap::MarkerSet cyclic = markerSet;
+      for (std::size_t marker = 0; marker < cyclic.markers ().size (); ++marker)
+	{
+	  libmocap::AbstractVirtualMarker* virtualMarker =
+	    dynamic_cast<libmocap::AbstractVirtualMarker*>
+	    (cyclic.markers ()[marker]);
+	  if (virtualMarker)
+	    {
+	      virtualMarker->originMarker () = static_cast<int> (marker);
+	      break;
+	    }
+	}
+      try
+	{
+	  cyclic.compile ();
+	  throw std::logic_error ("cyclic dependency not detected");
+	}
+      catch (const std::runtime_error&)
+	{}
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "compiled program matches the markers positions" << std::endl;
+  return 0;
+}
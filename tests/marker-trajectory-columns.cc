@@ -0,0 +1,58 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <libmocap/marker-trajectory-columns.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+
+int main ()
+{
+  libmocap::MarkerTrajectoryFactory factory;
+
+  std::string humanTrc = LIBMOCAP_DATA_PATH "human.trc";
+  try
+    {
+      libmocap::MarkerTrajectory trajectory = factory.load (humanTrc);
+      libmocap::MarkerTrajectoryColumns columns (trajectory);
+
+      if (columns.numFrames ()
+	  != static_cast<std::size_t> (trajectory.numFrames ())
+	  || columns.numMarkers ()
+	  != static_cast<std::size_t> (trajectory.numMarkers ()))
+	throw std::runtime_error ("size mismatch");
+
+      for (std::size_t frame = 0; frame < columns.numFrames (); ++frame)
+	{
+	  const double* row = trajectory.positions ().row (frame).data ();
+	  if (std::memcmp (&columns.time ()[frame], &row[0], sizeof (double)))
+	    throw std::runtime_error ("time mismatch");
+	  for (std::size_t marker = 0; marker < columns.numMarkers (); ++marker)
+	    if (std::memcmp (&columns.x (marker)[frame],
+			     &row[1 + 3 * marker], sizeof (double))
+		|| std::memcmp (&columns.y (marker)[frame],
+				&row[1 + 3 * marker + 1], sizeof (double))
+		|| std::memcmp (&columns.z (marker)[frame],
+				&row[1 + 3 * marker + 2], sizeof (double)))
+	      throw std::runtime_error ("marker position mismatch");
+	}
+
+      // Round trip back to the frame-major layout.
+      libmocap::MarkerTrajectory copy;
+      columns.toTrajectory (copy);
+      if (copy.positions ().numRows () != trajectory.positions ().numRows ()
+	  || copy.positions ().numCols () != trajectory.positions ().numCols ()
+	  || std::memcmp (copy.positions ().data (),
+			  trajectory.positions ().data (),
+			  trajectory.positions ().numRows ()
+			  * trajectory.positions ().numCols ()
+			  * sizeof (double)))
+	throw std::runtime_error ("round trip failed");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "columns are consistent with the trajectory" << std::endl;
+  return 0;
+}
@@ -1,8 +1,55 @@
+#include <clocale>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <locale>
 #include <stdexcept>
 #include <libmocap/marker-trajectory-factory.hh>
 
+// Copy a file, replacing the first occurrence of a string.
+static void copyReplacing (const std::string& source,
+			   const std::string& destination,
+			   const std::string& from,
+			   const std::string& to)
+{
+  std::ifstream input (source.c_str (), std::ios::binary);
+  std::string content ((std::istreambuf_iterator<char> (input)),
+		       std::istreambuf_iterator<char> ());
+  std::string::size_type position = content.find (from);
+  if (position == std::string::npos)
+    throw std::runtime_error ("pattern not found");
+  content.replace (position, from.size (), to);
+  std::ofstream output (destination.c_str (), std::ios::binary);
+  output << content;
+}
+
+// Generated file, removed when going out of scope whatever the test
+// outcome.
+class GeneratedFile
+{
+public:
+  explicit GeneratedFile (const std::string& path)
+    : path_ (path)
+  {}
+
+  ~GeneratedFile ()
+  {
+    std::remove (path_.c_str ());
+  }
+
+  const std::string& path () const
+  {
+    return path_;
+  }
+
+private:
+  GeneratedFile (const GeneratedFile&);
+  GeneratedFile& operator= (const GeneratedFile&);
+
+  std::string path_;
+};
+
 int main ()
 {
   libmocap::MarkerTrajectoryFactory factory;
@@ -15,6 +62,48 @@ int main ()
       std::cout << humanMarkerTrajectory << std::endl;
       libmocap::MarkerTrajectory boxMarkerTrajectory = factory.load (boxMars);
       std::cout << boxMarkerTrajectory << std::endl;
+
+      // Malformed numbers are reported instead of being silently
+      // converted.
+      {
+	GeneratedFile invalid (LIBMOCAP_OUTPUT_PATH "box-invalid.trc");
+	copyReplacing (boxMars, invalid.path (), "99.88021", "99,88021");
+	bool thrown = false;
+	try
+	  {
+	    factory.load (invalid.path ());
+	  }
+	catch (const std::runtime_error& e)
+	  {
+	    std::cout << e.what () << std::endl;
+	    thrown = true;
+	  }
+	if (!thrown)
+	  throw std::runtime_error ("malformed number accepted");
+      }
+
+      // Parsing does not depend on the current locale.
+      const char* locales[] = {"de_DE.UTF-8", "fr_FR.UTF-8", 0};
+      int numLocales = 0;
+      for (const char** name = locales; *name; ++name)
+	{
+	  if (!std::setlocale (LC_ALL, *name))
+	    continue;
+	  ++numLocales;
+	  std::locale::global (std::locale (*name));
+	  libmocap::MarkerTrajectory trajectory = factory.load (boxMars);
+	  std::locale::global (std::locale::classic ());
+	  std::setlocale (LC_ALL, "C");
+	  if (trajectory.positions ()(1, 2)
+	      != boxMarkerTrajectory.positions ()(1, 2)
+	      || trajectory.dataRate () != boxMarkerTrajectory.dataRate ())
+	    throw std::runtime_error ("parsing depends on the locale");
+	  std::cout << "loaded with locale " << *name << std::endl;
+	}
+      if (!numLocales)
+	std::cerr
+	  << "warning: locale check skipped, none of the test locales"
+	  << " is installed" << std::endl;
     }
   catch (const std::exception& e)
     {
@@ -0,0 +1,309 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <libmocap/marker.hh>
+#include <libmocap/marker-position-cache.hh>
+#include <libmocap/marker-set.hh>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-set-program.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+#include <libmocap/segment-frames.hh>
+
+// Two samples are considered identical if they have the same bit
+// pattern or are both NaN.
+static bool sameValue (double lhs, double rhs)
+{
+  if (lhs != lhs && rhs != rhs)
+    return true;
+  return std::memcmp (&lhs, &rhs, sizeof (double)) == 0;
+}
+
+static void checkSameTrajectory (const libmocap::MarkerTrajectory& reference,
+				 const libmocap::MarkerTrajectory& trajectory)
+{
+  if (reference.numFrames () != trajectory.numFrames ()
+      || reference.numMarkers () != trajectory.numMarkers ()
+      || reference.markers () != trajectory.markers ()
+      || reference.positions ().size () != trajectory.positions ().size ())
+    throw std::runtime_error ("trajectory metadata mismatch");
+
+  for (std::size_t frame = 0; frame < reference.positions ().size (); ++frame)
+    {
+      if (reference.positions ()[frame].size ()
+	  != trajectory.positions ()[frame].size ())
+	throw std::runtime_error ("frame size mismatch");
+      for (std::size_t i = 0; i < reference.positions ()[frame].size (); ++i)
+	if (!sameValue (reference.positions ()[frame][i],
+			trajectory.positions ()[frame][i]))
+	  throw std::runtime_error ("trajectory values mismatch");
+    }
+}
+
+// Check that trajectory holds the frames [first, first + count) of
+// reference.
+static void checkWindow (const libmocap::MarkerTrajectory& reference,
+			 const libmocap::MarkerTrajectory& trajectory,
+			 int first, int count)
+{
+  if (trajectory.firstFrame () != first
+      || trajectory.numFrames () != count
+      || trajectory.positions ().size () != static_cast<std::size_t> (count)
+      || trajectory.markers () != reference.markers ())
+    throw std::runtime_error ("frame range mismatch");
+
+  for (std::size_t frame = 0; frame < trajectory.positions ().size ();
+       ++frame)
+    for (std::size_t i = 0; i < reference.positions ().numCols (); ++i)
+      if (!sameValue (reference.positions ()
+		      [frame + static_cast<std::size_t> (first)][i],
+		      trajectory.positions ()[frame][i]))
+	throw std::runtime_error ("frame range values mismatch");
+}
+
+int main ()
+{
+  libmocap::MarkerTrajectoryFactory factory;
+
+  const char* files[] = {
+    LIBMOCAP_DATA_PATH "human.trc",
+    LIBMOCAP_DATA_PATH "box.trc",
+    0
+  };
+
+  try
+    {
+      for (const char** file = files; *file; ++file)
+	{
+	  libmocap::MarkerTrajectory reference = factory.load (*file);
+
+	  libmocap::MarkerTrajectoryLoadOptions options;
+	  options.memoryMapped () = true;
+	  std::cout << options << std::endl;
+	  checkSameTrajectory (reference, factory.load (*file, options));
+
+	  // Parallel parsing, with an explicit number of threads and
+	  // with one thread per core.
+	  options.numThreads () = 3;
+	  std::cout << options << std::endl;
+	  checkSameTrajectory (reference, factory.load (*file, options));
+
+	  options.numThreads () = 0;
+	  checkSameTrajectory (reference, factory.load (*file, options));
+
+	  // Cached loading: the first load fills the cache, the second
+	  // one reads it back.
+	  libmocap::MarkerTrajectoryLoadOptions cacheOptions;
+	  cacheOptions.cache () = true;
+	  cacheOptions.cacheDirectory () = ".";
+	  checkSameTrajectory (reference, factory.load (*file, cacheOptions));
+	  checkSameTrajectory (reference, factory.load (*file, cacheOptions));
+
+	  // Entries built without a content hash are rebuilt when one
+	  // is requested.
+	  cacheOptions.cacheHash () = true;
+	  checkSameTrajectory (reference, factory.load (*file, cacheOptions));
+	  checkSameTrajectory (reference, factory.load (*file, cacheOptions));
+	}
+
+      // Partial loading.
+      const char* file = LIBMOCAP_DATA_PATH "human.trc";
+      libmocap::MarkerTrajectory reference = factory.load (file);
+
+      libmocap::MarkerTrajectoryLoadOptions options;
+      options.firstFrame () = 100;
+      options.numFrames () = 50;
+      std::cout << options << std::endl;
+      checkWindow (reference, factory.load (file, options), 100, 50);
+
+      options.numThreads () = 3;
+      checkWindow (reference, factory.load (file, options), 100, 50);
+
+      // Windows are truncated at the end of the file.
+      options.firstFrame () = 2380;
+      checkWindow (reference, factory.load (file, options), 2380, 7);
+
+      // Time range, the data rate is 200Hz and the first frame is
+      // recorded at t = 0.
+      options = libmocap::MarkerTrajectoryLoadOptions ();
+      options.startTime () = 1.;
+      options.endTime () = 1.5;
+      checkWindow (reference, factory.load (file, options), 200, 101);
+
+      // Frame and time ranges are intersected.
+      options.firstFrame () = 250;
+      checkWindow (reference, factory.load (file, options), 250, 51);
+
+      bool failed = false;
+      options = libmocap::MarkerTrajectoryLoadOptions ();
+      options.firstFrame () = 2387;
+      try
+	{
+	  factory.load (file, options);
+	}
+      catch (const std::runtime_error&)
+	{
+	  failed = true;
+	}
+      if (!failed)
+	throw std::runtime_error ("out of range first frame is accepted");
+
+      // Marker subset, stored in the requested order.
+      const char* names[] = {"LKNEEO", "HEADF", "SCAP", 0};
+      options = libmocap::MarkerTrajectoryLoadOptions ();
+      for (const char** name = names; *name; ++name)
+	options.markers ().push_back (*name);
+      for (int numThreads = 1; numThreads <= 3; numThreads += 2)
+	{
+	  options.numThreads () = numThreads;
+	  std::cout << options << std::endl;
+	  libmocap::MarkerTrajectory subset = factory.load (file, options);
+	  if (subset.markers () != options.markers ()
+	      || subset.numMarkers () != 3
+	      || subset.positions ().numCols () != 10
+	      || subset.positions ().numRows ()
+	      != reference.positions ().numRows ())
+	    throw std::runtime_error ("marker subset mismatch");
+
+	  for (std::size_t frame = 0; frame < subset.positions ().numRows ();
+	       ++frame)
+	    {
+	      const double* row = subset.positions ()[frame].data ();
+	      const double* expected = reference.positions ()[frame].data ();
+	      if (!sameValue (row[0], expected[0]))
+		throw std::runtime_error ("marker subset time mismatch");
+	      for (std::size_t i = 0; i < 3; ++i)
+		{
+		  std::size_t column = static_cast<std::size_t>
+		    (1 + reference.markerIndex (names[i]) * 3);
+		  for (std::size_t axis = 0; axis < 3; ++axis)
+		    if (!sameValue (row[1 + i * 3 + axis],
+				    expected[column + axis]))
+		      throw std::runtime_error ("marker subset values mismatch");
+		}
+	    }
+	}
+
+      failed = false;
+      options.markers ().push_back ("UNKNOWN");
+      try
+	{
+	  factory.load (file, options);
+	}
+      catch (const std::runtime_error&)
+	{
+	  failed = true;
+	}
+      if (!failed)
+	throw std::runtime_error ("unknown marker is accepted");
+
+      // Marker sets are bound to the subset columns by name: every
+      // consumer must give the results of the full load.
+      libmocap::MarkerSetFactory markerSetFactory;
+      libmocap::MarkerSet markerSet =
+	markerSetFactory.load (LIBMOCAP_DATA_PATH "human.mars");
+      options = libmocap::MarkerTrajectoryLoadOptions ();
+      options.markers ().assign (reference.markers ().rbegin (),
+				 reference.markers ().rend ());
+      libmocap::MarkerTrajectory reversed = factory.load (file, options);
+
+      libmocap::MarkerPositionCache referenceCache (markerSet, reference);
+      libmocap::MarkerPositionCache reversedCache (markerSet, reversed);
+      const std::size_t numMarkers = markerSet.markers ().size ();
+      for (int frame = 0; frame < reference.numFrames (); frame += 97)
+	{
+	  for (std::size_t i = 0; i < 3 * numMarkers; ++i)
+	    if (!sameValue (referenceCache.positions (frame)[i],
+			    reversedCache.positions (frame)[i]))
+	      throw std::runtime_error ("subset marker positions mismatch");
+	  for (std::size_t m = 0; m < numMarkers; ++m)
+	    {
+	      double expected[3];
+	      double position[3];
+	      markerSet.markers ()[m]->position
+		(expected, markerSet, reference, frame);
+	      markerSet.markers ()[m]->position
+		(position, markerSet, reversed, frame);
+	      for (std::size_t axis = 0; axis < 3; ++axis)
+		if (!sameValue (expected[axis], position[axis]))
+		  throw std::runtime_error ("subset marker mismatch");
+	    }
+	}
+
+      libmocap::SegmentFrames segmentFrames (markerSet);
+      const std::size_t frameValues = segmentFrames.numSegments ()
+	* libmocap::SegmentFrames::frameSize
+	* static_cast<std::size_t> (reference.numFrames ());
+      std::vector<double> expectedFrames (frameValues);
+      std::vector<double> frames (frameValues);
+      segmentFrames.compute (&expectedFrames[0], 0, reference,
+			     0, reference.numFrames ());
+      segmentFrames.compute (&frames[0], 0, reversed,
+			     0, reference.numFrames ());
+      for (std::size_t i = 0; i < frameValues; ++i)
+	if (!sameValue (expectedFrames[i], frames[i]))
+	  throw std::runtime_error ("subset segment frames mismatch");
+
+      // A two markers subset evaluated with a matching marker set.
+      libmocap::MarkerSet pair;
+      const char* pairNames[] = {"HEADF", "RSHO"};
+      for (std::size_t i = 0; i < 2; ++i)
+	{
+	  libmocap::Marker* marker = new libmocap::Marker ();
+	  marker->name () = pairNames[i];
+	  marker->id () = reference.markerIndex (pairNames[i]);
+	  pair.markers ().push_back (marker);
+	}
+      options.markers ().clear ();
+      options.markers ().push_back ("RSHO");
+      options.markers ().push_back ("HEADF");
+      libmocap::MarkerTrajectory pairTrajectory = factory.load (file, options);
+      libmocap::MarkerPositionCache pairCache (pair, pairTrajectory);
+      for (std::size_t i = 0; i < 3; ++i)
+	if (!sameValue (pairCache.positions (0)[i],
+			referenceCache.position (0, 0)[i])
+	    || !sameValue (pairCache.positions (0)[3 + i],
+			   referenceCache.position
+			   (static_cast<std::size_t>
+			    (reference.markerIndex ("RSHO")), 0)[i]))
+	  throw std::runtime_error ("marker pair mismatch");
+
+      // Markers missing from the subset are reported.
+      failed = false;
+      try
+	{
+	  libmocap::MarkerPositionCache cache (markerSet, pairTrajectory);
+	}
+      catch (const std::runtime_error& e)
+	{
+	  std::cout << e.what () << std::endl;
+	  failed = true;
+	}
+      if (!failed)
+	throw std::runtime_error ("missing subset marker is accepted");
+
+      // A program bound by id detects markers stored in another order.
+      failed = false;
+      try
+	{
+	  libmocap::MarkerSetProgram program (markerSet);
+	  program.validate (reversed);
+	}
+      catch (const std::runtime_error& e)
+	{
+	  std::cout << e.what () << std::endl;
+	  failed = true;
+	}
+      if (!failed)
+	throw std::runtime_error ("misbound marker is accepted");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "all loading modes are consistent" << std::endl;
+  return 0;
+}
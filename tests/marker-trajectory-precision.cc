@@ -0,0 +1,127 @@
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <libmocap/binary-marker-trajectory-writer.hh>
+#include <libmocap/marker-set.hh>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-set-program.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+
+namespace
+{
+  void check (bool condition, const std::string& message)
+  {
+    if (!condition)
+      throw std::runtime_error (message);
+  }
+
+  // Two samples are considered identical if they have the same bit
+  // pattern or are both NaN.
+  bool sameValue (double lhs, double rhs)
+  {
+    if (lhs != lhs && rhs != rhs)
+      return true;
+    return std::memcmp (&lhs, &rhs, sizeof (double)) == 0;
+  }
+
+  // Check that single holds the coordinates of reference rounded to
+  // single precision, and the exact times.
+  void checkRounded (const libmocap::MarkerTrajectory& reference,
+		     const libmocap::MarkerTrajectory& single)
+  {
+    check (single.precision ()
+	   == libmocap::MarkerTrajectory::SINGLE_PRECISION
+	   && single.positions ().empty ()
+	   && single.singlePrecisionData (),
+	   "single precision storage is not used");
+    check (single.numRows () == reference.numRows ()
+	   && single.numCols () == reference.numCols (),
+	   "size mismatch");
+
+    std::vector<double> row (single.numCols ());
+    for (std::size_t frame = 0; frame < single.numRows (); ++frame)
+      {
+	check (sameValue (single.time (frame), reference.time (frame)),
+	       "time mismatch");
+	single.readRow (frame, &row[0]);
+	for (std::size_t i = 1; i < single.numCols (); ++i)
+	  {
+	    double expected =
+	      static_cast<float> (reference.position (frame, i));
+	    check (sameValue (single.position (frame, i), expected)
+		   && sameValue (row[i], expected),
+		   "coordinates mismatch");
+	  }
+      }
+  }
+} // end of anonymous namespace.
+
+int main ()
+{
+  libmocap::MarkerTrajectoryFactory factory;
+  libmocap::MarkerSetFactory markerSetFactory;
+
+  try
+    {
+      std::string file = LIBMOCAP_DATA_PATH "human.trc";
+      libmocap::MarkerTrajectory reference = factory.load (file);
+
+      // Loading, sequential and parallel.
+      libmocap::MarkerTrajectoryLoadOptions options;
+      options.singlePrecision () = true;
+      std::cout << options << std::endl;
+      libmocap::MarkerTrajectory single = factory.load (file, options);
+      checkRounded (reference, single);
+      options.numThreads () = 3;
+      checkRounded (reference, factory.load (file, options));
+
+      // Conversions.
+      libmocap::MarkerTrajectory converted = reference;
+      converted.setPrecision (libmocap::MarkerTrajectory::SINGLE_PRECISION);
+      checkRounded (reference, converted);
+      libmocap::MarkerTrajectory rounded = converted;
+      rounded.setPrecision (libmocap::MarkerTrajectory::DOUBLE_PRECISION);
+      check (!rounded.singlePrecisionData ()
+	     && rounded.positions ().numRows () == reference.numRows (),
+	     "double precision storage is not used");
+      checkRounded (rounded, single);
+
+      // Markers evaluation only depends on the stored values.
+      libmocap::MarkerSet markerSet =
+	markerSetFactory.load (LIBMOCAP_DATA_PATH "human.mars");
+      libmocap::MarkerSetProgram program (markerSet);
+      const int numFrames = static_cast<int> (reference.numRows ());
+      std::vector<double> expected
+	(3 * program.numMarkers () * reference.numRows ());
+      std::vector<double> result (expected.size ());
+      program.evaluate (&expected[0], rounded, 0, numFrames);
+      program.evaluate (&result[0], single, 0, numFrames);
+      for (std::size_t i = 0; i < result.size (); ++i)
+	check (sameValue (result[i], expected[i]), "batch evaluation mismatch");
+
+      std::vector<double> frame (3 * program.numMarkers ());
+      program.evaluate (&frame[0], single, 100);
+      program.evaluate (&expected[0], rounded, 100);
+      for (std::size_t i = 0; i < frame.size (); ++i)
+	check (sameValue (frame[i], expected[i]), "frame evaluation mismatch");
+
+      // Unit conversion.
+      single.normalize ();
+      rounded.normalize ();
+      checkRounded (rounded, single);
+
+      // Binary files.
+      libmocap::BinaryMarkerTrajectoryWriter writer;
+      writer.write ("human-single.btrc", single);
+      checkRounded (rounded, factory.load ("human-single.btrc", options));
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "single precision storage is consistent" << std::endl;
+  return 0;
+}
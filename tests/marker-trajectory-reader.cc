@@ -0,0 +1,193 @@
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <libmocap/marker-trajectory-factory.hh>
+#include <libmocap/marker-trajectory-reader.hh>
+
+int main ()
+{
+  libmocap::MarkerTrajectoryFactory factory;
+
+  std::string humanTrc = LIBMOCAP_DATA_PATH "human.trc";
+  try
+    {
+      libmocap::MarkerTrajectory trajectory = factory.load (humanTrc);
+      const libmocap::PositionMatrix& positions = trajectory.positions ();
+
+      // Frame by frame.
+      {
+	libmocap::MarkerTrajectoryReader reader (humanTrc);
+	if (reader.numColumns () != positions.numCols ()
+	    || reader.metadata ().numMarkers () != trajectory.numMarkers ()
+	    || reader.metadata ().markers () != trajectory.markers ())
+	  throw std::runtime_error ("metadata mismatch");
+
+	std::vector<double> row (reader.numColumns ());
+	std::size_t frame = 0;
+	int frameId;
+	while (reader.readFrame (&row[0], &frameId))
+	  {
+	    if (frame >= positions.numRows ())
+	      throw std::runtime_error ("too many frames");
+	    if (std::memcmp (&row[0], positions.row (frame).data (),
+			     row.size () * sizeof (double)))
+	      throw std::runtime_error ("frame mismatch");
+	    ++frame;
+	  }
+	if (frame != positions.numRows ())
+	  throw std::runtime_error ("too few frames");
+      }
+
+      // By batches whose size does not divide the number of frames.
+      {
+	libmocap::MarkerTrajectoryReader reader (humanTrc);
+	const std::size_t batchSize = 7;
+	std::vector<double> rows (batchSize * reader.numColumns ());
+	std::size_t frame = 0;
+	std::size_t n;
+	while ((n = reader.readFrames (&rows[0], batchSize)) > 0)
+	  {
+	    if (frame + n > positions.numRows ()
+		|| std::memcmp (&rows[0], positions.row (frame).data (),
+				n * reader.numColumns () * sizeof (double)))
+	      throw std::runtime_error ("batch mismatch");
+	    frame += n;
+	  }
+	if (frame != positions.numRows ())
+	  throw std::runtime_error ("too few frames");
+      }
+
+      // Random access, around and on indexed rows. The file is copied
+      // so that the sidecar index is written in the build directory.
+      {
+	std::ifstream source (humanTrc.c_str (), std::ios::binary);
+	std::ofstream copy ("human-index.trc", std::ios::binary);
+	copy << source.rdbuf ();
+      }
+      libmocap::MarkerTrajectoryLoadOptions options;
+      options.frameIndex () = true;
+      for (int pass = 0; pass < 2; ++pass)
+	{
+	  // The first pass builds the sidecar index, the second one
+	  // reads it back.
+	  libmocap::MarkerTrajectoryReader reader ("human-index.trc", options);
+	  const std::size_t frames[] = {1000, 0, 255, 256, 257, 2386, 17};
+	  std::vector<double> row (reader.numColumns ());
+	  int frameId;
+	  for (std::size_t i = 0; i < sizeof (frames) / sizeof (*frames); ++i)
+	    {
+	      reader.seek (frames[i]);
+	      if (!reader.readFrame (&row[0], &frameId)
+		  || frameId != static_cast<int> (frames[i])
+		  || std::memcmp (&row[0], positions.row (frames[i]).data (),
+				  row.size () * sizeof (double)))
+		throw std::runtime_error ("random access mismatch");
+	    }
+
+	  // Ranges, truncated at the end of the file.
+	  std::vector<double> rows (20 * reader.numColumns ());
+	  if (reader.readFrames (300, 20, &rows[0]) != 20
+	      || std::memcmp (&rows[0], positions.row (300).data (),
+			      rows.size () * sizeof (double)))
+	    throw std::runtime_error ("range mismatch");
+	  if (reader.readFrames (2380, 20, &rows[0]) != 7)
+	    throw std::runtime_error ("invalid range size");
+
+	  reader.seek (positions.numRows ());
+	  if (reader.readFrame (&row[0]))
+	    throw std::runtime_error ("frame read past the end");
+	}
+
+      // Partial loading through the index.
+      options.firstFrame () = 700;
+      options.numFrames () = 30;
+      libmocap::MarkerTrajectory window =
+	factory.load ("human-index.trc", options);
+      if (window.firstFrame () != 700
+	  || window.positions ().numRows () != 30
+	  || std::memcmp (window.positions ().data (),
+			  positions.row (700).data (),
+			  30 * positions.numCols () * sizeof (double)))
+	throw std::runtime_error ("indexed partial load mismatch");
+
+      // An edit preserving the file size and modification time
+      // moves the rows: the stale index must be detected. A trailing
+      // zero is removed from the first row and an empty row appended.
+      {
+	struct stat status;
+	if (::stat ("human-index.trc", &status) < 0)
+	  throw std::runtime_error ("cannot stat indexed file");
+	std::string content;
+	{
+	  std::ifstream input ("human-index.trc", std::ios::binary);
+	  content.assign ((std::istreambuf_iterator<char> (input)),
+			  std::istreambuf_iterator<char> ());
+	}
+	content.erase (content.find ("\t46.83710\t") + 8, 1);
+	content += "\n";
+	{
+	  std::ofstream output ("human-index.trc", std::ios::binary);
+	  output << content;
+	}
+	struct timespec times[2] = {status.st_atim, status.st_mtim};
+	if (::utimensat (AT_FDCWD, "human-index.trc", times, 0) < 0)
+	  throw std::runtime_error ("cannot restore modification time");
+      }
+      libmocap::MarkerTrajectoryReader reader ("human-index.trc", options);
+      std::vector<double> row (reader.numColumns ());
+      int frameId;
+      reader.seek (1024);
+      if (!reader.readFrame (&row[0], &frameId)
+	  || frameId != 1024
+	  || std::memcmp (&row[0], positions.row (1024).data (),
+			  row.size () * sizeof (double)))
+	throw std::runtime_error ("stale frame index used");
+
+      // A sidecar index built with another stride is rebuilt.
+      options.frameIndexStride () = 100;
+      {
+	libmocap::MarkerTrajectoryReader reader
+	  ("human-index.trc", options);
+	const std::size_t frames[] = {1000, 199, 200, 2386};
+	std::vector<double> row (reader.numColumns ());
+	int frameId;
+	for (std::size_t i = 0; i < sizeof (frames) / sizeof (*frames); ++i)
+	  {
+	    reader.seek (frames[i]);
+	    if (!reader.readFrame (&row[0], &frameId)
+		|| frameId != static_cast<int> (frames[i])
+		|| std::memcmp (&row[0], positions.row (frames[i]).data (),
+				row.size () * sizeof (double)))
+	      throw std::runtime_error ("strided random access mismatch");
+	  }
+      }
+      {
+	// The stride is stored at offset 32, in little-endian order.
+	std::ifstream index ("human-index.trc.index", std::ios::binary);
+	unsigned char bytes[40];
+	if (!index.read (reinterpret_cast<char*> (bytes), sizeof (bytes)))
+	  throw std::runtime_error ("cannot read frame index");
+	uint64_t stride = 0;
+	for (std::size_t i = 0; i < 8; ++i)
+	  stride |= static_cast<uint64_t> (bytes[32 + i]) << (8 * i);
+	if (stride != 100)
+	  throw std::runtime_error ("frame index not rebuilt with new stride");
+      }
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "streamed frames match the loaded trajectory" << std::endl;
+  return 0;
+}
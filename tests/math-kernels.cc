@@ -0,0 +1,95 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+#include <libmocap/segment-frames.hh>
+
+// The math kernels implementation is selected once per process, so
+// each variant is run in a child process (this same program, given
+// an output file) and its segment frames compared to the scalar ones.
+
+namespace
+{
+  // Write the segments frames of the human capture to a file.
+  void writeFrames (const char* filename)
+  {
+    libmocap::MarkerSetFactory markerSetFactory;
+    libmocap::MarkerTrajectoryFactory trajectoryFactory;
+    libmocap::MarkerSet markerSet =
+      markerSetFactory.load (LIBMOCAP_DATA_PATH "human.mars");
+    libmocap::MarkerTrajectory trajectory =
+      trajectoryFactory.load (LIBMOCAP_DATA_PATH "human.trc");
+
+    libmocap::SegmentFrames segmentFrames (markerSet);
+    const int numFrames = trajectory.numFrames ();
+    std::vector<double> frames
+      (static_cast<std::size_t> (numFrames) * segmentFrames.numSegments ()
+       * libmocap::SegmentFrames::frameSize);
+    std::vector<unsigned char> valid
+      (static_cast<std::size_t> (numFrames) * segmentFrames.numSegments ());
+    segmentFrames.compute (&frames[0], &valid[0], trajectory, 0, numFrames);
+
+    std::ofstream output (filename, std::ios::binary);
+    output.write (reinterpret_cast<const char*> (&frames[0]),
+		  static_cast<std::streamsize>
+		  (frames.size () * sizeof (double)));
+    output.write (reinterpret_cast<const char*> (&valid[0]),
+		  static_cast<std::streamsize> (valid.size ()));
+  }
+
+  // Run this program with the given LIBMOCAP_SIMD value, null to
+  // let the library pick the best implementation.
+  std::string runVariant (const std::string& program, const char* simd)
+  {
+    if (simd)
+      setenv ("LIBMOCAP_SIMD", simd, 1);
+    else
+      unsetenv ("LIBMOCAP_SIMD");
+
+    std::string output =
+      std::string ("math-kernels-") + (simd ? simd : "default") + ".bin";
+    std::string command = "'" + program + "' " + output;
+    if (std::system (command.c_str ()) != 0)
+      throw std::runtime_error ("variant failed: " + command);
+
+    std::ifstream input (output.c_str (), std::ios::binary);
+    std::string content ((std::istreambuf_iterator<char> (input)),
+			 std::istreambuf_iterator<char> ());
+    std::remove (output.c_str ());
+    if (content.empty ())
+      throw std::runtime_error ("variant produced no output: " + command);
+    return content;
+  }
+} // end of anonymous namespace.
+
+int main (int argc, char** argv)
+{
+  try
+    {
+      if (argc > 1)
+	{
+	  writeFrames (argv[1]);
+	  return 0;
+	}
+
+      // The default variant is AVX2 when the CPU supports it.
+      const std::string reference = runVariant (argv[0], "scalar");
+      if (runVariant (argv[0], "sse2") != reference)
+	throw std::runtime_error ("sse2 kernels differ from scalar ones");
+      if (runVariant (argv[0], 0) != reference)
+	throw std::runtime_error ("default kernels differ from scalar ones");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "math kernels match the scalar implementation" << std::endl;
+  return 0;
+}
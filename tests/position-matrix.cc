@@ -0,0 +1,125 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <stdint.h>
+#include <libmocap/position-matrix.hh>
+
+namespace
+{
+  void check (bool condition, const std::string& message)
+  {
+    if (!condition)
+      throw std::runtime_error (message);
+  }
+
+  double value (std::size_t row, std::size_t col)
+  {
+    return static_cast<double> (1000 * row + col);
+  }
+
+  libmocap::PositionMatrix makeMatrix (std::size_t numRows,
+				       std::size_t numCols)
+  {
+    libmocap::PositionMatrix matrix (numRows, numCols);
+    for (std::size_t row = 0; row < numRows; ++row)
+      for (std::size_t col = 0; col < numCols; ++col)
+	matrix (row, col) = value (row, col);
+    return matrix;
+  }
+
+  bool isAligned (const double* data)
+  {
+    return reinterpret_cast<uintptr_t> (data)
+      % libmocap::PositionMatrix::alignment == 0;
+  }
+
+  // Transposition works on 32x32 tiles: check sizes smaller than a
+  // tile, multiple of the tile size and with partial tiles.
+  void checkTranspose (std::size_t numRows, std::size_t numCols)
+  {
+    libmocap::PositionMatrix matrix = makeMatrix (numRows, numCols);
+    libmocap::PositionMatrix result;
+    matrix.transpose (result);
+    check (result.numRows () == numCols && result.numCols () == numRows,
+	   "wrong transpose size");
+    for (std::size_t row = 0; row < numRows; ++row)
+      for (std::size_t col = 0; col < numCols; ++col)
+	check (result (col, row) == value (row, col), "wrong transpose");
+
+    // Transposing back gives the original matrix, reusing the
+    // already allocated result.
+    libmocap::PositionMatrix back = makeMatrix (numRows, numCols);
+    result.transpose (back);
+    for (std::size_t row = 0; row < numRows; ++row)
+      for (std::size_t col = 0; col < numCols; ++col)
+	check (back (row, col) == value (row, col), "wrong transpose back");
+  }
+} // end of anonymous namespace.
+
+int main ()
+{
+  try
+    {
+      checkTranspose (1, 1);
+      checkTranspose (3, 7);
+      checkTranspose (32, 32);
+      checkTranspose (64, 1);
+      checkTranspose (33, 97);
+      checkTranspose (100, 31);
+      checkTranspose (0, 5);
+
+      // Resize to and from zero elements.
+      libmocap::PositionMatrix matrix;
+      check (matrix.empty () && !matrix.data (), "default matrix not empty");
+      matrix.resize (0, 4);
+      check (matrix.numRows () == 0 && matrix.numCols () == 4
+	     && !matrix.data (), "wrong empty resize");
+      matrix.resize (5, 3);
+      check (matrix.numRows () == 5 && matrix.numCols () == 3
+	     && matrix.data (), "wrong resize");
+      for (std::size_t row = 0; row < 5; ++row)
+	for (std::size_t col = 0; col < 3; ++col)
+	  check (matrix (row, col) == 0., "resized matrix not zeroed");
+      matrix.resize (0, 0);
+      check (matrix.empty () && !matrix.data (), "wrong resize to zero");
+      libmocap::PositionMatrix copy (matrix);
+      check (copy.empty () && !copy.data (), "wrong empty copy");
+
+      // The buffer is aligned for any size.
+      for (std::size_t numCols = 1; numCols < 20; ++numCols)
+	{
+	  matrix.resize (3, numCols);
+	  check (isAligned (matrix.data ()), "unaligned buffer");
+	  copy = matrix;
+	  check (isAligned (copy.data ()), "unaligned copy");
+	}
+
+      // Strided views on rows and columns.
+      matrix = makeMatrix (6, 4);
+      libmocap::PositionMatrix::View column = matrix.column (2);
+      check (column.size () == 6 && column.stride () == 4,
+	     "wrong column view");
+      for (std::size_t row = 0; row < 6; ++row)
+	check (column[row] == value (row, 2), "wrong column element");
+      column[3] = -1.;
+      check (matrix (3, 2) == -1., "column view does not alias matrix");
+
+      libmocap::PositionMatrix::View row = matrix[4];
+      check (row.size () == 4 && row.stride () == 1, "wrong row view");
+      for (std::size_t col = 0; col < 4; ++col)
+	check (row[col] == value (4, col), "wrong row element");
+
+      const libmocap::PositionMatrix& constMatrix = matrix;
+      libmocap::PositionMatrix::ConstView constColumn =
+	constMatrix.column (3);
+      check (constColumn.data () == matrix.data () + 3
+	     && constColumn[5] == value (5, 3), "wrong const column view");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "position matrix is consistent" << std::endl;
+  return 0;
+}
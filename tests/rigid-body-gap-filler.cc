@@ -0,0 +1,200 @@
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <libmocap/link.hh>
+#include <libmocap/marker.hh>
+#include <libmocap/marker-set.hh>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+#include <libmocap/rigid-body-gap-filler.hh>
+#include <libmocap/segment.hh>
+
+namespace
+{
+  const std::size_t numFrames = 50;
+  const std::size_t numMarkers = 5;
+
+  void check (bool condition, const std::string& message)
+  {
+    if (!condition)
+      throw std::runtime_error (message);
+  }
+
+  // Markers 0 to 3 are linked together, marker 4 only to marker 0.
+  libmocap::MarkerSet makeMarkerSet ()
+  {
+    libmocap::MarkerSet markerSet;
+    for (std::size_t i = 0; i < numMarkers; ++i)
+      {
+	libmocap::Marker* marker = new libmocap::Marker ();
+	marker->id () = static_cast<int> (i);
+	marker->name () = std::string (1, static_cast<char> ('A' + i));
+	markerSet.markers ().push_back (marker);
+      }
+    for (int i = 0; i < 4; ++i)
+      for (int j = i + 1; j < 4; ++j)
+	{
+	  libmocap::Link link;
+	  link.marker1 () = i;
+	  link.marker2 () = j;
+	  markerSet.links ().push_back (link);
+	}
+    libmocap::Link link;
+    link.marker1 () = 4;
+    link.marker2 () = 0;
+    markerSet.links ().push_back (link);
+    return markerSet;
+  }
+
+  // All markers belong to a rigid body rotating around (1, 1, 1)
+  // while translating.
+  void truth (double result[3], std::size_t marker, std::size_t frame)
+  {
+    static const double body[numMarkers][3] =
+      {{0., 0., 0.}, {1., 0., 0.}, {0., 2., 0.}, {0.5, 0.5, 1.},
+       {3., 3., 3.}};
+    const double t = static_cast<double> (frame);
+    const double* p = body[marker];
+    const double angle = 0.05 * t;
+    const double c = std::cos (angle);
+    const double s = std::sin (angle);
+    const double u = 1. / std::sqrt (3.);
+    const double dot = u * (p[0] + p[1] + p[2]);
+    const double cross[3] =
+      {u * (p[2] - p[1]), u * (p[0] - p[2]), u * (p[1] - p[0])};
+    const double translation[3] = {t, 2. * t, 0.5 * t};
+    for (std::size_t axis = 0; axis < 3; ++axis)
+      result[axis] = p[axis] * c + cross[axis] * s
+	+ u * dot * (1. - c) + translation[axis];
+  }
+
+  libmocap::MarkerTrajectory makeTrajectory ()
+  {
+    libmocap::MarkerTrajectory trajectory;
+    trajectory.numFrames () = static_cast<int> (numFrames);
+    trajectory.numMarkers () = static_cast<int> (numMarkers);
+    trajectory.positions ().resize (numFrames, 1 + 3 * numMarkers);
+    for (std::size_t frame = 0; frame < numFrames; ++frame)
+      for (std::size_t marker = 0; marker < numMarkers; ++marker)
+	truth (&trajectory.positions ()(frame, 1 + 3 * marker),
+	       marker, frame);
+    return trajectory;
+  }
+
+  void remove (libmocap::MarkerTrajectory& trajectory,
+	       std::size_t marker, std::size_t frame)
+  {
+    trajectory.positions ()(frame, 2 + 3 * marker) =
+      std::numeric_limits<double>::quiet_NaN ();
+  }
+} // end of anonymous namespace.
+
+int main ()
+{
+  try
+    {
+      libmocap::MarkerSet markerSet = makeMarkerSet ();
+      libmocap::RigidBodyGapFiller filler (markerSet);
+      check (filler.neighbors (0).size () == 4
+	     && filler.neighbors (1).size () == 3
+	     && filler.neighbors (4).size () == 1, "wrong neighbors");
+
+      libmocap::MarkerTrajectory trajectory = makeTrajectory ();
+      for (std::size_t frame = 10; frame < 15; ++frame)
+	remove (trajectory, 0, frame);
+      // Only two neighbors are left visible for these ones.
+      remove (trajectory, 1, 30);
+      remove (trajectory, 2, 30);
+      // Not enough neighbors.
+      remove (trajectory, 4, 5);
+
+      std::size_t filled = filler.fill (trajectory);
+      check (filled == 5, "wrong number of filled samples");
+      for (std::size_t frame = 10; frame < 15; ++frame)
+	{
+	  double expected[3];
+	  truth (expected, 0, frame);
+	  for (std::size_t axis = 0; axis < 3; ++axis)
+	    check (std::fabs (trajectory.positions ()(frame, 1 + axis)
+			      - expected[axis]) < 1e-9,
+		   "wrong reconstruction");
+	}
+      check (std::isnan (trajectory.positions ()(30, 5))
+	     && std::isnan (trajectory.positions ()(30, 8))
+	     && std::isnan (trajectory.positions ()(5, 14)),
+	     "gaps should not have been filled");
+
+      // Markers only defining a segment have two neighbors: they are
+      // left untouched.
+      libmocap::MarkerSet segmentSet;
+      for (std::size_t i = 0; i < 3; ++i)
+	{
+	  libmocap::Marker* marker = new libmocap::Marker ();
+	  marker->id () = static_cast<int> (i);
+	  marker->name () = std::string (1, static_cast<char> ('A' + i));
+	  segmentSet.markers ().push_back (marker);
+	}
+      libmocap::Segment segment;
+      segment.originMarker () = 0;
+      segment.longAxisMarker () = 1;
+      segment.planeAxisMarker () = 2;
+      segmentSet.segments ().push_back (segment);
+      libmocap::RigidBodyGapFiller segmentFiller (segmentSet);
+      check (segmentFiller.neighbors (0).size () == 2,
+	     "wrong segment neighbors");
+
+      trajectory = makeTrajectory ();
+      remove (trajectory, 0, 20);
+      check (segmentFiller.fill (trajectory) == 0
+	     && std::isnan (trajectory.positions ()(20, 2)),
+	     "segment-only marker should not have been filled");
+
+      // Real capture: remove visible samples of the right knee and
+      // check that they are reconstructed closely.
+      libmocap::MarkerSetFactory markerSetFactory;
+      libmocap::MarkerTrajectoryFactory trajectoryFactory;
+      libmocap::MarkerSet human =
+	markerSetFactory.load (LIBMOCAP_DATA_PATH "human.mars");
+      libmocap::MarkerTrajectory capture =
+	trajectoryFactory.load (LIBMOCAP_DATA_PATH "human.trc");
+      libmocap::MarkerTrajectory original = capture;
+
+      const std::size_t knee =
+	static_cast<std::size_t> (capture.markerIndex ("RKNEEO"));
+      for (std::size_t frame = 500; frame < 510; ++frame)
+	{
+	  check (!std::isnan (capture.positions ()(frame, 1 + 3 * knee)),
+		 "unexpected missing sample");
+	  remove (capture, knee, frame);
+	}
+
+      libmocap::RigidBodyGapFiller humanFiller (human);
+      filled = humanFiller.fill (capture);
+      std::cout << filled << " sample(s) filled" << std::endl;
+      check (filled >= 10, "knee gap not filled");
+
+      double error = 0.;
+      for (std::size_t frame = 0; frame < capture.positions ().numRows ();
+	   ++frame)
+	for (std::size_t col = 0; col < capture.positions ().numCols (); ++col)
+	  {
+	    const double before = original.positions ()(frame, col);
+	    const double after = capture.positions ()(frame, col);
+	    if (frame >= 500 && frame < 510 && col >= 1 + 3 * knee
+		&& col < 4 + 3 * knee)
+	      error = std::max (error, std::fabs (after - before));
+	    else if (!std::isnan (before))
+	      check (after == before, "visible sample modified");
+	  }
+      std::cout << "knee reconstruction error: " << error << std::endl;
+      check (error < 20., "knee reconstruction is inaccurate");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  return 0;
+}
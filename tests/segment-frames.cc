@@ -0,0 +1,149 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+#include <libmocap/segment-frames.hh>
+
+int main ()
+{
+  libmocap::MarkerSetFactory markerSetFactory;
+  libmocap::MarkerTrajectoryFactory trajectoryFactory;
+
+  std::string humanMars = LIBMOCAP_DATA_PATH "human.mars";
+  std::string humanTrc = LIBMOCAP_DATA_PATH "human.trc";
+  try
+    {
+      libmocap::MarkerSet markerSet = markerSetFactory.load (humanMars);
+      libmocap::MarkerTrajectory trajectory =
+	trajectoryFactory.load (humanTrc);
+
+      libmocap::SegmentFrames segmentFrames (markerSet);
+      const std::size_t numSegments = segmentFrames.numSegments ();
+      const std::size_t frameSize = libmocap::SegmentFrames::frameSize;
+      if (numSegments != markerSet.segments ().size ())
+	throw std::runtime_error ("wrong number of segments");
+
+      const int numFrames = trajectory.numFrames ();
+      const std::size_t n = static_cast<std::size_t> (numFrames);
+      std::vector<double> frames (n * numSegments * frameSize);
+      std::vector<unsigned char> valid (n * numSegments);
+      segmentFrames.compute
+	(&frames[0], &valid[0], trajectory, 0, numFrames);
+
+      std::size_t numValid = 0;
+      for (std::size_t k = 0; k < n; ++k)
+	for (std::size_t s = 0; s < numSegments; ++s)
+	  {
+	    const double* frame = &frames[(k * numSegments + s) * frameSize];
+	    const libmocap::Segment& segment = markerSet.segments ()[s];
+
+	    double origin[3];
+	    markerSet.markers ()
+	      [static_cast<std::size_t> (segment.originMarker ())]->position
+	      (origin, markerSet, trajectory, static_cast<int> (k));
+
+	    if (!valid[k * numSegments + s])
+	      {
+		if (!std::isnan (frame[0]))
+		  throw std::runtime_error ("invalid frame not flagged");
+		continue;
+	      }
+	    ++numValid;
+
+	    // The rotation must be orthonormal and direct.
+	    for (std::size_t i = 0; i < 3; ++i)
+	      for (std::size_t j = 0; j < 3; ++j)
+		{
+		  double dot = 0.;
+		  for (std::size_t l = 0; l < 3; ++l)
+		    dot += frame[3 * l + i] * frame[3 * l + j];
+		  if (std::fabs (dot - (i == j ? 1. : 0.)) > 1e-9)
+		    throw std::runtime_error ("rotation is not orthonormal");
+		}
+	    double det =
+	      frame[0] * (frame[4] * frame[8] - frame[5] * frame[7])
+	      - frame[1] * (frame[3] * frame[8] - frame[5] * frame[6])
+	      + frame[2] * (frame[3] * frame[7] - frame[4] * frame[6]);
+	    if (std::fabs (det - 1.) > 1e-9)
+	      throw std::runtime_error ("rotation is not direct");
+
+	    if (std::memcmp (origin, frame + 9, sizeof (origin)))
+	      throw std::runtime_error ("translation mismatch");
+	  }
+      if (!numValid)
+	throw std::runtime_error ("no valid segment frame");
+
+      // Computing a sub-range must give the same results.
+      const int firstFrame = 17;
+      const int numSubFrames = numFrames - 2 * firstFrame;
+      std::vector<double> subFrames
+	(static_cast<std::size_t> (numSubFrames) * numSegments * frameSize);
+      segmentFrames.compute
+	(&subFrames[0], 0, trajectory, firstFrame, numSubFrames);
+      if (std::memcmp (&subFrames[0],
+		       &frames[static_cast<std::size_t> (firstFrame)
+			       * numSegments * frameSize],
+		       subFrames.size () * sizeof (double)))
+	throw std::runtime_error ("sub-range mismatch");
+
+      // Coincident markers at frame 0, collinear markers at frame 1:
+      // no frame can be built from them.
+      libmocap::MarkerTrajectory degenerate = trajectory;
+      libmocap::PositionMatrix& positions = degenerate.positions ();
+      for (std::size_t col = 1; col < positions.numCols (); col += 3)
+	for (std::size_t i = 0; i < 3; ++i)
+	  {
+	    positions (0, col + i) = 100. * static_cast<double> (i + 1);
+	    positions (1, col + i) =
+	      static_cast<double> (col * (i + 1));
+	  }
+      segmentFrames.compute (&frames[0], &valid[0], degenerate, 0, 2);
+
+      std::size_t numCollinear = 0;
+      for (std::size_t s = 0; s < numSegments; ++s)
+	{
+	  if (valid[s])
+	    throw std::runtime_error ("coincident markers not flagged");
+
+	  const libmocap::Segment& segment = markerSet.segments ()[s];
+	  const int markers[] = {segment.originMarker (),
+				 segment.longAxisMarker (),
+				 segment.planeAxisMarker ()};
+	  double p[3][3];
+	  for (std::size_t m = 0; m < 3; ++m)
+	    markerSet.markers ()[static_cast<std::size_t> (markers[m])]
+	      ->position (p[m], markerSet, degenerate, 1);
+
+	  // Only segments defined by markers of the line are checked,
+	  // virtual markers may lie elsewhere.
+	  double u[3];
+	  double v[3];
+	  for (std::size_t i = 0; i < 3; ++i)
+	    {
+	      u[i] = p[1][i] - p[0][i];
+	      v[i] = p[2][i] - p[0][i];
+	    }
+	  double c[3] = {u[1] * v[2] - u[2] * v[1],
+			 u[2] * v[0] - u[0] * v[2],
+			 u[0] * v[1] - u[1] * v[0]};
+	  if (!(c[0] * c[0] + c[1] * c[1] + c[2] * c[2] < 1e-9))
+	    continue;
+	  ++numCollinear;
+	  if (valid[numSegments + s])
+	    throw std::runtime_error ("collinear markers not flagged");
+	}
+      if (!numCollinear)
+	throw std::runtime_error ("no collinear segment checked");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "segment frames are consistent" << std::endl;
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+#include <libmocap/skeleton-frames.hh>
+
+int main ()
+{
+  libmocap::MarkerSetFactory markerSetFactory;
+  libmocap::MarkerTrajectoryFactory trajectoryFactory;
+
+  std::string humanMars = LIBMOCAP_DATA_PATH "human.mars";
+  std::string humanTrc = LIBMOCAP_DATA_PATH "human.trc";
+  try
+    {
+      libmocap::MarkerSet markerSet = markerSetFactory.load (humanMars);
+      libmocap::MarkerTrajectory trajectory =
+	trajectoryFactory.load (humanTrc);
+
+      // The hierarchy is loaded and children point to the copy.
+      const std::vector<libmocap::Segment>& segments = markerSet.segments ();
+      if (segments.empty () || segments[0].parent () != -1
+	  || segments[1].parent () != 0)
+	throw std::runtime_error ("segments parents not loaded");
+      for (std::size_t s = 0; s < segments.size (); ++s)
+	for (std::size_t c = 0; c < segments[s].children ().size (); ++c)
+	  {
+	    const libmocap::Segment* child = segments[s].children ()[c];
+	    if (child < &segments[0] || child > &segments.back ()
+		|| child->parent () != static_cast<int> (s))
+	      throw std::runtime_error ("inconsistent segment children");
+	  }
+
+      libmocap::SkeletonFrames skeleton (markerSet);
+      const std::size_t numSegments = skeleton.numSegments ();
+      std::vector<bool> seen (numSegments, false);
+      for (std::size_t i = 0; i < skeleton.order ().size (); ++i)
+	{
+	  std::size_t s = skeleton.order ()[i];
+	  int parent = skeleton.parents ()[s];
+	  if (parent >= 0 && !seen[static_cast<std::size_t> (parent)])
+	    throw std::runtime_error ("child sorted before its parent");
+	  seen[s] = true;
+	}
+
+      const std::size_t frameSize = libmocap::SegmentFrames::frameSize;
+      const std::size_t n = static_cast<std::size_t> (trajectory.numFrames ());
+      std::vector<double> world (n * numSegments * frameSize);
+      std::vector<double> joints (n * numSegments * frameSize);
+      std::vector<unsigned char> valid (n * numSegments);
+      skeleton.compute (&world[0], &joints[0], &valid[0],
+			trajectory, 0, trajectory.numFrames ());
+
+      // The forward chain must give back the world transforms.
+      std::vector<double> chained (world.size ());
+      skeleton.forward (&chained[0], &joints[0], n);
+
+      std::size_t numValid = 0;
+      for (std::size_t k = 0; k < n; ++k)
+	{
+	  // Only check frames where the whole skeleton is valid.
+	  bool allValid = true;
+	  for (std::size_t s = 0; s < numSegments; ++s)
+	    allValid = allValid && valid[k * numSegments + s];
+	  if (!allValid)
+	    continue;
+	  ++numValid;
+
+	  for (std::size_t i = 0; i < numSegments * frameSize; ++i)
+	    {
+	      double expected = world[k * numSegments * frameSize + i];
+	      double actual = chained[k * numSegments * frameSize + i];
+	      if (std::fabs (actual - expected)
+		  > 1e-6 * (1. + std::fabs (expected)))
+		throw std::runtime_error ("forward chain mismatch");
+	    }
+	}
+      if (!numValid)
+	throw std::runtime_error ("no valid skeleton frame");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  std::cout << "skeleton frames are consistent" << std::endl;
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <libmocap/marker-set.hh>
+#include <libmocap/marker-set-factory.hh>
+#include <libmocap/marker-set-program.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+#include <libmocap/trajectory-differentiator.hh>
+
+namespace
+{
+  const std::size_t numFrames = 30;
+  const double step = 0.01;
+
+  void check (bool condition, const std::string& message)
+  {
+    if (!condition)
+      throw std::runtime_error (message);
+  }
+
+  double position (double t)
+  {
+    return 3. * t * t + 2. * t + 1.;
+  }
+
+  double velocity (double t)
+  {
+    return 6. * t + 2.;
+  }
+
+  double time (std::size_t frame)
+  {
+    return 1. + static_cast<double> (frame) * step;
+  }
+} // end of anonymous namespace.
+
+int main ()
+{
+  try
+    {
+      // One marker following a parabola on every axis, with an
+      // isolated sample and a pair of samples surrounded by gaps.
+      libmocap::MarkerTrajectory trajectory;
+      trajectory.dataRate () = 1. / step;
+      trajectory.numFrames () = static_cast<int> (numFrames);
+      trajectory.numMarkers () = 1;
+      trajectory.units () = "mm";
+      trajectory.markers ().push_back ("parabola");
+      trajectory.positions ().resize (numFrames, 4);
+      const double nan = std::numeric_limits<double>::quiet_NaN ();
+      for (std::size_t frame = 0; frame < numFrames; ++frame)
+	{
+	  const double t = time (frame);
+	  const bool missing = frame == 10 || frame == 12
+	    || frame == 13 || frame == 16;
+	  trajectory.positions ()(frame, 0) = t;
+	  for (std::size_t axis = 1; axis < 4; ++axis)
+	    trajectory.positions ()(frame, axis) = missing ? nan : position (t);
+	}
+
+      libmocap::TrajectoryDifferentiator differentiator;
+      libmocap::MarkerTrajectory v;
+      libmocap::MarkerTrajectory a;
+      differentiator.differentiate (&v, &a, trajectory);
+
+      check (v.numFrames () == trajectory.numFrames ()
+	     && v.markers () == trajectory.markers ()
+	     && v.units () == "mm" && v.dataRate () == trajectory.dataRate ()
+	     && a.positions ().numCols () == 4,
+	     "metadata not preserved");
+
+      for (std::size_t frame = 0; frame < numFrames; ++frame)
+	{
+	  const double t = time (frame);
+	  const double vz = v.positions ()(frame, 3);
+	  const double az = a.positions ()(frame, 3);
+	  check (v.positions ()(frame, 0) == t, "wrong time");
+
+	  if (frame == 10 || frame == 11 || frame == 12 || frame == 13
+	      || frame == 16)
+	    {
+	      // Missing or isolated samples.
+	      check (std::isnan (vz) && std::isnan (az),
+		     "derivative of a missing sample");
+	      continue;
+	    }
+	  if (frame == 14 || frame == 15)
+	    {
+	      // Only two valid samples: no acceleration.
+	      check (std::fabs (vz - velocity (t)) <= 3. * step + 1e-9
+		     && std::isnan (az), "wrong derivative in short segment");
+	      continue;
+	    }
+
+	  const bool central = frame != 0 && frame != 9 && frame != 17
+	    && frame != numFrames - 1;
+	  check (std::fabs (vz - velocity (t)) < (central ? 1e-9 : 3. * step
+						  + 1e-9),
+		 "wrong velocity");
+	  check (std::fabs (az - 6.) < 1e-6, "wrong acceleration");
+	}
+
+      // Virtual markers are differentiated as well.
+      libmocap::MarkerSetFactory markerSetFactory;
+      libmocap::MarkerTrajectoryFactory trajectoryFactory;
+      libmocap::MarkerSet markerSet =
+	markerSetFactory.load (LIBMOCAP_DATA_PATH "human.mars");
+      libmocap::MarkerTrajectory human =
+	trajectoryFactory.load (LIBMOCAP_DATA_PATH "human.trc");
+      libmocap::MarkerTrajectory humanVelocity;
+      differentiator.differentiate (&humanVelocity, 0, markerSet, human);
+      check (humanVelocity.markers ().size () == markerSet.markers ().size ()
+	     && humanVelocity.numFrames () == human.numFrames (),
+	     "wrong marker set velocity size");
+
+      libmocap::MarkerSetProgram program (markerSet);
+      std::vector<double> before (3 * program.numMarkers ());
+      std::vector<double> after (3 * program.numMarkers ());
+      const int frame = 100;
+      program.evaluate (&before[0], human, frame - 1);
+      program.evaluate (&after[0], human, frame + 1);
+      const double span = human.positions ()(frame + 1, 0)
+	- human.positions ()(frame - 1, 0);
+      const std::size_t marker =
+	static_cast<std::size_t> (markerSet.markerIndex ("V_R_Knee"));
+      for (std::size_t axis = 0; axis < 3; ++axis)
+	{
+	  const double expected =
+	    (after[3 * marker + axis] - before[3 * marker + axis]) / span;
+	  const double actual = humanVelocity.positions ()
+	    (static_cast<std::size_t> (frame), 1 + 3 * marker + axis);
+	  check (std::fabs (actual - expected)
+		 <= 1e-9 * std::max (1., std::fabs (expected)),
+		 "wrong virtual marker velocity");
+	}
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <libmocap/butterworth-filter.hh>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-columns.hh>
+#include <libmocap/savitzky-golay-filter.hh>
+
+namespace
+{
+  const std::size_t numFrames = 400;
+  const double dataRate = 100.;
+
+  void check (bool condition, const std::string& message)
+  {
+    if (!condition)
+      throw std::runtime_error (message);
+  }
+
+  // Marker 0: 1 Hz sine on X, cubic on Y, constant on Z.
+  // Marker 1: 1 Hz sine plus 40 Hz noise on every axis.
+  double signal (std::size_t col, std::size_t frame)
+  {
+    const double t = static_cast<double> (frame) / dataRate;
+    const double slow = std::sin (2. * M_PI * t);
+    switch (col)
+      {
+      case 1:
+	return slow;
+      case 2:
+	return 2. * t * t * t - t * t + 0.5;
+      case 3:
+	return 3.;
+      default:
+	return slow + 0.2 * std::sin (2. * M_PI * 40. * t);
+      }
+  }
+
+  libmocap::MarkerTrajectory makeTrajectory ()
+  {
+    libmocap::MarkerTrajectory trajectory;
+    trajectory.dataRate () = dataRate;
+    trajectory.numFrames () = static_cast<int> (numFrames);
+    trajectory.numMarkers () = 2;
+    trajectory.positions ().resize (numFrames, 7);
+    for (std::size_t frame = 0; frame < numFrames; ++frame)
+      {
+	trajectory.positions ()(frame, 0) =
+	  static_cast<double> (frame) / dataRate;
+	for (std::size_t col = 1; col < 7; ++col)
+	  trajectory.positions ()(frame, col) = signal (col, frame);
+      }
+    return trajectory;
+  }
+
+  double maxError (const libmocap::MarkerTrajectory& trajectory,
+		   std::size_t col, std::size_t first, std::size_t last)
+  {
+    double error = 0.;
+    for (std::size_t frame = first; frame < last; ++frame)
+      error = std::max (error, std::fabs (trajectory.positions ()(frame, col)
+					  - signal (col < 4 ? col : 1, frame)));
+    return error;
+  }
+
+  bool same (const libmocap::MarkerTrajectory& lhs,
+	     const libmocap::MarkerTrajectory& rhs)
+  {
+    for (std::size_t frame = 0; frame < numFrames; ++frame)
+      for (std::size_t col = 0; col < 7; ++col)
+	{
+	  const double l = lhs.positions ()(frame, col);
+	  const double r = rhs.positions ()(frame, col);
+	  if (l != r && !(std::isnan (l) && std::isnan (r)))
+	    return false;
+	}
+    return true;
+  }
+} // end of anonymous namespace.
+
+int main ()
+{
+  try
+    {
+      // Savitzky-Golay preserves polynomials up to its order,
+      // including at the ends.
+      libmocap::MarkerTrajectory smoothed = makeTrajectory ();
+      libmocap::SavitzkyGolayFilter savitzkyGolay (11, 3);
+      savitzkyGolay.filter (smoothed);
+      check (maxError (smoothed, 2, 0, numFrames) < 1e-9,
+	     "Savitzky-Golay does not preserve cubics");
+      check (maxError (smoothed, 3, 0, numFrames) < 1e-12,
+	     "Savitzky-Golay does not preserve constants");
+      check (smoothed.positions ()(5, 0) == 0.05, "time column modified");
+
+      // Butterworth keeps the slow component and removes the noise.
+      libmocap::MarkerTrajectory filtered = makeTrajectory ();
+      libmocap::ButterworthFilter butterworth (10., 4);
+      butterworth.filter (filtered);
+      std::cout << "Butterworth errors: "
+		<< maxError (filtered, 1, 20, numFrames - 20) << " (clean), "
+		<< maxError (filtered, 4, 20, numFrames - 20) << " (noisy)"
+		<< std::endl;
+      check (maxError (filtered, 3, 0, numFrames) < 1e-9,
+	     "Butterworth does not preserve constants");
+      check (maxError (filtered, 1, 20, numFrames - 20) < 1e-2,
+	     "Butterworth distorts the signal");
+      check (maxError (filtered, 4, 20, numFrames - 20) < 1e-2,
+	     "Butterworth does not remove noise");
+
+      // Gaps split the signal into independently filtered segments.
+      libmocap::MarkerTrajectory gapped = makeTrajectory ();
+      libmocap::MarkerTrajectory firstHalf = makeTrajectory ();
+      const double nan = std::numeric_limits<double>::quiet_NaN ();
+      for (std::size_t frame = 200; frame < 210; ++frame)
+	gapped.positions ()(frame, 4) = nan;
+      for (std::size_t frame = 200; frame < numFrames; ++frame)
+	firstHalf.positions ()(frame, 4) = nan;
+      butterworth.filter (gapped);
+      butterworth.filter (firstHalf);
+      for (std::size_t frame = 0; frame < numFrames; ++frame)
+	{
+	  const double value = gapped.positions ()(frame, 4);
+	  check (std::isnan (value) == (frame >= 200 && frame < 210),
+		 "gap modified by filtering");
+	  if (frame < 200)
+	    check (value == firstHalf.positions ()(frame, 4),
+		   "segments are not filtered independently");
+	}
+
+      // Results do not depend on the layout or the number of threads.
+      libmocap::MarkerTrajectory sequential = makeTrajectory ();
+      butterworth.numThreads () = 1;
+      butterworth.filter (sequential);
+      check (same (sequential, filtered), "threading changes the results");
+
+      libmocap::MarkerTrajectory fromColumns = makeTrajectory ();
+      libmocap::MarkerTrajectoryColumns columns (fromColumns);
+      butterworth.filter (columns, dataRate);
+      columns.toTrajectory (fromColumns);
+      check (same (fromColumns, filtered), "layout changes the results");
+
+      bool thrown = false;
+      try
+	{
+	  libmocap::ButterworthFilter (60., 2).filter (sequential);
+	}
+      catch (const std::runtime_error& e)
+	{
+	  std::cout << e.what () << std::endl;
+	  thrown = true;
+	}
+      check (thrown, "cutoff above the Nyquist frequency accepted");
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <libmocap/marker-trajectory.hh>
+#include <libmocap/marker-trajectory-factory.hh>
+#include <libmocap/trajectory-resampler.hh>
+
+namespace
+{
+  void check (bool condition, const std::string& message)
+  {
+    if (!condition)
+      throw std::runtime_error (message);
+  }
+
+  // Marker 0 moves along a line, marker 1 along a sine.
+  double signal (std::size_t marker, double t)
+  {
+    return marker == 0 ? 2. * t - 1. : std::sin (2. * M_PI * t);
+  }
+
+  libmocap::MarkerTrajectory makeTrajectory ()
+  {
+    const std::size_t numFrames = 101;
+    libmocap::MarkerTrajectory trajectory;
+    trajectory.dataRate () = 100.;
+    trajectory.cameraRate () = 100.;
+    trajectory.numFrames () = static_cast<int> (numFrames);
+    trajectory.numMarkers () = 2;
+    trajectory.units () = "mm";
+    trajectory.markers ().push_back ("line");
+    trajectory.markers ().push_back ("sine");
+    trajectory.positions ().resize (numFrames, 7);
+    for (std::size_t frame = 0; frame < numFrames; ++frame)
+      {
+	const double t = static_cast<double> (frame) / 100.;
+	trajectory.positions ()(frame, 0) = t;
+	for (std::size_t col = 1; col < 7; ++col)
+	  trajectory.positions ()(frame, col) = signal ((col - 1) / 3, t);
+      }
+    return trajectory;
+  }
+
+  double maxError (const libmocap::MarkerTrajectory& trajectory,
+		   std::size_t marker)
+  {
+    double error = 0.;
+    for (std::size_t frame = 0; frame < trajectory.positions ().numRows ();
+	 ++frame)
+      {
+	const double t = trajectory.positions ()(frame, 0);
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	  error = std::max
+	    (error, std::fabs (trajectory.positions ()(frame, 1 + 3 * marker
+						       + axis)
+			       - signal (marker, t)));
+      }
+    return error;
+  }
+} // end of anonymous namespace.
+
+int main ()
+{
+  try
+    {
+      libmocap::MarkerTrajectory trajectory = makeTrajectory ();
+
+      libmocap::TrajectoryResampler linear;
+      libmocap::MarkerTrajectory upsampled =
+	linear.resample (trajectory, 240.);
+      check (upsampled.numFrames () == 241
+	     && upsampled.positions ().numRows () == 241
+	     && upsampled.dataRate () == 240.
+	     && upsampled.cameraRate () == 100.
+	     && upsampled.markers () == trajectory.markers ()
+	     && upsampled.units () == "mm", "wrong metadata");
+      for (std::size_t frame = 0; frame < 241; ++frame)
+	check (std::fabs (upsampled.positions ()(frame, 0)
+			  - static_cast<double> (frame) / 240.) < 1e-12,
+	       "wrong time column");
+      check (maxError (upsampled, 0) < 1e-12, "wrong linear interpolation");
+
+      libmocap::TrajectoryResampler cubic
+	(libmocap::TrajectoryResampler::CUBIC);
+      libmocap::MarkerTrajectory smooth = cubic.resample (trajectory, 240.);
+      std::cout << "sine error: " << maxError (upsampled, 1) << " (linear), "
+		<< maxError (smooth, 1) << " (cubic)" << std::endl;
+      check (maxError (smooth, 0) < 1e-12, "cubic does not preserve lines");
+      check (maxError (smooth, 1) < maxError (upsampled, 1) / 2.,
+	     "cubic interpolation is not more accurate");
+
+      // Missing samples only affect the frames around them.
+      trajectory.positions ()(50, 4) =
+	std::numeric_limits<double>::quiet_NaN ();
+      cubic.numThreads () = 1;
+      libmocap::MarkerTrajectory gapped = cubic.resample (trajectory, 240.);
+      for (std::size_t frame = 0; frame < 241; ++frame)
+	{
+	  const double t = gapped.positions ()(frame, 0);
+	  const bool near = t > 0.49 + 1e-9 && t < 0.51 - 1e-9;
+	  check (std::isnan (gapped.positions ()(frame, 4)) == near
+		 && !std::isnan (gapped.positions ()(frame, 1)),
+		 "wrong gap resampling");
+	}
+
+      // Downsampling a real capture keeps the shared frames.
+      libmocap::MarkerTrajectoryFactory factory;
+      libmocap::MarkerTrajectory human =
+	factory.load (LIBMOCAP_DATA_PATH "human.trc");
+      libmocap::MarkerTrajectory downsampled =
+	linear.resample (human, human.dataRate () / 2.);
+      check (downsampled.numFrames () == (human.numFrames () - 1) / 2 + 1,
+	     "wrong number of frames");
+      for (std::size_t frame = 0;
+	   frame < downsampled.positions ().numRows (); ++frame)
+	for (std::size_t col = 1; col < human.positions ().numCols (); ++col)
+	  {
+	    const double expected = human.positions ()(2 * frame, col);
+	    const double actual = downsampled.positions ()(frame, col);
+	    check ((std::isnan (expected) && std::isnan (actual))
+		   || std::fabs (actual - expected)
+		   <= 1e-6 * std::max (1., std::fabs (expected)),
+		   "wrong downsampled value");
+	  }
+    }
+  catch (const std::exception& e)
+    {
+      std::cerr << e.what () << std::endl;
+      return 1;
+    }
+  return 0;
+}